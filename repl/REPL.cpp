@@ -10,50 +10,110 @@
 #include <semantics/GlobalScope.h>
 #include <semantics/FunctionOverloadedSymbol.h>
 #include <semantics/FunctionSymbol.h>
+#include <common/StringPool.h>
+#include <map>
 
 using namespace std;
 using namespace Swallow;
 
 
 REPL::REPL(const ConsoleWriterPtr& out)
-:out(out), canQuit(false)
+:parser(&nodeFactory, NULL), out(out), canQuit(false)
 {
     initCommands();
     resultId = 0;
+    //identifiers of the inputs are looked up by their ids in the registry's pool
+    nodeFactory.setStringPool(registry.getStringPool());
 
 }
 
 void REPL::repl()
 {
     wstring line;
+    wstring code;
+    StreamTokenizer tokenizer;
+    int depth = 0;
     int id = 1;
     out->printf(L"Welcome to Swallow! Type :help for assistance.\n");
     program = nodeFactory.createProgram();
     module = ModulePtr(new Module(L"eval", registry.getGlobalScope()->getModuleType()));
     while(!canQuit && !wcin.eof())
     {
-        out->printf(L"%3d> ", id);
+        out->printf(code.empty() ? L"%3d> " : L"%3d. ", id);
         getline(wcin, line);
-        if(line.empty())
-            continue;
-        if(line[0] == ':')
+        if(code.empty())
         {
-            evalCommand(line.substr(1));
-            continue;
+            if(line.empty())
+                continue;
+            if(line[0] == ':')
+            {
+                evalCommand(line.substr(1));
+                continue;
+            }
         }
+        line += L'\n';
+        code += line;
+        //lex the input as soon as a line is read, keep reading while it's unfinished
+        tokenizer.feed(line);
+        if(isIncomplete(tokenizer, depth) && !wcin.eof())
+            continue;
+        //the input's source lives as long as the results reported in it
+        SourceManager sourceManager;
         CompilerResults compilerResults;
-        eval(compilerResults, line);
-        dumpCompilerResults(compilerResults, line);
+        compilerResults.setSourceManager(&sourceManager);
+        eval(sourceManager, compilerResults, code);
+        dumpCompilerResults(compilerResults, code);
+        code.clear();
+        tokenizer.reset();
+        depth = 0;
         id++;
     }
 }
 
-void REPL::eval(CompilerResults& compilerResults, const wstring& line)
+/*!
+ * Check if the input read so far is unfinished, e.g. brackets are not closed or a
+ * multi-line comment is not terminated.
+ */
+bool REPL::isIncomplete(StreamTokenizer& tokenizer, int& depth)
+{
+    Token token;
+    try
+    {
+        while(tokenizer.next(token))
+        {
+            switch(token.type)
+            {
+                case TokenType::OpenParen:
+                case TokenType::OpenBracket:
+                case TokenType::OpenBrace:
+                    depth++;
+                    break;
+                case TokenType::CloseParen:
+                case TokenType::CloseBracket:
+                case TokenType::CloseBrace:
+                    depth--;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    catch(const TokenizerError&)
+    {
+        //let the parser report it
+        return false;
+    }
+    return depth > 0 || tokenizer.hasPendingToken();
+}
+
+void REPL::eval(SourceManager& sourceManager, CompilerResults& compilerResults, const wstring& line)
 {
-    Parser parser(&nodeFactory, &compilerResults);
-    parser.setSourceFile(SourceFilePtr(new SourceFile(L"<eval>", line)));
-    //remove parsed nodes in last eval
+    SourceFilePtr source(new SourceFile(L"<eval>", line));
+    sourceManager.addFile(source);
+    parser.reset(source, &compilerResults);
+    //remove parsed nodes in last eval, their arena is freed when no declaration refers to them
     program->clearStatements();
+    nodeFactory.resetArena();
 
     bool successed = parser.parse(line.c_str(), program);
     if(!successed)
@@ -252,7 +312,11 @@ static void dumpSymbol(const wstring& name, const SymbolPtr& sym, const ConsoleW
 }
 static void dumpSymbols(SymbolScope* scope, const ConsoleWriterPtr& out)
 {
+    //symbols are keyed by id, list them by name
+    map<wstring, SymbolPtr> symbols;
     for(auto entry : scope->getSymbols())
+        symbols.insert(make_pair(scope->getStringPool()->get(entry.first), entry.second));
+    for(auto entry : symbols)
     {
         if(FunctionOverloadedSymbolPtr funcs = dynamic_pointer_cast<FunctionOverloadedSymbol>(entry.second))
         {
@@ -33,10 +33,13 @@
 #include <map>
 #include <memory>
 #include "common/CompilerResults.h"
+#include "common/SourceManager.h"
 #include <semantics/SymbolRegistry.h>
 #include <semantics/ScopedNodeFactory.h>
 #include <semantics/Symbol.h>
 #include <ast/ast-decl.h>
+#include <tokenizer/StreamTokenizer.h>
+#include <parser/Parser.h>
 using std::wstring;
 class REPL;
 typedef std::shared_ptr<class ConsoleWriter> ConsoleWriterPtr;
@@ -50,7 +53,8 @@ public:
     void repl();
 private:
     void evalCommand(const wstring& command);
-    void eval(Swallow::CompilerResults& compilerResults, const wstring& line);
+    bool isIncomplete(Swallow::StreamTokenizer& tokenizer, int& depth);
+    void eval(Swallow::SourceManager& sourceManager, Swallow::CompilerResults& compilerResults, const wstring& line);
     void dumpCompilerResults(Swallow::CompilerResults& compilerResults, const std::wstring& code);
     void dumpProgram();
     void dumpSymbol(const Swallow::SymbolPtr& sym);
@@ -63,6 +67,10 @@ private://commands
 private:
     Swallow::SymbolRegistry registry;
     Swallow::ScopedNodeFactory nodeFactory;
+    /*!
+     * The parser is reset for each input
+     */
+    Swallow::Parser parser;
     Swallow::ProgramPtr program;
     Swallow::ModulePtr module;
     std::map<std::wstring, CommandMethod> methods;
@@ -0,0 +1,126 @@
+/* BenchKeywords.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "tokenizer/Tokenizer.h"
+#include "common/SwallowUtils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace Swallow;
+using namespace std;
+
+/*!
+ * Collect all identifiers from the swift sources of test cases
+ */
+static void collectIdentifiers(const string& file, vector<wstring>& identifiers)
+{
+    wstring code = SwallowUtils::readFile(file.c_str());
+    Tokenizer tokenizer(NULL);
+    tokenizer.setView(code.c_str(), code.size());
+    Token token;
+    try
+    {
+        while(tokenizer.next(token))
+        {
+            if(token.type == TokenType::Identifier)
+                identifiers.push_back(token.token);
+        }
+    }
+    catch(const TokenizerError&)
+    {
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+    vector<wstring> identifiers;
+    collectIdentifiers(SWALLOW_TESTS_DIR "/runtime.swift", identifiers);
+    vector<string> entries = SwallowUtils::readDirectory(SWALLOW_TESTS_DIR "/semantics");
+    for(const string& entry : entries)
+    {
+        if(entry.size() > 6 && entry.compare(entry.size() - 6, 6, ".swift") == 0)
+            collectIdentifiers(SWALLOW_TESTS_DIR "/semantics/" + entry, identifiers);
+    }
+    if(identifiers.empty() || iterations < 1)
+        return 1;
+
+    //the keyword map that each tokenizer used to build in its constructor
+    map<wstring, KeywordInfo> keywords;
+    Tokenizer names(NULL);
+    for(int k = Keyword::_ + 1; k <= Keyword::Module; k++)
+    {
+        const wstring& name = names.getKeyword((Keyword::T)k);
+        if(!name.empty())
+            keywords.insert(make_pair(name, *Tokenizer::findKeyword(name.c_str(), name.size())));
+    }
+
+    long total = (long)identifiers.size() * iterations;
+    int found = 0;
+    chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+    for(int i = 0; i < iterations; i++)
+    {
+        for(const wstring& id : identifiers)
+        {
+            if(keywords.find(id) != keywords.end())
+                found++;
+        }
+    }
+    chrono::duration<double> mapTime = chrono::high_resolution_clock::now() - begin;
+
+    int found2 = 0;
+    begin = chrono::high_resolution_clock::now();
+    for(int i = 0; i < iterations; i++)
+    {
+        for(const wstring& id : identifiers)
+        {
+            if(Tokenizer::findKeyword(id.c_str(), id.size()))
+                found2++;
+        }
+    }
+    chrono::duration<double> tableTime = chrono::high_resolution_clock::now() - begin;
+
+    printf("%ld identifiers classified, %d keywords\n", total, found / iterations);
+    printf("%-16s %12.2f M identifiers/s\n", "std::map", total / mapTime.count() / 1e6);
+    printf("%-16s %12.2f M identifiers/s\n", "keyword table", total / tableTime.count() / 1e6);
+
+    //cost of constructing tokenizers, paid once per parse
+    begin = chrono::high_resolution_clock::now();
+    for(int i = 0; i < iterations * 10; i++)
+    {
+        Tokenizer tokenizer(NULL);
+    }
+    chrono::duration<double, micro> ctorTime = chrono::high_resolution_clock::now() - begin;
+    printf("%-16s %12.3f us\n", "Tokenizer()", ctorTime.count() / (iterations * 10));
+    return found == found2 ? 0 : 1;
+}
@@ -0,0 +1,701 @@
+/* BenchParser.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "parser/Parser.h"
+#include "parser/Parser_Details.h"
+#include "parser/ParserProfile.h"
+#include "tokenizer/Tokenizer.h"
+#include "ast/NodeFactory.h"
+#include "ast/ast.h"
+#include "ast/NodeVisitor.h"
+#include "common/CompilerResults.h"
+#include "common/SwallowUtils.h"
+#include "SwallowCompiler.h"
+#include "semantics/SymbolRegistry.h"
+#include "semantics/OperatorResolver.h"
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace Swallow;
+using namespace std;
+
+/*!
+ * Count the non-comment tokens of given code in a single forward pass,
+ * this is the minimal number of tokens a parser has to lex.
+ */
+static int countTokens(const wstring& code)
+{
+    Tokenizer tokenizer(code.c_str());
+    Token token;
+    int ret = 0;
+    try
+    {
+        while(tokenizer.next(token))
+        {
+            if(token.type != TokenType::Comment)
+                ret++;
+        }
+    }
+    catch(const TokenizerError&)
+    {
+    }
+    return ret;
+}
+
+static void listCorpus(const char* dir, vector<string>& files)
+{
+    vector<string> entries = SwallowUtils::readDirectory(dir);
+    for(const string& entry : entries)
+    {
+        if(entry.size() > 6 && entry.compare(entry.size() - 6, 6, ".swift") == 0)
+            files.push_back(string(dir) + "/" + entry);
+    }
+}
+
+/*!
+ * Generate code of given number of less-than comparisons, half of them are chained by
+ * logical operators and the others are items of an array literal
+ */
+static wstring generateComparisons(int comparisons)
+{
+    wstring ret;
+    wchar_t buf[128];
+    for(int i = 0; i < comparisons / 2; i += 4)
+    {
+        swprintf(buf, sizeof(buf) / sizeof(buf[0]), L"let c%d = a%d < b && c < d%d || e < f && g < h\n", i, i, i);
+        ret += buf;
+    }
+    ret += L"let table = [";
+    for(int i = 0; i < comparisons / 2; i++)
+    {
+        swprintf(buf, sizeof(buf) / sizeof(buf[0]), L"x%d < y, ", i);
+        ret += buf;
+    }
+    ret += L"z < w]\n";
+    return ret;
+}
+
+/*!
+ * Parse chained comparisons of doubling sizes, the time per comparison should stay flat
+ */
+static void benchComparisons(int comparisons, int iterations)
+{
+    printf("%12s %12s %14s %10s %16s\n", "comparisons", "tokens", "generic-scan", "ms/parse", "ns/comparison");
+    for(int n = comparisons; n <= comparisons * 8; n *= 2)
+    {
+        wstring code = generateComparisons(n);
+        int tokens = countTokens(code);
+        ParserStatistics stats = {0, 0, 0, 0};
+        chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+        for(int i = 0; i < iterations; i++)
+        {
+            NodeFactory nodeFactory;
+            CompilerResults compilerResults;
+            Parser parser(&nodeFactory, &compilerResults);
+            parser.parse(code.c_str(), code.size(), nodeFactory.createProgram());
+            stats = parser.getStatistics();
+        }
+        chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - begin;
+        double ms = elapsed.count() / iterations;
+        printf("%12d %12d %14d %10.3f %16.1f\n", n, tokens, stats.genericLookaheadTokens, ms, ms * 1e6 / n);
+    }
+}
+
+/*!
+ * Release an expression tree without recursion, a long operator chain would overflow the stack
+ */
+static void releaseExpression(PatternPtr node)
+{
+    vector<PatternPtr> nodes;
+    vector<BinaryOperatorPtr> stack;
+    while(true)
+    {
+        for(BinaryOperatorPtr op; (op = dynamic_pointer_cast<BinaryOperator>(node)) != nullptr; node = op->getLHS())
+            stack.push_back(op);
+        nodes.push_back(node);
+        if(stack.empty())
+            break;
+        BinaryOperatorPtr op = stack.back();
+        stack.pop_back();
+        nodes.push_back(op);
+        node = op->getRHS();
+        op->setLHS(nullptr);
+        op->setRHS(nullptr);
+    }
+}
+
+/*!
+ * Sort left-leaning chains of alternating + and * of doubling sizes by precedence,
+ * the time per term should stay flat
+ */
+static void benchSortExpression(int terms, int iterations)
+{
+    printf("%12s %12s %16s\n", "terms", "ms/sort", "ns/term");
+    for(int n = terms; n <= terms * 8; n *= 2)
+    {
+        wstring code = L"a";
+        for(int i = 1; i < n; i++)
+            code += (i % 2) ? L" + a" : L" * a";
+        double elapsed = 0;
+        for(int i = 0; i < iterations; i++)
+        {
+            NodeFactory nodeFactory;
+            CompilerResults compilerResults;
+            //parsed without symbol registry, it's a left-leaning chain
+            Parser parser(&nodeFactory, &compilerResults);
+            OperatorPtr expression = dynamic_pointer_cast<Operator>(parser.parseStatement(code.c_str()));
+            if(!expression)
+                return;
+            SymbolRegistry registry;
+            OperatorResolver resolver(&registry, &compilerResults);
+            chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+            expression = resolver.sortExpression(expression);
+            elapsed += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - begin).count();
+            releaseExpression(expression);
+        }
+        double ms = elapsed / iterations;
+        printf("%12d %12.3f %16.1f\n", n, ms, ms * 1e6 / n);
+    }
+}
+
+/*!
+ * Parse copies of the corpus as independent source files using 1 to given number of threads,
+ * only the parse phase of the compiler is measured.
+ * In single file mode all copies are joined into one file that is split into chunks of given size.
+ */
+static void benchParallel(const vector<string>& files, int copies, int threads, int iterations, bool single, size_t splitSize)
+{
+    vector<wstring> sources;
+    long tokens = 0;
+    for(const string& file : files)
+    {
+        sources.push_back(SwallowUtils::readFile(file.c_str()));
+        tokens += countTokens(sources.back());
+    }
+    tokens *= copies;
+    wstring joined;
+    if(single)
+    {
+        for(int c = 0; c < copies; c++)
+        {
+            for(const wstring& source : sources)
+                joined += source + L"\n";
+        }
+    }
+    printf("%8s %8s %12s %12s %10s %10s\n", "threads", "files", "tokens", "ms/parse", "Mtokens/s", "speedup");
+    double base = 0;
+    for(int t = 1; t <= threads; t++)
+    {
+        double total = 0;
+        for(int i = 0; i < iterations; i++)
+        {
+            SwallowCompiler compiler(L"bench");
+            if(single)
+                compiler.addSource(L"joined", joined);
+            for(int c = 0; c < copies && !single; c++)
+            {
+                for(size_t f = 0; f < files.size(); f++)
+                    compiler.addSource(SwallowUtils::toWString(files[f]), sources[f]);
+            }
+            compiler.setParsingThreads(t);
+            compiler.setSplitSize(splitSize);
+            vector<ProgramPtr> programs;
+            chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+            compiler.parse(programs);
+            chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - begin;
+            total += elapsed.count();
+        }
+        double ms = total / iterations;
+        if(t == 1)
+            base = ms;
+        printf("%8d %8d %12ld %12.3f %10.2f %10.2f\n", t, single ? 1 : (int)files.size() * copies, tokens, ms, tokens / ms / 1000, base / ms);
+    }
+}
+
+/*!
+ * Parse given number of REPL-sized inputs, once with a new parser for each input and
+ * once with a single parser that is reset between inputs.
+ */
+static void benchReplInputs(int inputs)
+{
+    static const wchar_t* lines[] = {
+        L"let a = 1 + 2 * 3",
+        L"var s = \"hello \\(a) world\"",
+        L"func twice(x : Int) -> Int { return x * 2 }",
+        L"twice(a) + twice(4)",
+        L"var b = [1, 2, 3, a]",
+        L"b[0] as Int",
+        L"struct Point { var x : Int = 0; var y : Int = 0 }",
+        L"if a > 3 { b.append(a) } else { b.append(0) }"
+    };
+    const int count = sizeof(lines) / sizeof(lines[0]);
+    vector<SourceFilePtr> sources;
+    for(int i = 0; i < count; i++)
+        sources.push_back(SourceFilePtr(new SourceFile(L"<eval>", lines[i])));
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    ProgramPtr program = nodeFactory.createProgram();
+    int freshErrors = 0, reusedErrors = 0;
+
+    chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+    for(int i = 0; i < inputs; i++)
+    {
+        const SourceFilePtr& source = sources[i % count];
+        program->clearStatements();
+        Parser parser(&nodeFactory, &compilerResults);
+        parser.setSourceFile(source);
+        if(!parser.parse(source->code.c_str(), source->code.size(), program))
+            freshErrors++;
+    }
+    chrono::duration<double, micro> fresh = chrono::high_resolution_clock::now() - begin;
+
+    begin = chrono::high_resolution_clock::now();
+    Parser parser(&nodeFactory, &compilerResults);
+    for(int i = 0; i < inputs; i++)
+    {
+        const SourceFilePtr& source = sources[i % count];
+        program->clearStatements();
+        parser.reset(source, &compilerResults);
+        if(!parser.parse(source->code.c_str(), source->code.size(), program))
+            reusedErrors++;
+    }
+    chrono::duration<double, micro> reused = chrono::high_resolution_clock::now() - begin;
+    program->clearStatements();
+
+    printf("%8s %10s %12s %8s\n", "parser", "inputs", "us/input", "errors");
+    printf("%8s %10d %12.3f %8d\n", "fresh", inputs, fresh.count() / inputs, freshErrors);
+    printf("%8s %10d %12.3f %8d\n", "reused", inputs, reused.count() / inputs, reusedErrors);
+    printf("speedup: %.2f\n", fresh.count() / reused.count());
+}
+
+/*!
+ * Bytes of heap in use, or 0 if the C runtime cannot tell
+ */
+static size_t heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+/*!
+ * Parse the corpus with nodes allocated from heap and from node arena, all programs are
+ * kept alive until the parse is finished to measure the memory held by the AST.
+ */
+static void benchArena(const vector<string>& files, int iterations)
+{
+    vector<wstring> sources;
+    for(const string& file : files)
+        sources.push_back(SwallowUtils::readFile(file.c_str()));
+    printf("%8s %8s %12s %12s %14s %10s\n", "alloc", "files", "ms/parse", "ms/release", "KB/heap", "slabs");
+    for(int mode = 0; mode < 2; mode++)
+    {
+        double parseTime = 0, releaseTime = 0;
+        size_t heap = 0, slabs = 0;
+        for(int i = 0; i < iterations; i++)
+        {
+            size_t before = heapInUse();
+            chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+            vector<ProgramPtr> programs;
+            {
+                NodeFactory nodeFactory;
+                if(mode == 0)
+                    nodeFactory.setArena(nullptr);
+                CompilerResults compilerResults;
+                for(size_t f = 0; f < files.size(); f++)
+                {
+                    Parser parser(&nodeFactory, &compilerResults);
+                    parser.setSourceFile(SourceFilePtr(new SourceFile(SwallowUtils::toWString(files[f]), sources[f])));
+                    programs.push_back(nodeFactory.createProgram());
+                    parser.parse(sources[f].c_str(), sources[f].size(), programs.back());
+                }
+                if(nodeFactory.getArena())
+                    slabs = nodeFactory.getArena()->numSlabs();
+            }
+            chrono::high_resolution_clock::time_point parsed = chrono::high_resolution_clock::now();
+            heap = heapInUse() - before;
+            programs.clear();
+            chrono::high_resolution_clock::time_point released = chrono::high_resolution_clock::now();
+            parseTime += chrono::duration<double, milli>(parsed - begin).count();
+            releaseTime += chrono::duration<double, milli>(released - parsed).count();
+        }
+        printf("%8s %8d %12.3f %12.3f %14.1f %10d\n", mode == 0 ? "heap" : "arena", (int)files.size(),
+               parseTime / iterations, releaseTime / iterations, heap / 1024.0, (int)slabs);
+    }
+}
+
+/*!
+ * Generate a collection literal of given number of elements, kind 0-2 for array of
+ * integers, floats and strings, kind 3 for dictionary of integers to strings
+ */
+static wstring generateLiterals(int kind, int elements)
+{
+    wstring ret = L"[";
+    wchar_t buf[64];
+    for(int i = 0; i < elements; i++)
+    {
+        switch(kind)
+        {
+            case 0: swprintf(buf, sizeof(buf) / sizeof(buf[0]), L"%d, ", i * 7); break;
+            case 1: swprintf(buf, sizeof(buf) / sizeof(buf[0]), L"%d.5, ", i); break;
+            case 2: swprintf(buf, sizeof(buf) / sizeof(buf[0]), L"\"s%d\", ", i); break;
+            default: swprintf(buf, sizeof(buf) / sizeof(buf[0]), L"%d : \"v%d\", ", i, i); break;
+        }
+        ret += buf;
+    }
+    ret += L"]\n";
+    return ret;
+}
+
+/*!
+ * Heap held per element by large collection literals, measured right after parse when plain
+ * literals are kept in columns, after a whole compilation that types them from the columns,
+ * and again after every element node is materialized.
+ */
+static void benchLiterals(int elements, int iterations)
+{
+    static const char* kinds[] = {"Int", "Double", "String", "[Int:String]"};
+    printf("%14s %10s %12s %14s %14s %14s\n", "literal", "elements", "ms/parse", "B/el compact", "B/el analyzed", "B/el nodes");
+    for(int kind = 0; kind < 4; kind++)
+    {
+        wstring code = generateLiterals(kind, elements);
+        double parseTime = 0;
+        size_t compact = 0, analyzed = 0, nodes = 0;
+        for(int i = 0; i < iterations; i++)
+        {
+            NodeFactory nodeFactory;
+            CompilerResults compilerResults;
+            Parser parser(&nodeFactory, &compilerResults);
+            parser.setSourceFile(SourceFilePtr(new SourceFile(L"<literals>", code)));
+            ProgramPtr program = nodeFactory.createProgram();
+            size_t before = heapInUse();
+            chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+            parser.parse(code.c_str(), code.size(), program);
+            parseTime += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - begin).count();
+            compact = heapInUse() - before;
+            NodePtr literal = program->getStatement(0);
+            if(ArrayLiteralPtr array = dynamic_pointer_cast<ArrayLiteral>(literal))
+                array->begin();
+            else if(DictionaryLiteralPtr dict = dynamic_pointer_cast<DictionaryLiteral>(literal))
+                dict->begin();
+            nodes = heapInUse() - before;
+        }
+        {
+            SwallowCompiler compiler(L"bench");
+            compiler.addSource(L"<literals>", code);
+            std::vector<ProgramPtr> programs;
+            size_t before = heapInUse();
+            compiler.compile(programs);
+            analyzed = heapInUse() - before;
+        }
+        printf("%14s %10d %12.3f %14.1f %14.1f %14.1f\n", kinds[kind], elements, parseTime / iterations,
+               (double)compact / elements, (double)analyzed / elements, (double)nodes / elements);
+    }
+}
+
+/*!
+ * Visitor that counts the visited nodes, it walks the same nodes as the no-op NodeVisitor
+ */
+class CountingVisitor : public NodeVisitor
+{
+public:
+    CountingVisitor() : nodes(0) {}
+#define COUNT_VISIT(visit, T) virtual void visit(const T& node) override { nodes++; NodeVisitor::visit(node); }
+    COUNT_VISIT(visitValueBindings, ValueBindingsPtr)
+    COUNT_VISIT(visitComputedProperty, ComputedPropertyPtr)
+    COUNT_VISIT(visitValueBinding, ValueBindingPtr)
+    COUNT_VISIT(visitAssignment, AssignmentPtr)
+    COUNT_VISIT(visitClass, ClassDefPtr)
+    COUNT_VISIT(visitStruct, StructDefPtr)
+    COUNT_VISIT(visitEnum, EnumDefPtr)
+    COUNT_VISIT(visitProtocol, ProtocolDefPtr)
+    COUNT_VISIT(visitExtension, ExtensionDefPtr)
+    COUNT_VISIT(visitFunction, FunctionDefPtr)
+    COUNT_VISIT(visitDeinit, DeinitializerDefPtr)
+    COUNT_VISIT(visitInit, InitializerDefPtr)
+    COUNT_VISIT(visitImport, ImportPtr)
+    COUNT_VISIT(visitSubscript, SubscriptDefPtr)
+    COUNT_VISIT(visitTypeAlias, TypeAliasPtr)
+    COUNT_VISIT(visitWhileLoop, WhileLoopPtr)
+    COUNT_VISIT(visitForIn, ForInLoopPtr)
+    COUNT_VISIT(visitForLoop, ForLoopPtr)
+    COUNT_VISIT(visitDoLoop, DoLoopPtr)
+    COUNT_VISIT(visitLabeledStatement, LabeledStatementPtr)
+    COUNT_VISIT(visitOperator, OperatorDefPtr)
+    COUNT_VISIT(visitArrayLiteral, ArrayLiteralPtr)
+    COUNT_VISIT(visitDictionaryLiteral, DictionaryLiteralPtr)
+    COUNT_VISIT(visitBreak, BreakStatementPtr)
+    COUNT_VISIT(visitReturn, ReturnStatementPtr)
+    COUNT_VISIT(visitContinue, ContinueStatementPtr)
+    COUNT_VISIT(visitFallthrough, FallthroughStatementPtr)
+    COUNT_VISIT(visitErrorStatement, ErrorStatementPtr)
+    COUNT_VISIT(visitIf, IfStatementPtr)
+    COUNT_VISIT(visitSwitchCase, SwitchCasePtr)
+    COUNT_VISIT(visitCase, CaseStatementPtr)
+    COUNT_VISIT(visitCodeBlock, CodeBlockPtr)
+    COUNT_VISIT(visitParameter, ParameterNodePtr)
+    COUNT_VISIT(visitParameters, ParametersNodePtr)
+    COUNT_VISIT(visitProgram, ProgramPtr)
+    COUNT_VISIT(visitValueBindingPattern, ValueBindingPatternPtr)
+    COUNT_VISIT(visitConditionalOperator, ConditionalOperatorPtr)
+    COUNT_VISIT(visitBinaryOperator, BinaryOperatorPtr)
+    COUNT_VISIT(visitUnaryOperator, UnaryOperatorPtr)
+    COUNT_VISIT(visitTuple, TuplePtr)
+    COUNT_VISIT(visitIdentifier, IdentifierPtr)
+    COUNT_VISIT(visitCompileConstant, CompileConstantPtr)
+    COUNT_VISIT(visitSubscriptAccess, SubscriptAccessPtr)
+    COUNT_VISIT(visitMemberAccess, MemberAccessPtr)
+    COUNT_VISIT(visitFunctionCall, FunctionCallPtr)
+    COUNT_VISIT(visitClosure, ClosurePtr)
+    COUNT_VISIT(visitSelf, SelfExpressionPtr)
+    COUNT_VISIT(visitInitializerReference, InitializerReferencePtr)
+    COUNT_VISIT(visitTypedPattern, TypedPatternPtr)
+    COUNT_VISIT(visitEnumCasePattern, EnumCasePatternPtr)
+    COUNT_VISIT(visitDynamicType, DynamicTypePtr)
+    COUNT_VISIT(visitForcedValue, ForcedValuePtr)
+    COUNT_VISIT(visitOptionalChaining, OptionalChainingPtr)
+    COUNT_VISIT(visitParenthesizedExpression, ParenthesizedExpressionPtr)
+    COUNT_VISIT(visitString, StringLiteralPtr)
+    COUNT_VISIT(visitStringInterpolation, StringInterpolationPtr)
+    COUNT_VISIT(visitInteger, IntegerLiteralPtr)
+    COUNT_VISIT(visitFloat, FloatLiteralPtr)
+    COUNT_VISIT(visitNilLiteral, NilLiteralPtr)
+    COUNT_VISIT(visitBooleanLiteral, BooleanLiteralPtr)
+    COUNT_VISIT(visitDefaultValue, DefaultValuePtr)
+    COUNT_VISIT(visitArrayType, ArrayTypePtr)
+    COUNT_VISIT(visitFunctionType, FunctionTypePtr)
+    COUNT_VISIT(visitImplicitlyUnwrappedOptional, ImplicitlyUnwrappedOptionalPtr)
+    COUNT_VISIT(visitOptionalType, OptionalTypePtr)
+    COUNT_VISIT(visitProtocolComposition, ProtocolCompositionPtr)
+    COUNT_VISIT(visitTupleType, TupleTypePtr)
+    COUNT_VISIT(visitTypeIdentifier, TypeIdentifierPtr)
+#undef COUNT_VISIT
+public:
+    long nodes;
+};
+
+/*!
+ * Walk the parsed corpus with a no-op NodeVisitor
+ */
+static void benchVisitor(const vector<string>& files, int iterations)
+{
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    vector<ProgramPtr> programs;
+    for(const string& file : files)
+    {
+        wstring code = SwallowUtils::readFile(file.c_str());
+        Parser parser(&nodeFactory, &compilerResults);
+        parser.setSourceFile(SourceFilePtr(new SourceFile(SwallowUtils::toWString(file), code)));
+        programs.push_back(nodeFactory.createProgram());
+        parser.parse(code.c_str(), code.size(), programs.back());
+    }
+    CountingVisitor counter;
+    for(const ProgramPtr& program : programs)
+        program->accept(&counter);
+
+    NodeVisitor visitor;
+    chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+    for(int i = 0; i < iterations; i++)
+    {
+        for(const ProgramPtr& program : programs)
+            program->accept(&visitor);
+    }
+    chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - begin;
+    double ms = elapsed.count() / iterations;
+    printf("%8s %10s %12s %14s\n", "files", "nodes", "ms/walk", "Mnodes/s");
+    printf("%8d %10ld %12.3f %14.2f\n", (int)files.size(), counter.nodes, ms, counter.nodes / ms / 1000);
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 20;
+    int comparisons = 0;
+    int flags = 0;
+    bool parallel = false;
+    int threads = 0;
+    int copies = 16;
+    bool single = false;
+    size_t splitSize = 64 * 1024;
+    int profileRows = 0;
+    bool profileJSON = false;
+    int replInputs = 0;
+    bool arena = false;
+    bool visit = false;
+    int literals = 0;
+    int sortTerms = 0;
+    vector<string> files;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "-n") && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-c") && i + 1 < argc)
+            comparisons = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-k"))
+            flags |= SKIP_BODIES;
+        else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+        {
+            parallel = true;
+            threads = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "-m") && i + 1 < argc)
+            copies = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-u"))
+            single = true;
+        else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+            splitSize = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-p") && i + 1 < argc)
+            profileRows = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-j"))
+            profileJSON = true;
+        else if(!strcmp(argv[i], "-v"))
+            visit = true;
+        else if(!strcmp(argv[i], "-a"))
+            arena = true;
+        else if(!strcmp(argv[i], "-o") && i + 1 < argc)
+            sortTerms = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-l") && i + 1 < argc)
+            literals = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-r"))
+            replInputs = (i + 1 < argc && isdigit(argv[i + 1][0])) ? atoi(argv[++i]) : 100000;
+        else
+            files.push_back(argv[i]);
+    }
+    if(iterations < 1)
+        iterations = 1;
+    if(comparisons > 0)
+    {
+        benchComparisons(comparisons, iterations);
+        return 0;
+    }
+    if(sortTerms > 0)
+    {
+        benchSortExpression(sortTerms, iterations);
+        return 0;
+    }
+    if(literals > 0)
+    {
+        benchLiterals(literals, iterations);
+        return 0;
+    }
+    if(replInputs > 0)
+    {
+        benchReplInputs(replInputs);
+        return 0;
+    }
+    if(files.empty())
+    {
+        //use the swift sources of test cases as default corpus
+        files.push_back(SWALLOW_TESTS_DIR "/runtime.swift");
+        listCorpus(SWALLOW_TESTS_DIR "/semantics", files);
+    }
+    if(visit)
+    {
+        benchVisitor(files, iterations);
+        return 0;
+    }
+    if(arena)
+    {
+        benchArena(files, iterations);
+        return 0;
+    }
+    if(parallel)
+    {
+        //-t 0 scales up to all hardware threads
+        if(threads <= 0)
+            threads = std::max(1u, thread::hardware_concurrency());
+        benchParallel(files, std::max(copies, 1), threads, iterations, single, splitSize);
+        return 0;
+    }
+
+    printf("%-60s %8s %8s %8s %8s %7s %10s\n", "file", "tokens", "lexed", "requests", "hits", "ratio", "ms/parse");
+    long totalTokens = 0, totalLexed = 0, totalRequested = 0, totalHits = 0;
+    double totalTime = 0;
+    ParserProfile profile;
+    bool profiling = profileRows > 0 || profileJSON;
+    for(const string& file : files)
+    {
+        wstring code = SwallowUtils::readFile(file.c_str());
+        int tokens = countTokens(code);
+        ParserStatistics stats = {0, 0, 0, 0};
+        chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+        for(int i = 0; i < iterations; i++)
+        {
+            NodeFactory nodeFactory;
+            CompilerResults compilerResults;
+            Parser parser(&nodeFactory, &compilerResults);
+            parser.setSourceFile(SourceFilePtr(new SourceFile(SwallowUtils::toWString(file), code)));
+            parser.setFlags(flags);
+            if(profiling)
+                parser.setProfile(&profile);
+            parser.parse(code.c_str(), code.size(), nodeFactory.createProgram());
+            stats = parser.getStatistics();
+        }
+        chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - begin;
+        double ms = elapsed.count() / iterations;
+        const char* name = strrchr(file.c_str(), '/');
+        name = name ? name + 1 : file.c_str();
+        printf("%-60s %8d %8d %8d %8d %7.2f %10.3f\n", name, tokens, stats.tokensLexed, stats.tokensRequested, stats.lookaheadHits,
+               tokens ? (double)stats.tokensLexed / tokens : 0.0, ms);
+        totalTokens += tokens;
+        totalLexed += stats.tokensLexed;
+        totalRequested += stats.tokensRequested;
+        totalHits += stats.lookaheadHits;
+        totalTime += ms;
+    }
+    printf("%-60s %8ld %8ld %8ld %8ld %7.2f %10.3f\n", "total", totalTokens, totalLexed, totalRequested, totalHits,
+           totalTokens ? (double)totalLexed / totalTokens : 0.0, totalTime);
+    if(profiling && !ParserProfile::isEnabled())
+    {
+        printf("\nParser profiling is disabled, rebuild with -DPARSER_PROFILE=ON\n");
+    }
+    else if(profileJSON)
+    {
+        profile.dumpJSON(cout);
+    }
+    else if(profiling)
+    {
+        printf("\nHot productions of %d iterations:\n", iterations);
+        profile.dump(cout, profileRows);
+    }
+    return 0;
+}
@@ -0,0 +1,335 @@
+/* BenchTokenizer.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "tokenizer/Tokenizer.h"
+#include "tokenizer/CharScanner.h"
+#include "common/SwallowUtils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace Swallow;
+using namespace std;
+
+/*!
+ * Number of heap allocations made by the whole process, the global operator new is
+ * replaced to count them
+ */
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    allocations++;
+    void* ret = malloc(size ? size : 1);
+    if(!ret)
+        throw std::bad_alloc();
+    return ret;
+}
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+/*!
+ * Corpus generated by repeating the chunks, %d in chunks is replaced by the repetition count
+ */
+struct Corpus
+{
+    const char* name;
+    const wchar_t* const* chunks;
+    size_t count;
+};
+
+static const wchar_t* const mixedChunks[] = {
+    L"/* Multi-line comment describing the type below,\n"
+    L" * with /* nested */ comment and some * stars / slashes\n"
+    L" */\n",
+    L"class ShoppingListItem%d : CustomStringConvertible {\n",
+    L"    // single line comment that runs to the end of line\n",
+    L"    var quantity%d = 1\n",
+    L"    var name : String = \"item \\(quantity) of list\"\n",
+    L"    func purchase(numberOfItems count : Int, withDiscount discount : Double) -> Double {\n",
+    L"        let totalPriceWithoutDiscount = Double(count) * unitPrice + shippingCost\n",
+    L"        return totalPriceWithoutDiscount - totalPriceWithoutDiscount * discount // discount\n",
+    L"    }\n",
+    L"\n\n",
+    L"    subscript(index : Int) -> Int { get { return items[index] } set { items[index] = newValue } }\n",
+    L"}\n",
+};
+static const wchar_t* const identifierChunks[] = {
+    L"let identifierName%d = anotherIdentifier.memberName.nestedMember\n",
+    L"var v%d = self.shoppingList.items.first.name.uppercaseString\n",
+    L"public static func makeConfiguration%d(with settings : Settings, in context : Context) -> Configuration\n",
+    L"if let value = optionalValue where value.isEmpty == false { consume(value, into: destination, using: strategy) }\n",
+    L"typealias ElementType%d = Dictionary<KeyType, Array<ValueType>>\n",
+    L"for item in collection { item.process(); item.finish(); result.append(item.identifier) }\n",
+};
+static const wchar_t* const operatorChunks[] = {
+    L"x%d = a + b * c - d / e % f << 2 >> 3 & g | h ^ ~i\n",
+    L"flag = !(a == b) && c != d || e <= f && g >= h || i < j && k > l\n",
+    L"total += a &+ b &* c &- d; total -= e; total *= f; total /= g\n",
+    L"value = optional ?? fallback ?? defaultValue; range = 0..<count + 0...last\n",
+    L"result = a.map { $0 * 2 }.filter { $0 > 10 }.reduce(0, +) <*> b <^> c\n",
+    L"let r%d = x++ + ++y - z-- - --w; let s = -a + +b\n",
+};
+static const wchar_t* const interpolationChunks[] = {
+    L"let message%d = \"Hello \\(name), you have \\(count) new \\(count == 1 ? singular : plural)\"\n",
+    L"println(\"item \\(index) of \\(items.count): \\(items[index].name) costs \\(price * 1.5)\")\n",
+    L"let path = \"\\(root)/\\(directory)/\\(file).\\(ext)\"; let escaped = \"tab\\t quote\\\" slash\\\\ \\u263a\"\n",
+    L"let nested%d = \"outer \\(depth + (1 * (2 + width))) done \\(Float(ratio) / 3.0)\"\n",
+};
+static const wchar_t* const commentChunks[] = {
+    L"// A line comment number %d explaining the code that follows in some detail\n",
+    L"/* Block comment with /* nested /* deeply */ comments */ and * stars / and slashes */\n",
+    L"/**\n * Documentation comment\n * - parameter value: the value to process\n * - returns: the processed value\n */\n",
+    L"let x%d = 1 // trailing comment\n",
+    L"/// Swift documentation style line comment with `code` and *emphasis*\n",
+};
+
+static const Corpus corpora[] = {
+    {"mixed", mixedChunks, sizeof(mixedChunks) / sizeof(mixedChunks[0])},
+    {"identifier", identifierChunks, sizeof(identifierChunks) / sizeof(identifierChunks[0])},
+    {"operator", operatorChunks, sizeof(operatorChunks) / sizeof(operatorChunks[0])},
+    {"interpolation", interpolationChunks, sizeof(interpolationChunks) / sizeof(interpolationChunks[0])},
+    {"comment", commentChunks, sizeof(commentChunks) / sizeof(commentChunks[0])},
+};
+
+/*!
+ * Generate a swift source of given size by repeating the corpus
+ */
+static wstring generateSource(const Corpus& corpus, size_t size)
+{
+    wstring ret;
+    wchar_t buf[256];
+    int n = 0;
+    while(ret.size() < size)
+    {
+        for(size_t i = 0; i < corpus.count; i++)
+        {
+            swprintf(buf, sizeof(buf) / sizeof(buf[0]), corpus.chunks[i], n);
+            ret += buf;
+        }
+        n++;
+    }
+    return ret;
+}
+
+/*!
+ * Generate a source by concatenating fragments picked by a pseudo random sequence of given seed,
+ * it covers token combinations that the repeated corpora don't have
+ */
+static wstring generateRandomSource(size_t size, unsigned seed)
+{
+    static const wchar_t* const fragments[] = {
+        L"foo", L"Bar_1", L"x", L"self", L"class", L"func", L"let", L"in", L"$0", L"`var`",
+        L"+", L"-", L"*", L"/", L"==", L"!=", L"&&", L"?", L"!", L"...", L"..<", L"->", L"<", L">", L"=",
+        L"(", L")", L"[", L"]", L"{", L"}", L",", L":", L";", L".", L"@", L"#",
+        L"0", L"123", L"0x1F", L"0b101", L"1.5e3", L"1_000",
+        L"\"s\"", L"\"a\\(b)c\"", L"\"\\t\\n\"",
+        L"// c\n", L"/* c */", L"/* a /* b */ c */",
+        L"caf\u00e9", L"\u03c0", L"\u2260", L"\u53d8\u91cf",
+    };
+    static const wchar_t* const separators[] = {L" ", L"\n", L"  \n    ", L"", L"\t"};
+    const size_t numFragments = sizeof(fragments) / sizeof(fragments[0]);
+    const size_t numSeparators = sizeof(separators) / sizeof(separators[0]);
+    wstring ret;
+    while(ret.size() < size)
+    {
+        seed = seed * 1103515245 + 12345;
+        ret += fragments[(seed >> 16) % numFragments];
+        seed = seed * 1103515245 + 12345;
+        ret += separators[(seed >> 16) % numSeparators];
+    }
+    return ret;
+}
+
+struct Result
+{
+    string corpus;
+    size_t characters;
+    size_t bytes;
+    long tokens;
+    int errors;
+    double seconds;
+    size_t allocations;
+};
+
+/*!
+ * Tokenize the code for given iterations and keep the fastest one.
+ * Tokenizer errors are counted and tokenizing resumes from the next line.
+ */
+static Result run(const string& name, const wstring& code, bool utf8, int iterations)
+{
+    Result ret;
+    string encoded = SwallowUtils::toString(code);
+    ret.corpus = name;
+    ret.characters = code.size();
+    ret.bytes = encoded.size();
+    ret.seconds = 0;
+    for(int i = 0; i < iterations; i++)
+    {
+        Tokenizer tokenizer(NULL);
+        if(utf8)
+            tokenizer.setUtf8View(encoded.c_str(), encoded.size());
+        else
+            tokenizer.setView(code.c_str(), code.size());
+        Token token;
+        long tokens = 0;
+        int errors = 0;
+        size_t allocationsBefore = allocations;
+        chrono::high_resolution_clock::time_point begin = chrono::high_resolution_clock::now();
+        for(;;)
+        {
+            try
+            {
+                while(tokenizer.next(token))
+                    tokens++;
+                break;
+            }
+            catch(const TokenizerError& e)
+            {
+                errors++;
+                TokenizerState state = tokenizer.save();
+                size_t lf = utf8 ? encoded.find('\n', e.offset) : code.find(L'\n', e.offset);
+                if(lf == string::npos)
+                    break;
+                state.offset = (int)lf + 1;
+                state.inStringExpression = 0;
+                tokenizer.restore(state);
+            }
+        }
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - begin;
+        if(i == 0 || elapsed.count() < ret.seconds)
+            ret.seconds = elapsed.count();
+        ret.tokens = tokens;
+        ret.errors = errors;
+        ret.allocations = allocations - allocationsBefore;
+    }
+    return ret;
+}
+
+static void printUsage()
+{
+    printf("Usage: bench_tokenizer [-n iterations] [-s MB] [-c corpus] [-r seed] [-u] [-j] [files...]\n");
+    printf("  -c corpus  mixed, identifier, operator, interpolation, comment, random or all(default)\n");
+    printf("  -r seed    seed of the random corpus, default is 1\n");
+    printf("  -u         tokenize the UTF-8 encoding of the code instead of wchar_t\n");
+    printf("  -j         print results as JSON\n");
+}
+
+int main(int argc, char** argv)
+{
+    size_t size = 8 << 20;
+    int iterations = 5;
+    bool utf8 = false;
+    bool json = false;
+    unsigned seed = 1;
+    string corpus = "all";
+    wstring code;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "-n") && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+            size = (size_t)atoi(argv[++i]) << 20;
+        else if(!strcmp(argv[i], "-c") && i + 1 < argc)
+            corpus = argv[++i];
+        else if(!strcmp(argv[i], "-r") && i + 1 < argc)
+            seed = (unsigned)strtoul(argv[++i], NULL, 10);
+        else if(!strcmp(argv[i], "-u"))
+            utf8 = true;
+        else if(!strcmp(argv[i], "-j"))
+            json = true;
+        else if(argv[i][0] == '-')
+        {
+            printUsage();
+            return 1;
+        }
+        else
+            code += SwallowUtils::readFile(argv[i]);
+    }
+    if(iterations < 1)
+        iterations = 1;
+
+    vector<Result> results;
+    if(!code.empty())
+        results.push_back(run("files", code, utf8, iterations));
+    else
+    {
+        for(const Corpus& c : corpora)
+        {
+            if(corpus == "all" || corpus == c.name)
+                results.push_back(run(c.name, generateSource(c, size), utf8, iterations));
+        }
+        if(corpus == "all" || corpus == "random")
+            results.push_back(run("random", generateRandomSource(size, seed), utf8, iterations));
+        if(results.empty())
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    const char* encoding = utf8 ? "utf-8" : "wchar_t";
+    if(json)
+    {
+        printf("{\n");
+        printf("  \"scanner\": \"%s\",\n", CharScanner::getInstructionSet());
+        printf("  \"encoding\": \"%s\",\n", encoding);
+        printf("  \"iterations\": %d,\n", iterations);
+        printf("  \"seed\": %u,\n", seed);
+        printf("  \"results\": [\n");
+        for(size_t i = 0; i < results.size(); i++)
+        {
+            const Result& r = results[i];
+            printf("    {\"corpus\": \"%s\", \"characters\": %lu, \"bytes\": %lu, \"tokens\": %ld, \"errors\": %d, "
+                   "\"seconds\": %.6f, \"tokens_per_second\": %.0f, \"bytes_per_second\": %.0f, "
+                   "\"allocations\": %lu, \"allocations_per_token\": %.4f}%s\n",
+                   r.corpus.c_str(), (unsigned long)r.characters, (unsigned long)r.bytes, r.tokens, r.errors,
+                   r.seconds, r.tokens / r.seconds, r.bytes / r.seconds,
+                   (unsigned long)r.allocations, r.tokens ? (double)r.allocations / r.tokens : 0.0,
+                   i + 1 < results.size() ? "," : "");
+        }
+        printf("  ]\n");
+        printf("}\n");
+        return 0;
+    }
+    printf("scanner: %s, encoding: %s, best of %d\n", CharScanner::getInstructionSet(), encoding, iterations);
+    printf("%-14s %10s %10s %8s %12s %12s %12s\n", "corpus", "MB", "tokens", "errors", "M tokens/s", "MB/s", "allocs/token");
+    for(const Result& r : results)
+    {
+        printf("%-14s %10.2f %10ld %8d %12.2f %12.2f %12.4f\n", r.corpus.c_str(), r.bytes / 1e6, r.tokens, r.errors,
+               r.tokens / r.seconds / 1e6, r.bytes / r.seconds / 1e6, r.tokens ? (double)r.allocations / r.tokens : 0.0);
+    }
+    return 0;
+}
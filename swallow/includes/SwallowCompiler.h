@@ -31,6 +31,7 @@
 #define SWALLOW_COMPILER_H
 #include "swallow_conf.h"
 #include <vector>
+#include <string>
 SWALLOW_NS_BEGIN
 
 
@@ -41,6 +42,7 @@ class SemanticAnalyzer;
 class DeclarationAnalyzer;
 class NodeFactory;
 class SymbolScope;
+class SourceManager;
 typedef std::shared_ptr<struct SourceFile> SourceFilePtr;
 typedef std::shared_ptr<class Module> ModulePtr;
 typedef std::shared_ptr<class Program> ProgramPtr;
@@ -54,18 +56,55 @@ public:
 public:
     void addSourceFile(const SourceFilePtr& sourceFile);
     void addSource(const wstring& name, const wstring& code);
+    /*!
+     * Add UTF-8 encoded source code, it will be lexed without widening
+     */
+    void addSource(const wstring& name, const std::string& utf8);
+    /*!
+     * Add an UTF-8 encoded source file by path. The file is not read here, it's mapped
+     * into memory when the compiler parses it and unmapped once its AST is built.
+     */
+    void addSourcePath(const std::string& path);
+    /*!
+     * Set the number of threads used to parse source files, 0 uses all hardware threads.
+     */
+    void setParsingThreads(int threads);
+    /*!
+     * Files of at least twice the size are split into chunks of top-level declarations that are
+     * parsed in parallel, the size is counted in code units, 0 disables the splitting.
+     */
+    void setSplitSize(size_t size);
 public:
     bool compile();
     bool compile(std::vector<ProgramPtr>& programs);
+    /*!
+     * Parse all source files without semantic analysis.
+     * Files are parsed in parallel, their results are merged in the order of source files.
+     */
+    bool parse(std::vector<ProgramPtr>& programs);
 public:
     ModulePtr getModule();
     ProgramPtr getProgram();
     CompilerResults* getCompilerResults();
+    /*!
+     * Source files added to this compiler, positions in the ASTs are resolved through it
+     */
+    SourceManager* getSourceManager();
     SymbolRegistry* getSymbolRegistry();
     SymbolScope* getScope();
+    /*!
+     * Number of statements parsed after a syntax error was recovered in given source file
+     */
+    int getRecoveredStatements(const SourceFilePtr& sourceFile) const;
 
 protected:
     virtual ProgramPtr createProgramNode();
+private:
+    struct ParseJob;
+    void parse(ParseJob& job);
+    bool parse(class Parser& parser, ParseJob& job);
+    bool split(const SourceFilePtr& source, std::vector<ParseJob>& jobs, std::vector<std::shared_ptr<class MappedFile> >& mappedFiles);
+    void releaseScope(const std::vector<ProgramPtr>& programs);
 private:
     SymbolRegistry* symbolRegistry;
     NodeFactory* nodeFactory;
@@ -74,6 +113,10 @@ private:
     SemanticAnalyzer* semanticAnalyzer;
     DeclarationAnalyzer* declarationAnalyzer;
     std::vector<SourceFilePtr> sourceFiles;
+    SourceManager* sourceManager;
+    std::vector<int> recoveredStatements;
+    int parsingThreads;
+    size_t splitSize;
 
     //results:
     CompilerResults* compilerResults;
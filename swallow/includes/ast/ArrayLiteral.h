@@ -30,6 +30,7 @@
 #ifndef ARRAY_LITERAL_H
 #define ARRAY_LITERAL_H
 #include "Expression.h"
+#include "LiteralColumns.h"
 
 SWALLOW_NS_BEGIN
 
@@ -42,14 +43,29 @@ public:
 	void push(const ExpressionPtr& item);
     ExpressionPtr getElement(int i);
     int numElements()const;
+    /*!
+     * Returns true if all elements are plain literals stored in columns and no node is created yet
+     */
+    bool isCompact()const;
+    /*!
+     * Plain literals can be appended here directly while the array has no element node
+     */
+    bool canCompact()const;
+    LiteralColumns& getLiterals();
 public:
     virtual void accept(NodeVisitor* visitor);
 
+    /*!
+     * Element nodes of compact literals are created on first access by the factory that
+     * created this node, or without a factory if it's already destroyed
+     */
     std::vector<ExpressionPtr>::iterator begin();
     std::vector<ExpressionPtr>::iterator end();
-
-public:
+private:
+    void materialize();
+private:
     std::vector<ExpressionPtr> elements;
+    LiteralColumns literals;
 };
 
 SWALLOW_NS_END
@@ -40,10 +40,10 @@ public:
     ~BinaryOperator();
 public:
     void setLHS(const PatternPtr& val){lhs = val;}
-    PatternPtr getLHS(){return lhs;}
+    const PatternPtr& getLHS(){return lhs;}
 
     void setRHS(const PatternPtr& val){rhs = val;}
-    PatternPtr getRHS(){return rhs;}
+    const PatternPtr& getRHS(){return rhs;}
     
 
 public:
@@ -58,10 +58,10 @@ public:
     void setCaptureSpecifier(CaptureSpecifier val);
     
     void setCapture(const ExpressionPtr& capture);
-    ExpressionPtr getCapture();
+    const ExpressionPtr& getCapture();
     
     void setParameters(const ParametersNodePtr& val);
-    ParametersNodePtr getParameters();
+    const ParametersNodePtr& getParameters();
     
     void setReturnType(const TypeNodePtr& val);
     TypeNodePtr getReturnType();
@@ -35,6 +35,40 @@
 
 SWALLOW_NS_BEGIN
 typedef std::shared_ptr<class Type> TypePtr;
+class CodeBlock;
+
+/*!
+ * Parses the statements of a code block that skipped by parser
+ */
+class SWALLOW_EXPORT CodeBlockLoader
+{
+public:
+    virtual ~CodeBlockLoader() {}
+public:
+    virtual void load(CodeBlock* block) = 0;
+};
+typedef std::shared_ptr<CodeBlockLoader> CodeBlockLoaderPtr;
+
+/*!
+ * Source range of a code block's statements that not parsed yet, and the parser state to parse them
+ */
+struct LazyBody
+{
+    CodeBlockLoaderPtr loader;
+    /*!
+     * Offset of the first character after '{'
+     */
+    int begin;
+    /*!
+     * Offset of the closing '}'
+     */
+    int end;
+    /*!
+     * Parser flags and tokenizer context when the statements were skipped
+     */
+    int flags;
+    int context;
+};
 
 class SWALLOW_EXPORT CodeBlock : public Statement
 {
@@ -51,15 +85,30 @@ public:
 
     const TypePtr& getType()const;
     void setType(const TypePtr& type);
+
+    /*!
+     * Defer the parsing of statements, the loader will be called when statements are first requested
+     */
+    void setLazyBody(const LazyBody& body);
+    const LazyBody& getLazyBody() const;
+    /*!
+     * Return false if the statements are skipped by parser and not parsed yet
+     */
+    bool isLoaded() const { return lazyBody.loader == nullptr;}
+    /*!
+     * Parse the skipped statements, nothing happens if they're already loaded
+     */
+    void load();
 public:
-    std::vector<StatementPtr>::iterator begin() { return statements.begin();}
-    std::vector<StatementPtr>::iterator end() { return statements.end();}
+    std::vector<StatementPtr>::iterator begin() { if(!isLoaded()) load(); return statements.begin();}
+    std::vector<StatementPtr>::iterator end() { if(!isLoaded()) load(); return statements.end();}
 public:
     virtual void accept(NodeVisitor* visitor);
 private:
     Attributes attributes;
     std::vector<StatementPtr> statements;
     TypePtr type;
+    LazyBody lazyBody;
 };
 
 SWALLOW_NS_END
@@ -61,21 +61,21 @@ public:
     void setInitializer(const ExpressionPtr& initializer);
     const ExpressionPtr& getInitializer()const;
     void setSetter(const CodeBlockPtr& setter);
-    CodeBlockPtr getSetter();
+    const CodeBlockPtr& getSetter();
     
     void setSetterName(const std::wstring& name);
     const std::wstring& getSetterName();
     
     void setGetter(const CodeBlockPtr& getter);
-    CodeBlockPtr getGetter();
+    const CodeBlockPtr& getGetter();
     
     void setWillSet(const CodeBlockPtr& willSet);
-    CodeBlockPtr getWillSet();
+    const CodeBlockPtr& getWillSet();
     void setWillSetSetter(const std::wstring& name);
     const std::wstring& getWillSetSetter()const;
     
     void setDidSet(const CodeBlockPtr& didSet);
-    CodeBlockPtr getDidSet();
+    const CodeBlockPtr& getDidSet();
     
     void setDidSetSetter(const std::wstring& name);
     const std::wstring& getDidSetSetter()const;
@@ -39,9 +39,9 @@ public:
     ConditionalOperator();
     ~ConditionalOperator();
 public:
-    PatternPtr getCondition() { return condition;}
-    ExpressionPtr getTrueExpression() { return trueExpression;}
-    ExpressionPtr getFalseExpression() { return falseExpression;}
+    const PatternPtr& getCondition() { return condition;}
+    const ExpressionPtr& getTrueExpression() { return trueExpression;}
+    const ExpressionPtr& getFalseExpression() { return falseExpression;}
     
     
     void setCondition(PatternPtr v) { condition = v;}
@@ -41,7 +41,7 @@ public:
     DeinitializerDef();
     ~DeinitializerDef();
 public:
-    CodeBlockPtr getBody();
+    const CodeBlockPtr& getBody();
     void setBody(const CodeBlockPtr& body);
 public:
     virtual void accept(NodeVisitor* visitor);
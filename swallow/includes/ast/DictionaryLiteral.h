@@ -30,6 +30,7 @@
 #ifndef DICTIONARY_LITERAL_H
 #define DICTIONARY_LITERAL_H
 #include "Expression.h"
+#include "LiteralColumns.h"
 
 SWALLOW_NS_BEGIN
 
@@ -42,13 +43,31 @@ public:
 public:
 	void insert(const ExpressionPtr& key, const ExpressionPtr& value);
     int numElements()const;
+    /*!
+     * Returns true if all keys and values are plain literals stored in columns and no node is created yet
+     */
+    bool isCompact()const;
+    /*!
+     * Plain literal entries can be appended to key/value columns while the dictionary has no entry node
+     */
+    bool canCompact()const;
+    LiteralColumns& getLiteralKeys();
+    LiteralColumns& getLiteralValues();
 public:
-    Map::iterator begin(){return items.begin();}
-    Map::iterator end(){return items.end();}
+    /*!
+     * Entry nodes of compact literals are created on first access by the factory that
+     * created this node, or without a factory if it's already destroyed
+     */
+    Map::iterator begin(){materialize(); return items.begin();}
+    Map::iterator end(){materialize(); return items.end();}
 public:
     virtual void accept(NodeVisitor* visitor);
+private:
+    void materialize();
 private:
     Map items;
+    LiteralColumns keys;
+    LiteralColumns values;
 };
 
 SWALLOW_NS_END
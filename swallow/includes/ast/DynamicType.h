@@ -40,7 +40,7 @@ public:
     ~DynamicType();
 public:
     void setExpression(const ExpressionPtr& expr);
-    ExpressionPtr getExpression();
+    const ExpressionPtr& getExpression();
 public:
     virtual void accept(NodeVisitor* visitor);
 private:
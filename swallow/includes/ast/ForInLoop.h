@@ -50,10 +50,10 @@ public:
     PatternPtr getLoopVars();
     
     void setContainer(const ExpressionPtr& vla);
-    ExpressionPtr getContainer();
+    const ExpressionPtr& getContainer();
     
     void setCodeBlock(const CodeBlockPtr& val);
-    CodeBlockPtr getCodeBlock();
+    const CodeBlockPtr& getCodeBlock();
 
     void setDeclaredType(const TypeNodePtr& type);
     TypeNodePtr getDeclaredType()const;
@@ -47,18 +47,18 @@ public:
     int numInit() const;
     ExpressionPtr getInit(int idx) const;
 
-    ValueBindingsPtr getInitializer() const;
+    const ValueBindingsPtr& getInitializer() const;
     void setInitializer(const ValueBindingsPtr& initializer);
 
 
     void setCondition(const ExpressionPtr& cond);
-    ExpressionPtr getCondition();
+    const ExpressionPtr& getCondition();
     
     void setStep(const ExpressionPtr& step);
     ExpressionPtr getStep();
     
     void setCodeBlock(const CodeBlockPtr& codeBlock);
-    CodeBlockPtr getCodeBlock();
+    const CodeBlockPtr& getCodeBlock();
     
 public:
     virtual void accept(NodeVisitor* visitor);
@@ -43,13 +43,13 @@ public:
 public:
     
     void setFunction(const ExpressionPtr& expr);
-    ExpressionPtr getFunction();
+    const ExpressionPtr& getFunction();
     
     void setArguments(const ParenthesizedExpressionPtr& arguments);
-    ParenthesizedExpressionPtr getArguments();
+    const ParenthesizedExpressionPtr& getArguments();
     
     void setTrailingClosure(const ClosurePtr& trailingClosure);
-    ClosurePtr getTrailingClosure();
+    const ClosurePtr& getTrailingClosure();
 public:
     virtual void accept(NodeVisitor* visitor);
 private:
@@ -74,7 +74,7 @@ public:
     const Attributes& getReturnTypeAttributes()const;
     
     void setBody(const CodeBlockPtr& body);
-    CodeBlockPtr getBody();
+    const CodeBlockPtr& getBody();
 
     const TypePtr& getType()const;
     void setType(const TypePtr& type);
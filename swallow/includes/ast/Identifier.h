@@ -45,7 +45,11 @@ public:
     virtual void accept(NodeVisitor* visitor);
 public:
     const std::wstring& getIdentifier() const { return identifier;}
-    void setIdentifier(const std::wstring& id){identifier = id;}
+    /*!
+     * Set the name, symbol is its id in the compilation's string pool, or 0 if it's not interned
+     */
+    void setIdentifier(const std::wstring& id, int symbol = 0){identifier = id; this->symbol = symbol;}
+    int getSymbol() const { return symbol;}
     
 //    void setDeclaredType(const TypeNodePtr& type);
 //    TypeNodePtr getDeclaredType();
@@ -59,6 +63,7 @@ public:
     static bool is(const NodePtr& node, const wchar_t* name);
 protected:
     std::wstring identifier;
+    int symbol;
     TypeNodePtr declaredType;
     GenericArgumentDefPtr genericArgumentDef;
 };
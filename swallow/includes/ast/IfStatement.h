@@ -45,13 +45,13 @@ public:
     ~IfStatement();
 public:
     void setCondition(const ExpressionPtr& expr);
-    ExpressionPtr getCondition();
+    const ExpressionPtr& getCondition();
     
     void setThen(const CodeBlockPtr& thenPart);
-    CodeBlockPtr getThen();
+    const CodeBlockPtr& getThen();
     
     void setElse(const StatementPtr& elsePart);
-    StatementPtr getElse();
+    const StatementPtr& getElse();
     
 public:
     virtual void accept(NodeVisitor* visitor);
@@ -46,10 +46,10 @@ public:
     using Declaration::getGenericParametersDef;
 
     void setParameters(const ParametersNodePtr& parameters);
-    ParametersNodePtr getParameters();
+    const ParametersNodePtr& getParameters();
     
     void setBody(const CodeBlockPtr& body);
-    CodeBlockPtr getBody();
+    const CodeBlockPtr& getBody();
 
     bool isFailable() const { return failable;}
     void setFailable(bool v) {failable = v;}
@@ -44,7 +44,7 @@ public:
     const std::wstring& getLabel() const;
     
     void setStatement(const StatementPtr& statement);
-    StatementPtr getStatement();
+    const StatementPtr& getStatement();
 public:
     virtual void accept(NodeVisitor* visitor);
 private:
@@ -0,0 +1,113 @@
+/* LiteralColumns.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef LITERAL_COLUMNS_H
+#define LITERAL_COLUMNS_H
+#include "Expression.h"
+#include "NodeArena.h"
+#include <string>
+#include <vector>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * Compact storage of plain literals(integer, float and non-interpolated string)
+ * used by collection literals, each literal takes one row across the columns
+ * instead of a standalone node. Nodes are only created on materialize.
+ */
+class SWALLOW_EXPORT LiteralColumns
+{
+public:
+    LiteralColumns();
+public:
+    /*!
+     * Factory of the materialized nodes, they're allocated from given arena without a factory
+     * if the factory is already destroyed
+     */
+    void setNodeFactory(const std::weak_ptr<NodeFactory>& nodeFactory, const NodeArenaPtr& arena);
+    /*!
+     * Returns the factory of materialized nodes, or nullptr if it's destroyed
+     */
+    std::shared_ptr<NodeFactory> lockNodeFactory() const;
+    /*!
+     * Type of all literals once the collection is analyzed, it's given to the materialized nodes
+     */
+    void setElementType(const TypePtr& type);
+    const TypePtr& getElementType() const;
+    void addInteger(int offset, const std::wstring& text, int64_t value);
+    void addFloat(int offset, const std::wstring& text, double value);
+    void addString(int offset, const std::wstring& value);
+    /*!
+     * Append an existing literal node, returns false if it's not a plain literal
+     */
+    bool add(const ExpressionPtr& literal);
+
+    int size() const { return (int)types.size(); }
+    bool empty() const { return types.empty(); }
+    void clear();
+
+    NodeType::T getType(int i) const { return (NodeType::T)types[i]; }
+    int getOffset(int i) const { return offsets[i]; }
+    int64_t getInteger(int i) const { return numbers[i].i; }
+    double getFloat(int i) const { return numbers[i].d; }
+    /*!
+     * Literal text of integer/float or the value of string
+     */
+    std::wstring getText(int i) const;
+    int getTextLength(int i) const;
+
+    /*!
+     * Create the node of i-th literal by given factory returned by lockNodeFactory,
+     * source file is taken from given source info
+     */
+    ExpressionPtr materialize(NodeFactory* factory, const SourceInfo& base, int i) const;
+private:
+    void addRow(NodeType::T type, int offset, const std::wstring& text);
+private:
+    union Number
+    {
+        int64_t i;
+        double d;
+    };
+    std::vector<unsigned char> types;
+    std::vector<int> offsets;
+    std::vector<Number> numbers;
+    /*!
+     * End positions of each literal's text in texts
+     */
+    std::vector<int> textEnds;
+    std::wstring texts;
+    TypePtr elementType;
+    std::weak_ptr<NodeFactory> nodeFactory;
+    NodeArenaPtr arena;
+};
+
+SWALLOW_NS_END
+
+#endif//LITERAL_COLUMNS_H
@@ -43,7 +43,7 @@ public:
     void setSelf(const ExpressionPtr& self);
     void setField(const IdentifierPtr& field);
     
-    ExpressionPtr getSelf();
+    const ExpressionPtr& getSelf();
     IdentifierPtr getField();
 
     int getIndex() const;
@@ -37,9 +37,6 @@
 #include <memory>
 #include "NodeVisitor.h"
 #include "common/ScopedValue.h"
-#ifdef TRACE_NODE
-#include <list>
-#endif//TRACE_NODE
 
 SWALLOW_NS_BEGIN
 
@@ -72,6 +69,7 @@ struct NodeType
         DynamicType,
         EnumCasePattern,
         Enum,
+        ErrorStatement,
         Extension,
         Fallthrough,
         FloatLiteral,
@@ -141,6 +139,8 @@ public:
     NodeType::T getNodeType();
     NodeFactory* getNodeFactory();
     NodePtr getParentNode() const;
+private:
+    void setParentNode(Node* parent);
 public:
     virtual void accept(NodeVisitor* visitor){}
 
@@ -148,9 +148,11 @@ protected:
     template<class ASTNode>
     inline void accept2(NodeVisitor* visitor, void (NodeVisitor::*visit)(const std::shared_ptr<ASTNode>&))
     {
-        std::shared_ptr<ASTNode> self = std::static_pointer_cast<ASTNode>(shared_from_this());
-        this->parentNode = visitor->currentNode;
-        SCOPED_SET(visitor->currentNode, self);
+        //visitors may keep the node, so it's passed as an owning pointer, but the parent and
+        //current node are borrowed to keep the refcount traffic of each visit minimal
+        std::shared_ptr<ASTNode> self(shared_from_this(), static_cast<ASTNode*>(this));
+        setParentNode(visitor->currentNode);
+        SCOPED_SET(visitor->currentNode, this);
         (visitor->*visit)(self);
     }
 
@@ -166,10 +168,31 @@ protected:
     NodeType::T nodeType;
     NodeFactory* nodeFactory;
     std::weak_ptr<Node> parentNode;
+    /*!
+     * The parent that parentNode was taken from, passes visiting the same tree won't update
+     * the weak reference again
+     */
+    Node* linkedParent;
 #ifdef TRACE_NODE
 public:
-    static std::list<Node*> UnreleasedNodes;
-    static int NodeCount;
+    /*!
+     * Number of tracked nodes that are not released yet
+     */
+    static int getNodeCount();
+    /*!
+     * Get tracked nodes that are not released yet in creation order
+     */
+    static std::vector<Node*> getUnreleasedNodes();
+    /*!
+     * Stop tracking all nodes alive, they can still be released later
+     */
+    static void resetTrace();
+private:
+    /*!
+     * Links of the intrusive list of alive nodes, a node can unlink itself in constant time
+     */
+    Node* tracePrev;
+    Node* traceNext;
 #endif
 };
 typedef std::shared_ptr<Node> NodePtr;
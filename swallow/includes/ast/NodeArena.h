@@ -0,0 +1,133 @@
+/* NodeArena.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+#include "swallow_conf.h"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * Bump allocator for AST nodes.
+ * Memory is handed out from large slabs and never returned one by one, all slabs are
+ * freed together when the arena is destroyed.
+ * The thread created the arena bumps the arena's own slab, other threads bump their own
+ * slabs, so parsers running in parallel can share an arena and only take the lock when
+ * a slab is exhausted.
+ */
+class SWALLOW_EXPORT NodeArena
+{
+public:
+    enum
+    {
+        SLAB_SIZE = 64 * 1024,
+        ALIGNMENT = alignof(std::max_align_t)
+    };
+public:
+    NodeArena();
+    ~NodeArena();
+public:
+    /*!
+     * Allocate given bytes from current thread's slab of this arena
+     */
+    void* allocate(size_t size);
+
+    /*!
+     * Number of slabs allocated from system
+     */
+    size_t numSlabs();
+
+    /*!
+     * Total bytes of all slabs
+     */
+    size_t getReservedBytes();
+private:
+    char* allocateSlab(size_t size);
+    void* bump(char*& top, char*& limit, size_t size);
+private:
+    /*!
+     * Unique id of the arena, a thread's bump pointer is looked up by this id, so an arena
+     * that reuses the address of a destroyed one never sees the stale slab
+     */
+    unsigned long id;
+    std::thread::id owner;
+    char* cursor;
+    char* end;
+    std::mutex lock;
+    std::vector<char*> slabs;
+    size_t reservedBytes;
+};
+typedef std::shared_ptr<NodeArena> NodeArenaPtr;
+
+/*!
+ * Allocator used by std::allocate_shared to put a node and its control block into an arena.
+ * Every control block keeps the arena alive, nodes that outlive their node factory are still valid.
+ */
+template<class T>
+struct NodeAllocator
+{
+    typedef T value_type;
+
+    explicit NodeAllocator(const NodeArenaPtr& arena)
+    :arena(arena)
+    {}
+    template<class U>
+    NodeAllocator(const NodeAllocator<U>& rhs)
+    :arena(rhs.arena)
+    {}
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(arena->allocate(n * sizeof(T)));
+    }
+    void deallocate(T*, size_t)
+    {
+        //released with the whole arena
+    }
+    template<class U>
+    bool operator==(const NodeAllocator<U>& rhs) const
+    {
+        return arena == rhs.arena;
+    }
+    template<class U>
+    bool operator!=(const NodeAllocator<U>& rhs) const
+    {
+        return arena != rhs.arena;
+    }
+
+    NodeArenaPtr arena;
+};
+
+SWALLOW_NS_END
+
+#endif//NODE_ARENA_H
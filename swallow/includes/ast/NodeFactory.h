@@ -33,16 +33,41 @@
 #include <string>
 #include <vector>
 #include "ast-decl.h"
+#include "NodeArena.h"
 
 SWALLOW_NS_BEGIN
 
 struct SourceInfo;
+typedef std::shared_ptr<class StringPool> StringPoolPtr;
 
 class SWALLOW_EXPORT NodeFactory
 {
 public:
     NodeFactory();
     virtual ~NodeFactory(){}
+public:
+    /*!
+     * Nodes are allocated from the arena, a new factory creates its own arena.
+     * Set to nullptr to allocate each node from heap.
+     */
+    void setArena(const NodeArenaPtr& arena);
+    const NodeArenaPtr& getArena() const;
+    /*!
+     * Allocate nodes created from now on from a new arena, nodes created before keep the
+     * old arena alive and its slabs are freed once all of them are released.
+     * Does nothing when nodes are allocated from heap.
+     */
+    void resetArena();
+    /*!
+     * Weak reference to this factory, it expires when the factory is destroyed
+     */
+    std::weak_ptr<NodeFactory> getWeakReference() const;
+    /*!
+     * Scopes of the created nodes intern their names in this pool, a new factory creates its own pool.
+     * Set it to the symbol registry's pool to look up the parsed identifiers by their ids.
+     */
+    void setStringPool(const StringPoolPtr& pool);
+    const StringPoolPtr& getStringPool() const;
 public:
     virtual ProgramPtr createProgram();
     virtual CommentNodePtr createComment(const SourceInfo& state);
@@ -89,6 +114,7 @@ public:
     virtual BreakStatementPtr createBreak(const SourceInfo& state);
     virtual ContinueStatementPtr createContinue(const SourceInfo& state);
     virtual FallthroughStatementPtr createFallthrough(const SourceInfo& state);
+    virtual ErrorStatementPtr createErrorStatement(const SourceInfo& state);
     virtual ReturnStatementPtr createReturn(const SourceInfo& state);
     virtual LabeledStatementPtr createLabel(const SourceInfo& state);
     virtual CodeBlockPtr createCodeBlock(const SourceInfo& state);
@@ -129,18 +155,47 @@ public:
     virtual GenericConstraintDefPtr createGenericConstraintDef(const SourceInfo& state);
     virtual GenericParametersDefPtr createGenericParametersDef(const SourceInfo& state);
     virtual StringInterpolationPtr createStringInterpolation(const SourceInfo& state);
+public:
+    /*!
+     * Create a node that belongs to no factory in given arena, it's used when the factory
+     * that created its parent is already destroyed
+     */
+    template<class T>
+    static std::shared_ptr<T> createDetached(const NodeArenaPtr& arena, const SourceInfo& s)
+    {
+        std::shared_ptr<T> ret = allocate<T>(arena);
+        *ret->getSourceInfo() = s;
+        return ret;
+    }
 protected:
 
     void bindNode(const SourceInfo&s, Node* n);
 
+    template<class T>
+    static std::shared_ptr<T> allocate(const NodeArenaPtr& arena)
+    {
+        if(arena)
+            return std::allocate_shared<T>(NodeAllocator<T>(arena));
+        return std::shared_ptr<T>(new T());
+    }
+
     template<class T>
     inline std::shared_ptr<T> create(const SourceInfo& s)
     {
-        std::shared_ptr<T> ret(new T());
+        std::shared_ptr<T> ret = allocate<T>(arena);
         bindNode(s, ret.get());
         return ret;
     }
-
+private:
+    NodeFactory(const NodeFactory&);
+    NodeFactory& operator=(const NodeFactory&);
+protected:
+    NodeArenaPtr arena;
+    StringPoolPtr stringPool;
+    /*!
+     * Never deletes the factory, weak references to it expire with the factory
+     */
+    std::shared_ptr<NodeFactory> self;
 };
 
 
@@ -73,6 +73,7 @@ public://statement
     virtual void visitReturn(const ReturnStatementPtr& node);
     virtual void visitContinue(const ContinueStatementPtr& node);
     virtual void visitFallthrough(const FallthroughStatementPtr& node);
+    virtual void visitErrorStatement(const ErrorStatementPtr& node);
     virtual void visitIf(const IfStatementPtr& node);
     virtual void visitSwitchCase(const SwitchCasePtr& node);
     virtual void visitCase(const CaseStatementPtr& node);
@@ -117,7 +118,10 @@ public:
     virtual void visitTupleType(const TupleTypePtr& node);
     virtual void visitTypeIdentifier(const TypeIdentifierPtr& node);
 protected:
-    NodePtr currentNode;
+    /*!
+     * The node being visited, it's borrowed from the visiting tree
+     */
+    Node* currentNode = nullptr;
 };
 
 
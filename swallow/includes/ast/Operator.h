@@ -47,6 +47,12 @@ public:
     void setPrecedence(int v) { precedence = v;}
     const std::wstring& getOperator() const { return op;}
     void setOperator(const std::wstring& op) {this->op = op;}
+    /*!
+     * Sorted operators are built by the parser in precedence order,
+     * OperatorResolver doesn't need to rotate them.
+     */
+    bool isSorted() const { return sorted;}
+    void setSorted(bool sorted) { this->sorted = sorted;}
 public:
     virtual int numChildren() = 0;
     virtual NodePtr get(int i) = 0;
@@ -56,7 +62,7 @@ protected:
     OperatorType::T operatorType;
     Associativity::T associativity;
     int precedence;
-    
+    bool sorted;
 };
 
 SWALLOW_NS_END
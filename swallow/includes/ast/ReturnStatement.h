@@ -42,7 +42,7 @@ public:
     ~ReturnStatement();
 public:
     void setExpression(const ExpressionPtr& expr);
-    ExpressionPtr getExpression();
+    const ExpressionPtr& getExpression();
 public:
     virtual void accept(NodeVisitor* visitor);
 private:
@@ -44,7 +44,7 @@ public:
     ~SubscriptDef();
 public:
     void setParameters(const ParametersNodePtr& params);
-    ParametersNodePtr getParameters();
+    const ParametersNodePtr& getParameters();
     
     void setReturnType(const TypeNodePtr& type);
     TypeNodePtr getReturnType();
@@ -53,10 +53,10 @@ public:
     const Attributes& getReturnTypeAttributes()const;
     
     void setGetter(const CodeBlockPtr& getter);
-    CodeBlockPtr getGetter();
+    const CodeBlockPtr& getGetter();
     
     void setSetter(const CodeBlockPtr& setter);
-    CodeBlockPtr getSetter();
+    const CodeBlockPtr& getSetter();
     
     void setSetterName(const std::wstring& name);
     const std::wstring& getSetterName()const;
@@ -43,14 +43,14 @@ public:
     ~SwitchCase();
 public:
     void setControlExpression(const ExpressionPtr& expr);
-    ExpressionPtr getControlExpression();
+    const ExpressionPtr& getControlExpression();
     
     void addCase(const CaseStatementPtr& c);
     int numCases();
     CaseStatementPtr getCase(int idx);
     
     void setDefaultCase(const CaseStatementPtr& c);
-    CaseStatementPtr getDefaultCase();
+    const CaseStatementPtr& getDefaultCase();
 public:
     std::vector<CaseStatementPtr>::iterator begin() {return cases.begin();}
     std::vector<CaseStatementPtr>::iterator end() {return cases.end();}
@@ -45,7 +45,7 @@ public:
     virtual void accept(NodeVisitor* visitor);
 public:
     void setPattern(const PatternPtr& pattern);
-    PatternPtr getPattern()const;
+    const PatternPtr& getPattern()const;
     
     void setDeclaredType(const TypeNodePtr& type);
     TypeNodePtr getDeclaredType();
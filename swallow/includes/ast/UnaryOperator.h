@@ -40,7 +40,7 @@ public:
     ~UnaryOperator();
 public:
     void setOperand(const ExpressionPtr& node){operand = node;}
-    ExpressionPtr getOperand(){return operand;}
+    const ExpressionPtr& getOperand(){return operand;}
     
 public:
     virtual int numChildren();
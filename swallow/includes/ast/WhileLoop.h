@@ -43,10 +43,10 @@ public:
     ~WhileLoop();
 public:
     void setCodeBlock(const CodeBlockPtr& codeBlock);
-    CodeBlockPtr getCodeBlock();
+    const CodeBlockPtr& getCodeBlock();
     
     void setCondition(const ExpressionPtr& expression);
-    ExpressionPtr getCondition();
+    const ExpressionPtr& getCondition();
 public:
     virtual void accept(NodeVisitor* visitor);
 private:
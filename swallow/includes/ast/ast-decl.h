@@ -84,6 +84,7 @@ typedef std::shared_ptr<class ReturnStatement> ReturnStatementPtr;
 typedef std::shared_ptr<class BreakStatement> BreakStatementPtr;
 typedef std::shared_ptr<class ContinueStatement> ContinueStatementPtr;
 typedef std::shared_ptr<class FallthroughStatement> FallthroughStatementPtr;
+typedef std::shared_ptr<class ErrorStatement> ErrorStatementPtr;
 typedef std::shared_ptr<class LabeledStatement> LabeledStatementPtr;
 typedef std::shared_ptr<class CodeBlock> CodeBlockPtr;
 typedef std::shared_ptr<class Tuple> TuplePtr;
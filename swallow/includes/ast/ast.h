@@ -72,6 +72,7 @@
 #include "ContinueStatement.h"
 #include "DoLoop.h"
 #include "FallthroughStatement.h"
+#include "ErrorStatement.h"
 #include "ForLoop.h"
 #include "ForInLoop.h"
 #include "IfStatement.h"
@@ -31,6 +31,7 @@
 #define ERROR_LIST_H
 #include "swallow_conf.h"
 #include "swallow_types.h"
+#include "common/SourceManager.h"
 #include <string>
 #include <vector>
 
@@ -52,30 +53,49 @@ struct CompilerResult : SourceInfo
     ErrorLevel::T level;
     int code;
     ResultItems items;
+    /*!
+     * Resolved through the SourceManager of the results when the result is added, the result
+     * keeps the file alive so it can still be printed after the compilation is gone.
+     * It's null if the results have no SourceManager or the file is not in it.
+     */
+    SourceFilePtr sourceFile;
+    int line;
+    int column;
 
     
-    CompilerResult(ErrorLevel::T level, const SourceInfo& sourceInfo, int code, const ResultItems& items)
-    :level(level), code(code), items(items)
+    CompilerResult(ErrorLevel::T level, const SourceInfo& sourceInfo, int code, const ResultItems& items, const SourceFilePtr& sourceFile)
+    :SourceInfo(sourceInfo), level(level), code(code), items(items), sourceFile(sourceFile), line(0), column(0)
     {
-        this->sourceFile = sourceInfo.sourceFile;
-        this->line = sourceInfo.line;
-        this->column = sourceInfo.column;
+        if(sourceFile)
+            sourceFile->getPosition(offset, line, column);
     }
 };
 
 class SWALLOW_EXPORT CompilerResults
 {
 public:
+    CompilerResults();
+public:
+    /*!
+     * Source files of the compilation that results are reported in
+     */
+    void setSourceManager(const SourceManager* sourceManager);
+    const SourceManager* getSourceManager() const;
     void clear();
     int numResults() const;
     const CompilerResult& getResult(int i) const;
     void add(ErrorLevel::T level, const SourceInfo&, int code, const ResultItems& items);
     void add(ErrorLevel::T level, const SourceInfo&, int code, const std::wstring& item = std::wstring());
+    /*!
+     * Append all results from another list, used to merge results collected in parallel
+     */
+    void add(const CompilerResults& results);
 
     std::vector<CompilerResult>::iterator begin() { return results.begin();}
     std::vector<CompilerResult>::iterator end() { return results.end();}
 private:
     std::vector<CompilerResult> results;
+    const SourceManager* sourceManager;
 };
 
 SWALLOW_NS_END
@@ -57,6 +57,7 @@ struct SWALLOW_EXPORT Errors
         E_UNEXPECTED_CHARACTER_A_IN_STRING_INTERPOLATION,// Unexpected '%0' character in string interpolation
         E_INVALID_ESCAPE_SEQUENCE_IN_LITERAL,
         E_COMPUTED_PROPERTY_CANNOT_BE_DECLARED_UNDER_FOR_LOOP, //Computed property cannot be declared under for loop
+        E_CANNOT_OPEN_SOURCE_FILE_1, // Cannot open source file %0
 
         //semantic errors
         E_INVALID_REDECLARATION_1, // Invalid redeclaration of type %0
@@ -0,0 +1,73 @@
+/* MappedFile.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include "swallow_conf.h"
+#include <cstddef>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * A read-only memory mapping of a file.
+ * The content is paged in by the OS on access and the mapping is released on close()
+ * or destruction, so the file never occupies a heap buffer.
+ */
+class SWALLOW_EXPORT MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+public:
+    /*!
+     * Map given file, returns false if the file cannot be opened or mapped
+     */
+    bool open(const char* path);
+    /*!
+     * Release the mapping
+     */
+    void close();
+    bool isOpen() const;
+    /*!
+     * Content of the file, it's not zero-terminated
+     */
+    const char* getData() const;
+    size_t getSize() const;
+private:
+    const char* data;
+    size_t size;
+    bool mapped;
+};
+
+SWALLOW_NS_END
+
+#endif//MAPPED_FILE_H
@@ -0,0 +1,68 @@
+/* SourceManager.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SOURCE_MANAGER_H
+#define SOURCE_MANAGER_H
+#include "swallow_conf.h"
+#include "swallow_types.h"
+#include <unordered_map>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * Source files of a compilation, SourceInfo refers to a file by the id given here.
+ * The manager owns the files, so positions are resolved as long as the compilation is
+ * alive, results keep their own file to be printed after that.
+ * Ids are unique in the process so nodes that outlive a compilation are never resolved
+ * to another compilation's file, a file should only be added to one manager.
+ * Files are added before parsing, lookups don't lock and can run from parsing threads.
+ */
+class SWALLOW_EXPORT SourceManager
+{
+public:
+    /*!
+     * Own the file and give it an id if it doesn't have one, returns the id or 0 for null file
+     */
+    int addFile(const SourceFilePtr& file);
+    /*!
+     * Returns the file of given id, or null if it's not in this manager
+     */
+    SourceFilePtr getFile(int id) const;
+    /*!
+     * Resolve the 1-based line and column of given position, returns false if the file is not in this manager
+     */
+    bool getPosition(const SourceInfo& info, int& line, int& column) const;
+    int numFiles() const;
+private:
+    std::unordered_map<int, SourceFilePtr> files;
+};
+
+SWALLOW_NS_END
+
+#endif//SOURCE_MANAGER_H
@@ -0,0 +1,115 @@
+/* StringPool.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+#include "swallow_conf.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * A hash-consed pool of identifiers and operators.
+ * Each distinct string is stored once and gets a stable id, so two strings interned into the
+ * same pool are equal if and only if their ids are equal. Id 0 is the empty string.
+ *
+ * A pool is owned by a compilation, parse jobs running in different threads don't intern into
+ * it directly, each of them has a front pool of it. The front gives the ids of the shared pool
+ * and keeps the strings it has seen, so only a string that's new to the job locks the shared pool
+ * to merge it. Calls to the shared pool itself are not locked, they must not run while jobs are
+ * interning through their fronts.
+ */
+class SWALLOW_EXPORT StringPool
+{
+public:
+    /*!
+     * Create a pool, or a front of given shared pool
+     */
+    StringPool(const std::shared_ptr<StringPool>& shared = nullptr);
+public:
+    /*!
+     * Intern given string and return its id, the same content always returns the same id.
+     */
+    int intern(const wchar_t* str, size_t length);
+    int intern(const std::wstring& str);
+    /*!
+     * Returns the id of given string without interning it, or -1 if it's not in the pool.
+     */
+    int find(const wchar_t* str, size_t length) const;
+    int find(const std::wstring& str) const;
+    /*!
+     * Returns the content of given id, the reference stays valid during the lifetime of the pool.
+     */
+    const std::wstring& get(int id) const;
+    /*!
+     * Number of distinct strings in the pool, a front only counts the strings it has seen
+     */
+    int size() const;
+    /*!
+     * The pool that gives the ids of this front, or null if it's not a front
+     */
+    const std::shared_ptr<StringPool>& getShared() const;
+private:
+    static unsigned hash(const wchar_t* str, size_t length);
+    int lookup(const wchar_t* str, size_t length, unsigned h) const;
+    void grow();
+private:
+    struct Entry
+    {
+        /*!
+         * Content of the string, it's stored in the shared pool for a front
+         */
+        const std::wstring* str;
+        unsigned hash;
+        int id;
+    };
+    std::shared_ptr<StringPool> shared;
+    /*!
+     * Locked by the fronts of this pool when they merge a string
+     */
+    mutable std::mutex mutex;
+    /*!
+     * Interned strings indexed by id, deque keeps references stable when growing
+     */
+    std::deque<std::wstring> strings;
+    std::vector<Entry> entries;
+    /*!
+     * Open addressing slots, each slot stores the index of entry + 1, 0 means empty
+     */
+    std::vector<int> slots;
+};
+typedef std::shared_ptr<StringPool> StringPoolPtr;
+
+SWALLOW_NS_END
+
+#endif//STRING_POOL_H
@@ -43,18 +43,25 @@ typedef std::shared_ptr<class Node> NodePtr;
 struct SwallowUtils
 {
     static void dumpHex(const char* s);
+    /*!
+     * Read an UTF-8 encoded file and decode it to wide characters
+     */
     static std::wstring readFile(const char* fileName);
+    /*!
+     * Read the raw bytes of an UTF-8 encoded file without decoding it
+     */
+    static std::string readUtf8File(const char* fileName);
     static std::vector<std::string> readDirectory(const char* path);
     static void dumpCompilerResults(const CompilerResults& compilerResults, std::wostream& out);
     static std::wstring toString(const NodePtr& node);
     static std::wstring toString(int i);
 
     /*!
-     * A simplified approach to convert std::string to std::wstring
+     * Convert UTF-8 encoded std::string to std::wstring
      */
     static std::wstring toWString(const std::string& str);
     /*!
-     * A simplified approach to convert std::wstring to std::string
+     * Convert std::wstring to UTF-8 encoded std::string
      */
     static std::string toString(const std::wstring& str);
 };
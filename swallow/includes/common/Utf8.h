@@ -0,0 +1,213 @@
+/* Utf8.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef UTF8_H
+#define UTF8_H
+#include "swallow_conf.h"
+#include <string>
+#include <cstddef>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * UTF-8 encoding and decoding helpers.
+ * Malformed sequences are decoded as U+FFFD and consume one byte, so decoding always
+ * makes progress and never reads beyond the end.
+ */
+struct Utf8
+{
+    static const unsigned ReplacementCharacter = 0xFFFD;
+
+    /*!
+     * Check if the byte is a continuation byte(10xxxxxx) of a multi-byte sequence
+     */
+    static inline bool isContinuation(unsigned char ch)
+    {
+        return (ch & 0xC0) == 0x80;
+    }
+
+    /*!
+     * Decode the code point at p and move p to the next one.
+     */
+    static inline unsigned decode(const char*& p, const char* end)
+    {
+        const unsigned char* s = (const unsigned char*)p;
+        unsigned ch = s[0];
+        if(ch < 0x80)
+        {
+            p++;
+            return ch;
+        }
+        int length;
+        unsigned min;
+        if(ch >= 0xC2 && ch <= 0xDF)
+        {
+            length = 2;
+            min = 0x80;
+            ch &= 0x1F;
+        }
+        else if(ch >= 0xE0 && ch <= 0xEF)
+        {
+            length = 3;
+            min = 0x800;
+            ch &= 0x0F;
+        }
+        else if(ch >= 0xF0 && ch <= 0xF4)
+        {
+            length = 4;
+            min = 0x10000;
+            ch &= 0x07;
+        }
+        else
+        {
+            p++;
+            return ReplacementCharacter;
+        }
+        if(end - p < length)
+        {
+            p++;
+            return ReplacementCharacter;
+        }
+        for(int i = 1; i < length; i++)
+        {
+            if(!isContinuation(s[i]))
+            {
+                p++;
+                return ReplacementCharacter;
+            }
+            ch = (ch << 6) | (s[i] & 0x3F);
+        }
+        //overlong forms, surrogates and code points beyond U+10FFFF are malformed
+        if(ch < min || ch > 0x10FFFF || (ch >= 0xD800 && ch <= 0xDFFF))
+        {
+            p++;
+            return ReplacementCharacter;
+        }
+        p += length;
+        return ch;
+    }
+
+    /*!
+     * Decode the code point that ends right before p, p will be moved to its first byte.
+     * begin is the start of the buffer.
+     */
+    static inline unsigned decodeBackward(const char*& p, const char* begin)
+    {
+        const char* start = p - 1;
+        //a code point has at most 3 continuation bytes
+        while(start > begin && p - start < 4 && isContinuation(*start))
+            start--;
+        const char* q = start;
+        unsigned ch = decode(q, p);
+        if(q != p)
+        {
+            //not a complete sequence, the last byte is decoded on its own
+            start = p - 1;
+            ch = ReplacementCharacter;
+        }
+        p = start;
+        return ch;
+    }
+
+    /*!
+     * Number of code points in given range
+     */
+    static inline size_t length(const char* p, const char* end)
+    {
+        size_t ret = 0;
+        while(p < end)
+        {
+            decode(p, end);
+            ret++;
+        }
+        return ret;
+    }
+
+    /*!
+     * Decode given range and append the code points to out
+     */
+    static inline void append(std::wstring& out, const char* p, const char* end)
+    {
+        while(p < end)
+        {
+            if((unsigned char)*p < 0x80)
+                out.push_back(*p++);
+            else
+                out.push_back((wchar_t)decode(p, end));
+        }
+    }
+
+    /*!
+     * Encode the code point and append it to out
+     */
+    static inline void append(std::string& out, unsigned ch)
+    {
+        if(ch < 0x80)
+            out.push_back((char)ch);
+        else if(ch < 0x800)
+        {
+            out.push_back((char)(0xC0 | (ch >> 6)));
+            out.push_back((char)(0x80 | (ch & 0x3F)));
+        }
+        else if(ch < 0x10000)
+        {
+            out.push_back((char)(0xE0 | (ch >> 12)));
+            out.push_back((char)(0x80 | ((ch >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (ch & 0x3F)));
+        }
+        else
+        {
+            out.push_back((char)(0xF0 | (ch >> 18)));
+            out.push_back((char)(0x80 | ((ch >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((ch >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (ch & 0x3F)));
+        }
+    }
+
+    static inline std::wstring decode(const std::string& str)
+    {
+        std::wstring ret;
+        ret.reserve(str.size());
+        append(ret, str.data(), str.data() + str.size());
+        return ret;
+    }
+
+    static inline std::string encode(const std::wstring& str)
+    {
+        std::string ret;
+        ret.reserve(str.size());
+        for(size_t i = 0; i < str.size(); i++)
+            append(ret, (unsigned)str[i]);
+        return ret;
+    }
+};
+
+SWALLOW_NS_END
+
+#endif//UTF8_H
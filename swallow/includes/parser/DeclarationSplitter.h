@@ -0,0 +1,69 @@
+/* DeclarationSplitter.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef DECLARATION_SPLITTER_H
+#define DECLARATION_SPLITTER_H
+#include "swallow_conf.h"
+#include <memory>
+#include <vector>
+
+SWALLOW_NS_BEGIN
+
+typedef std::shared_ptr<struct SourceFile> SourceFilePtr;
+class Tokenizer;
+
+/*!
+ * Split a source file into chunks of top-level statements that can be parsed independently.
+ * The code is tokenized once with brace/parenthesis depth tracking, a chunk begins at a
+ * declaration keyword or attribute at the start of a line, right after a top-level '}'.
+ * The skipped comments are recorded in the source file, so parsers of the chunks don't need to.
+ */
+class SWALLOW_EXPORT DeclarationSplitter
+{
+public:
+    DeclarationSplitter();
+public:
+    void setSourceFile(const SourceFilePtr& sourceFile);
+    /*!
+     * Split the code into chunks of at least given size, offsets where the chunks begin
+     * are returned, the first one is always 0.
+     * Returns false if the code cannot be tokenized, it should be parsed as a whole then.
+     */
+    bool split(const wchar_t* code, size_t size, size_t chunkSize, std::vector<int>& chunks);
+    bool split(const char* code, size_t size, size_t chunkSize, std::vector<int>& chunks);
+private:
+    template<class T>
+    bool split(Tokenizer& tokenizer, const T* code, size_t chunkSize, std::vector<int>& chunks);
+private:
+    SourceFilePtr sourceFile;
+};
+
+SWALLOW_NS_END
+
+#endif//DECLARATION_SPLITTER_H
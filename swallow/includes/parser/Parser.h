@@ -32,6 +32,8 @@
 #include "swallow_conf.h"
 #include "tokenizer/Token.h"
 #include <string>
+#include <map>
+#include <unordered_map>
 #include "ast/ast-decl.h"
 
 SWALLOW_NS_BEGIN
@@ -39,11 +41,50 @@ SWALLOW_NS_BEGIN
 class Tokenizer;
 class NodeFactory;
 class CompilerResults;
+class SymbolRegistry;
+class ParserProfile;
+class LiteralColumns;
 
 typedef std::shared_ptr<struct SourceFile> SourceFilePtr;
+typedef std::shared_ptr<class CodeBlockLoader> CodeBlockLoaderPtr;
+typedef std::shared_ptr<class StringPool> StringPoolPtr;
+
+/*!
+ * Token statistics collected during parsing
+ */
+struct ParserStatistics
+{
+    /*!
+     * Number of tokens read from tokenizer, comments included
+     */
+    int tokensLexed;
+    /*!
+     * Number of tokens requested by parser through next/peek/match
+     */
+    int tokensRequested;
+    /*!
+     * Number of requests that served by the lookahead buffer without lexing
+     */
+    int lookaheadHits;
+    /*!
+     * Number of tokens scanned to tell a generic argument clause from a less-than operator
+     */
+    int genericLookaheadTokens;
+    /*!
+     * Number of statements and declarations skipped because of syntax errors
+     */
+    int errorsRecovered;
+    /*!
+     * Number of statements and declarations parsed after the first recovered error,
+     * they would be lost without error recovery
+     */
+    int statementsRecovered;
+};
+
 class SWALLOW_EXPORT Parser
 {
     friend struct Flags;
+    friend class LazyBodyLoader;
 public:
     Parser(NodeFactory* nodeFactory, CompilerResults* compilerResults);
     ~Parser();
@@ -51,11 +92,49 @@ public:
     NodePtr parseStatement(const wchar_t* code);
     ProgramPtr parse(const wchar_t* code);
     bool parse(const wchar_t* code, const ProgramPtr& program);
+    /*!
+     * Parse the code of given size into program, the code is not copied and
+     * doesn't need to be zero-terminated.
+     */
+    bool parse(const wchar_t* code, size_t size, const ProgramPtr& program);
+    /*!
+     * Parse UTF-8 encoded code of given size into program, the code is lexed directly
+     * without being widened, node positions are byte offsets into it.
+     */
+    bool parse(const char* code, size_t size, const ProgramPtr& program);
+    /*!
+     * Parse the top-level statements in [begin, end) of the source file's code into program,
+     * it's used to parse chunks found by DeclarationSplitter in parallel.
+     * Comments are not recorded, and the line starts of the code should be already indexed
+     * so the source file is only read.
+     */
+    bool parseChunk(const wchar_t* code, int begin, int end, const ProgramPtr& program);
+    bool parseChunk(const char* code, int begin, int end, const ProgramPtr& program);
     void setSourceFile(const SourceFilePtr& sourceFile);
+    /*!
+     * Prepare the parser for a new input of given source file, errors of following parses are
+     * reported to given results. The tokenizer, lookahead buffer and scratch vectors are kept,
+     * so a parser can be reused for many small inputs like the lines of REPL.
+     */
+    void reset(const SourceFilePtr& sourceFile, CompilerResults* compilerResults);
     void setFunctionName(const wchar_t* function);
+    /*!
+     * Binary expressions are built in precedence order by looking up the infix operators
+     * in the global scope of given registry and the operators declared earlier in current
+     * file, OperatorResolver doesn't need to rotate them.
+     * The expressions are built left-leaning if no registry is set.
+     */
+    void setSymbolRegistry(SymbolRegistry* registry);
+    /*!
+     * Collect per-production counters into given profile, it only works when the library
+     * is built with PARSER_PROFILE defined.
+     */
+    void setProfile(ParserProfile* profile);
 
     int getFlags() const;
     void setFlags(int flags);
+
+    const ParserStatistics& getStatistics() const;
 private:
     TypeNodePtr parseType();
     TypeNodePtr parseTypeAnnotation();
@@ -86,6 +165,46 @@ private://statement
     ExpressionPtr parseConditionExpression();
     
     CodeBlockPtr parseCodeBlock();
+    /*!
+     * Parse the code block of a function, initializer or accessor, the statements are
+     * skipped in SKIP_BODIES mode
+     */
+    CodeBlockPtr parseFunctionBody();
+    /*!
+     * Skip the statements until the '}' that closes current block by matching braces,
+     * the '}' is not consumed. The statements are parsed when the block is first accessed.
+     */
+    void skipStatements(const CodeBlockPtr& block);
+    /*!
+     * Parse the skipped statements into the block, the parser must work on the code
+     * that the statements were skipped from.
+     */
+    void parseLazyBody(CodeBlock* block, const CodeBlockLoaderPtr& loader);
+    /*!
+     * Stop the bodies skipped so far from being loaded, the loader borrows this parser's
+     * node factory and compiler results which may not outlive it.
+     */
+    void detachBodyLoader();
+    /*!
+     * Parse a statement, in RECOVER_ERRORS mode a statement that has syntax error is
+     * skipped and an ErrorStatement is returned instead.
+     */
+    StatementPtr parseRecoverableStatement();
+    /*!
+     * Parse a declaration of type body, in RECOVER_ERRORS mode a declaration that has
+     * syntax error is skipped and NULL is returned.
+     */
+    DeclarationPtr parseRecoverableDeclaration();
+    /*!
+     * Skip the tokens of a broken statement that begins at given state, until a ';', the '}'
+     * that closes current block or a new line outside of brackets.
+     * Returns NULL if nothing can be skipped.
+     */
+    ErrorStatementPtr skipBrokenStatement(const TokenizerState& begin);
+    /*!
+     * Check if there's a line break between given offsets of current code
+     */
+    bool hasLineBreak(int begin, int end) const;
 private://pattern
     PatternPtr parsePattern();
     PatternPtr parseTuple();
@@ -133,6 +252,16 @@ private://expression
     ExpressionPtr parseString();
     ExpressionPtr parseExpression();
     ExpressionPtr parseBinaryExpression(const ExpressionPtr& lhs);
+    /*!
+     * Parse the binary expressions after lhs by precedence climbing, the expression
+     * falls back to left-leaning after the first unknown operator
+     */
+    ExpressionPtr parseSortedExpression(const ExpressionPtr& lhs);
+    /*!
+     * Find the precedence and associativity of an infix operator, return false if
+     * the operator is unknown
+     */
+    bool getInfixOperator(int symbol, int& precedence, Associativity::T& associativity);
     ExpressionPtr parsePrefixExpression();
     ExpressionPtr parsePostfixExpression();
     FunctionCallPtr parseFunctionCallExpression();
@@ -141,6 +270,12 @@ private://expression
     ParenthesizedExpressionPtr parseParenthesizedExpression();
     void parseExpressionItem(const ParenthesizedExpressionPtr& parent);
     ExpressionPtr parseLiteral();
+    /*!
+     * Consume a plain literal(integer, float, non-interpolated string) that makes up a whole
+     * element of collection literal, return false and consume nothing if it's not the case.
+     */
+    bool parsePlainLiteral(Token& token, bool dictionaryKey);
+    void appendLiteral(LiteralColumns& columns, const Token& token);
     
     ExpressionPtr parseSelfExpression();
     ExpressionPtr parseSuperExpression();
@@ -168,6 +303,32 @@ private:
      * Peek next token from tokenizer, return false if EOF reached.
      */
     bool peek(Token& token);
+    /*!
+     * Read next non-comment token, the lookahead buffer will be checked before lexing
+     */
+    bool readToken(Token& token);
+    /*!
+     * Put a lexed token into the lookahead buffer, keyed by the cursor it was requested from
+     */
+    void storeToken(int cursor, const Token& token, const TokenizerState& end);
+    /*!
+     * Reset the tokenizer with given code and drop all buffered tokens,
+     * the tokenizer works directly on the code without copying it.
+     */
+    void reset(const wchar_t* code, size_t size);
+    void reset(const char* code, size_t size);
+    void resetLookahead();
+    void dropLookahead();
+    /*!
+     * Intern identifiers and operators through a front of the registry's string pool,
+     * or the node factory's if there's no registry
+     */
+    void bindStringPool();
+    /*!
+     * Parse all statements of current code into program
+     */
+    bool parseStatements(const ProgramPtr& program);
+    bool parseChunk(int begin, const ProgramPtr& program);
     /*!
      * Check if the following token is an identifier, throw exception if not matched
      */
@@ -209,8 +370,87 @@ private:
     void tassert(Token& token, bool cond, int errorCode);
     void tassert(Token& token, bool cond, int errorCode, const std::wstring& s);
     void error(Token& token, int errorCode, const std::vector<std::wstring>& s);
+private:
+    /*!
+     * A token that already lexed from given cursor, and the tokenizer's state after reading it.
+     */
+    struct LookaheadSlot
+    {
+        /*!
+         * The slot is valid only if it's stored in current generation
+         */
+        unsigned generation;
+        bool contextSensitive;
+        int cursor;
+        Token token;
+        TokenizerState end;
+    };
+    /*!
+     * Cached result of isGenericArgument for the '<' at given offset
+     */
+    struct GenericArgumentVerdict
+    {
+        unsigned generation;
+        int offset;
+        bool generic;
+    };
+    /*!
+     * An infix operator declared in current file
+     */
+    struct InfixOperator
+    {
+        int precedence;
+        Associativity::T associativity;
+    };
+    typedef std::unordered_map<int, InfixOperator> InfixOperatorMap;
+    enum
+    {
+        /*!
+         * Number of slots in lookahead buffer, must be power of 2
+         */
+        LOOKAHEAD_SIZE = 256,
+        /*!
+         * Number of cached generic argument verdicts, must be power of 2
+         */
+        GENERIC_VERDICT_SIZE = 64,
+        /*!
+         * Maximum tokens to scan for the closing '>' of a generic argument clause
+         */
+        MAX_GENERIC_ARGUMENT_TOKENS = 64
+    };
 private:
     Tokenizer* tokenizer;
+    std::vector<LookaheadSlot> lookahead;
+    std::vector<GenericArgumentVerdict> genericVerdicts;
+    /*!
+     * Generation of the lookahead buffer and generic verdicts, all of them are dropped by
+     * starting a new generation
+     */
+    unsigned generation;
+    /*!
+     * Scratch stacks of parseSortedExpression, each call works above the size they had
+     * when it began
+     */
+    std::vector<BinaryOperatorPtr> incompleteOperators;
+    std::vector<BinaryOperatorPtr> sortedOperators;
+    /*!
+     * The code that tokenizer is working on, only one of code and utf8 is set
+     */
+    const wchar_t* code;
+    const char* utf8;
+    size_t codeSize;
+    /*!
+     * Loader of the bodies skipped from current code, created on the first skipped body
+     */
+    CodeBlockLoaderPtr bodyLoader;
+    SymbolRegistry* symbolRegistry;
+    /*!
+     * Front of the shared string pool, keys of fileOperators are ids in it
+     */
+    StringPoolPtr stringPool;
+    InfixOperatorMap fileOperators;
+    ParserProfile* profile;
+    ParserStatistics statistics;
     NodeFactory* nodeFactory;
     CompilerResults* compilerResults;
     SourceFilePtr sourceFile;
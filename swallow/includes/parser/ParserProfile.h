@@ -0,0 +1,178 @@
+/* ParserProfile.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PARSER_PROFILE_H
+#define PARSER_PROFILE_H
+#include "swallow_conf.h"
+#include <vector>
+#include <iostream>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * Counters of a production, the time, tokens, allocations and backtracks are collected
+ * only by the outermost call, nested calls of the same production are not counted twice.
+ */
+struct ProductionCounters
+{
+    int calls;
+    /*!
+     * Nanoseconds spent in the production, nested productions included
+     */
+    long long inclusiveTime;
+    /*!
+     * Tokens read by next(), the tokens read again after backtracking are counted again
+     */
+    int tokens;
+    /*!
+     * Number of AST nodes created
+     */
+    int allocations;
+    /*!
+     * Number of restore() calls
+     */
+    int backtracks;
+    /*!
+     * Number of active calls of the production
+     */
+    int depth;
+};
+
+/*!
+ * Per-production profile of parser methods, the methods are instrumented only when the library
+ * is built with PARSER_PROFILE defined, the profile stays empty otherwise.
+ */
+class SWALLOW_EXPORT ParserProfile
+{
+public:
+    ParserProfile();
+public:
+    /*!
+     * Check if the parser methods are instrumented in this build
+     */
+    static bool isEnabled();
+    /*!
+     * Get the id of the production by name, the ids are shared by all profiles
+     */
+    static int getProductionId(const char* name);
+    static const char* getProductionName(int id);
+    /*!
+     * Count an AST node created in current thread
+     */
+    static void countAllocation();
+    /*!
+     * Nanoseconds elapsed since an unspecified point
+     */
+    static long long now();
+public:
+    void clear();
+    /*!
+     * Add the counters of another profile to this one
+     */
+    void add(const ParserProfile& profile);
+    int numProductions() const;
+    const ProductionCounters& getCounters(int id) const;
+    /*!
+     * Dump the productions that were called as a table sorted by inclusive time,
+     * at most maxRows rows are dumped if maxRows is positive
+     */
+    void dump(std::ostream& out, int maxRows = 0) const;
+    void dumpJSON(std::ostream& out) const;
+public:
+    /*!
+     * Called when entering and leaving a production
+     */
+    ProductionCounters& enter(int id);
+    ProductionCounters& leave(int id);
+    int getAllocations() const;
+public:
+    /*!
+     * Tokens read and restore() calls by the parser so far
+     */
+    int tokens;
+    int backtracks;
+private:
+    std::vector<ProductionCounters> counters;
+};
+
+#ifdef PARSER_PROFILE
+/*!
+ * Record a call of parser production during the scope
+ */
+struct ProductionScope
+{
+    ProductionScope(ParserProfile* profile, int id)
+        :profile(profile), id(id)
+    {
+        if(!profile)
+            return;
+        ProductionCounters& c = profile->enter(id);
+        outermost = c.depth == 1;
+        if(outermost)
+        {
+            tokens = profile->tokens;
+            backtracks = profile->backtracks;
+            allocations = profile->getAllocations();
+            begin = ParserProfile::now();
+        }
+    }
+    ~ProductionScope()
+    {
+        if(!profile)
+            return;
+        ProductionCounters& c = profile->leave(id);
+        if(outermost)
+        {
+            c.inclusiveTime += ParserProfile::now() - begin;
+            c.tokens += profile->tokens - tokens;
+            c.backtracks += profile->backtracks - backtracks;
+            c.allocations += profile->getAllocations() - allocations;
+        }
+    }
+    ParserProfile* profile;
+    int id;
+    bool outermost;
+    int tokens;
+    int backtracks;
+    int allocations;
+    long long begin;
+};
+#define PROFILE_PRODUCTION() static const int production_id_ = ParserProfile::getProductionId(__FUNCTION__); \
+    ProductionScope production_scope_(profile, production_id_)
+#define PROFILE_TOKEN() do { if(profile) profile->tokens++; } while(0)
+#define PROFILE_BACKTRACK() do { if(profile) profile->backtracks++; } while(0)
+#else
+#define PROFILE_PRODUCTION()
+#define PROFILE_TOKEN() do {} while(0)
+#define PROFILE_BACKTRACK() do {} while(0)
+#endif//PARSER_PROFILE
+
+SWALLOW_NS_END
+
+#endif//PARSER_PROFILE_H
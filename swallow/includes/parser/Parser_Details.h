@@ -31,6 +31,7 @@
 #define PARSER_DETAILS_H
 #include "swallow_conf.h"
 #include "common/ScopedValue.h"
+#include <vector>
 SWALLOW_NS_BEGIN
 
 enum
@@ -51,7 +52,18 @@ enum
     SUPPRESS_TRAILING_CLOSURE = 0x2000,
     UNDER_EXTENSION     = 0x4000,
     DECLARATION_ONLY    = 0x8000,
-    FUNCTION_SIGNATURE  = 0x10000
+    FUNCTION_SIGNATURE  = 0x10000,
+    /*!
+     * Skip the bodies of functions, initializers and accessors by matching braces,
+     * the statements are parsed when the code block is first accessed, which must happen
+     * before the parser is reset or destroyed
+     */
+    SKIP_BODIES         = 0x20000,
+    /*!
+     * Skip the statement or declaration that has syntax error and continue with the next one,
+     * the skipped statement is replaced by an ErrorStatement
+     */
+    RECOVER_ERRORS      = 0x40000
 };
 class Parser;
 struct Flags
@@ -94,6 +106,26 @@ struct Flags
     int flags;
 };
 
+/*!
+ * A frame of a scratch stack shared by recursive calls, the elements pushed
+ * during the frame are removed when it ends
+ */
+template<class T>
+struct ScratchFrame
+{
+    ScratchFrame(std::vector<T>& stack)
+        :stack(stack), base(stack.size())
+    {
+    }
+    ~ScratchFrame()
+    {
+        stack.erase(stack.begin() + base, stack.end());
+    }
+    bool empty() const { return stack.size() == base;}
+    std::vector<T>& stack;
+    size_t base;
+};
+
 #define ENTER_CONTEXT(ctx) TokenizerState& state_##__LINE__ = tokenizer->save(); SCOPED_SET(state_##__LINE__.context, ctx);
 
 
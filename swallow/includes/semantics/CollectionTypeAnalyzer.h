@@ -30,6 +30,7 @@
 #ifndef COLLECTION_TYPE_ANALYZER_H
 #define COLLECTION_TYPE_ANALYZER_H
 #include "swallow_conf.h"
+#include "ast/Node.h"
 #include <string>
 #include <vector>
 
@@ -47,6 +48,10 @@ public:
     CollectionTypeAnalyzer(const TypePtr& contextualType, GlobalScope* global);
 public:
     void analyze(const ExpressionPtr& expr);
+    /*!
+     * Analyze an expression by its node type and type, used by plain literals that have no node
+     */
+    void analyze(NodeType::T nodeType, const TypePtr& exprType);
 public:
     TypePtr finalType;
     int differentTypes;
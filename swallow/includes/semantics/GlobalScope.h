@@ -36,7 +36,7 @@ SWALLOW_NS_BEGIN
 class SWALLOW_EXPORT GlobalScope : public SymbolScope
 {
 public:
-    GlobalScope();
+    GlobalScope(const StringPoolPtr& stringPool);
 public:
     void initRuntime(SymbolRegistry* symbolRegistry);
 private:
@@ -66,19 +66,28 @@ public:
     virtual void visitCase(const CaseStatementPtr& node) override;
 
 public:
+    /*!
+     * Sort the operators and their operands, the new root is returned.
+     */
     OperatorPtr sortExpression(const OperatorPtr& op);
     bool rotateRequired(const OperatorPtr& lhs, const OperatorPtr& rhs);
 private:
+    /*!
+     * Check if the node is a binary operator that can be rotated, type-casting operators included
+     */
+    static bool isRotatable(const PatternPtr& node);
+    static bool isTypeCasting(const BinaryOperatorPtr& node);
+
     template<class T, typename Ptr = std::shared_ptr<T>>
     Ptr transform(const Ptr& ptr)
     {
         if(!ptr)
             return nullptr;
-        std::static_pointer_cast<Node>(ptr)->accept(this);
         if(OperatorPtr op = std::dynamic_pointer_cast<Operator>(ptr))
         {
             return std::static_pointer_cast<T>(sortExpression(op));
         }
+        std::static_pointer_cast<Node>(ptr)->accept(this);
         return ptr;
     }
 };
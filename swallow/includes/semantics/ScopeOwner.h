@@ -30,10 +30,12 @@
 #ifndef SCOPE_OWNER_H
 #define SCOPE_OWNER_H
 #include "swallow_conf.h"
+#include <memory>
 
 SWALLOW_NS_BEGIN
 
 class SymbolScope;
+typedef std::shared_ptr<class StringPool> StringPoolPtr;
 class SWALLOW_EXPORT ScopeOwner
 {
 protected:
@@ -41,9 +43,14 @@ protected:
     virtual ~ScopeOwner();
 public:
     SymbolScope* getScope();
+    /*!
+     * The string pool that the scope interns its names in, it's set by the node factory
+     */
+    void setStringPool(const StringPoolPtr& pool);
 
 protected:
     SymbolScope* symbolScope;
+    StringPoolPtr stringPool;
 };
 
 
@@ -48,6 +48,14 @@ public:
     virtual InitializerDefPtr createInitializer(const SourceInfo& state) override;
     virtual DeinitializerDefPtr createDeinitializer(const SourceInfo& state) override;
     virtual ComputedPropertyPtr createComputedProperty(const SourceInfo& state) override;
+private:
+    template<class T>
+    inline std::shared_ptr<T> createScoped(const SourceInfo& s)
+    {
+        std::shared_ptr<T> ret = create<T>(s);
+        ret->setStringPool(stringPool);
+        return ret;
+    }
 
 };
 
@@ -34,6 +34,7 @@
 #include <list>
 #include "SemanticContext.h"
 #include "SymbolScope.h"
+#include "ast/Node.h"
 
 SWALLOW_NS_BEGIN
 
@@ -41,6 +42,8 @@ class TypeDeclaration;
 class Expression;
 class Pattern;
 class NodeFactory;
+class LiteralColumns;
+class CollectionTypeAnalyzer;
 struct TupleExtractionResult
 {
     IdentifierPtr name;
@@ -193,6 +196,16 @@ private:
      * Check if the given expression can be converted to given type
      */
     bool canConvertTo(const ExpressionPtr&, const TypePtr& type);
+    bool canConvertTo(NodeType::T nodeType, const TypePtr& exprType, const TypePtr& type);
+    /*!
+     * Type of a plain literal under current contextual type, the length is only used by string literal
+     */
+    TypePtr getLiteralType(NodeType::T nodeType, size_t length);
+    /*!
+     * Analyze the plain literals stored in columns without creating their nodes, returns false
+     * if there's an error, the nodes are needed to report it
+     */
+    bool analyzeLiterals(const LiteralColumns& literals, CollectionTypeAnalyzer& analyzer);
 
     bool isInteger(const TypePtr& type);
     bool isNumber(const TypePtr& type);
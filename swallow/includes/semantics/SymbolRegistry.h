@@ -54,6 +54,10 @@ public:
 
     OperatorInfo* getOperator(const std::wstring& name, int typeMask);
     OperatorInfo* getOperator(SymbolScope* scope, const std::wstring& name, int typeMask);
+    /*!
+     * Get an operator of given scope by the id of its name in the registry's string pool
+     */
+    OperatorInfo* getOperator(SymbolScope* scope, int symbol, int typeMask);
 
     bool isPrefixOperator(const std::wstring& name);
     bool isPostfixOperator(const std::wstring& name);
@@ -79,6 +83,11 @@ public:
      */
     bool lookupSymbol(SymbolScope* scope, const std::wstring& name, SymbolScope** container, SymbolPtr* ret, bool lazyResolve = true);
     bool lookupSymbol(const std::wstring& name, SymbolScope** scope, SymbolPtr* ret, bool lazyResolve = true);
+    /*!
+     * Lookup symbol by the id of its name in the registry's string pool
+     */
+    bool lookupSymbol(SymbolScope* scope, int symbol, SymbolScope** container, SymbolPtr* ret, bool lazyResolve = true);
+    bool lookupSymbol(int symbol, SymbolScope** scope, SymbolPtr* ret, bool lazyResolve = true);
     SymbolPtr lookupSymbol(const std::wstring& name);
 
     /*!
@@ -86,10 +95,17 @@ public:
      */
     bool isSymbolDefined(const std::wstring& name) const;
 
+    /*!
+     * The string pool of the compilation, names of global scope and file scope are interned in it,
+     * and so are the identifiers and operators parsed with this registry
+     */
+    const StringPoolPtr& getStringPool() const;
+
 public:
     void enterScope(SymbolScope* scope);
     void leaveScope();
 private:
+    StringPoolPtr stringPool;
     std::stack<SymbolScope*> scopes;
     SymbolScope* currentScope;
     GlobalScope* globalScope;
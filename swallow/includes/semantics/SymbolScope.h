@@ -31,6 +31,7 @@
 #define SYMBOL_SCOPE_H
 #include "swallow_conf.h"
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include "semantic-types.h"
 #include "swallow_types.h"
@@ -40,6 +41,7 @@
 SWALLOW_NS_BEGIN
 
 class Node;
+typedef std::shared_ptr<class StringPool> StringPoolPtr;
 
 struct OperatorInfo
 {
@@ -79,10 +81,13 @@ class SWALLOW_EXPORT SymbolScope
     friend class SymbolRegistry;
     friend class ScopeOwner;
 public:
-    typedef std::map<std::wstring, OperatorInfo> OperatorMap;
-    typedef std::map<std::wstring, SymbolPtr> SymbolMap;
+    /*!
+     * Operators and symbols are keyed by the id of their name in the scope's string pool
+     */
+    typedef std::unordered_map<int, OperatorInfo> OperatorMap;
+    typedef std::unordered_map<int, SymbolPtr> SymbolMap;
 public:
-    SymbolScope();
+    SymbolScope(const StringPoolPtr& stringPool);
     ~SymbolScope();
 public:
     void removeSymbol(const SymbolPtr& symbol);
@@ -95,15 +100,24 @@ public:
      * will try to use lazySymbolResolver to declare it
      */
     SymbolPtr lookup(const std::wstring& name, bool lazyResolve = true);
+    /*!
+     * Lookup for a symbol by the id of its name in the scope's string pool
+     */
+    SymbolPtr lookup(int symbol, bool lazyResolve = true);
     /*!
      * Check if symbol is defined.
      * This will not use lazySymbolResolver to declare it
      */
     bool isSymbolDefined(const std::wstring& name);
+    bool isSymbolDefined(int symbol);
 
     Node* getOwner();
     SymbolScope* getParentScope() {return parent;}
     const SymbolMap& getSymbols() {return symbols;}
+    /*!
+     * The string pool that names of this scope are interned in
+     */
+    const StringPoolPtr& getStringPool() const {return stringPool;}
 
     /*!
      * If SymbolScope failed to look-up a symbol, it will try to use LazySymbolResolver to find it
@@ -131,14 +145,15 @@ public:
      */
     TypePtr getForwardDeclaration(const std::wstring& name);
 protected:
+    StringPoolPtr stringPool;
     OperatorMap operators;
     Node* owner;
     SymbolScope* parent;
     SymbolMap symbols;
     LazySymbolResolver* lazySymbolResolver;
-    std::map<std::wstring, std::vector<TypePtr>> extensions;
+    std::unordered_map<int, std::vector<TypePtr>> extensions;
 
-    std::map<std::wstring, TypePtr> forwardDeclarations;
+    std::unordered_map<int, TypePtr> forwardDeclarations;
 };
 
 
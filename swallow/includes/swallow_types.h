@@ -30,8 +30,11 @@
 #ifndef SWALLOW_TYPES_H
 #define SWALLOW_TYPES_H
 #include "swallow_conf.h"
+#include "common/Utf8.h"
 #include <string>
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 SWALLOW_NS_BEGIN
 
@@ -242,24 +245,183 @@ struct DeclarationModifiers
     };
 };
 
+/*!
+ * A comment in source file, comments are kept out of the token stream and recorded as trivia
+ */
+struct CommentTrivia
+{
+    enum Kind
+    {
+        Line,       // comment
+        Block,      /* comment */
+        DocLine,    /// comment
+        DocBlock    /** comment */
+    };
+    /*!
+     * Offset of the comment's opening mark
+     */
+    int offset;
+    /*!
+     * Length in code units including the marks, the line feed after line comment is excluded
+     */
+    int length;
+    Kind kind;
+};
+
 struct SourceFile
 {
     std::wstring fileName;
     std::wstring code;
-    SourceFile(){}
+    /*!
+     * UTF-8 encoded code, offsets into this file are byte offsets when it's not empty.
+     * The wide code is only decoded from it when getCode() is called.
+     */
+    std::string utf8;
+    /*!
+     * Path of the UTF-8 file to load the code from, the file is only mapped while
+     * it's being parsed and neither code nor utf8 is filled.
+     */
+    std::string path;
+    /*!
+     * Id given by SourceManager when the file is added to a compilation, 0 if it's not added yet
+     */
+    int id;
+    SourceFile()
+            :id(0)
+    {}
     SourceFile(const std::wstring& fileName, const std::wstring& code)
-            :fileName(fileName), code(code)
+            :fileName(fileName), code(code), id(0)
+    {}
+    SourceFile(const std::wstring& fileName, const std::string& utf8)
+            :fileName(fileName), utf8(utf8), id(0)
     {}
+    bool isUtf8() const
+    {
+        return !utf8.empty();
+    }
+    /*!
+     * Record a comment found by tokenizer, a comment lexed again after backtracking is recorded only once
+     */
+    void addComment(int offset, int length, CommentTrivia::Kind kind)
+    {
+        CommentTrivia comment = {offset, length, kind};
+        if(comments.empty() || comments.back().offset < offset)
+        {
+            comments.push_back(comment);
+            return;
+        }
+        std::vector<CommentTrivia>::iterator iter = std::lower_bound(comments.begin(), comments.end(), comment, compareComment);
+        if(iter == comments.end() || iter->offset != offset)
+            comments.insert(iter, comment);
+    }
+    /*!
+     * Find the comments that begin in [begin, end), returns the first one or NULL and stores the number of comments to count
+     */
+    const CommentTrivia* findComments(int begin, int end, size_t& count) const
+    {
+        CommentTrivia key = {begin, 0, CommentTrivia::Line};
+        std::vector<CommentTrivia>::const_iterator first = std::lower_bound(comments.begin(), comments.end(), key, compareComment);
+        key.offset = end;
+        std::vector<CommentTrivia>::const_iterator last = std::lower_bound(first, comments.end(), key, compareComment);
+        count = last - first;
+        return count ? &*first : NULL;
+    }
+    /*!
+     * Returns the code as wide characters, decoded from the UTF-8 code if necessary.
+     * It's empty when the code is loaded from path.
+     */
+    const std::wstring& getCode()
+    {
+        if(code.empty() && !utf8.empty())
+        {
+            code.reserve(utf8.size());
+            Utf8::append(code, utf8.c_str(), utf8.c_str() + utf8.size());
+        }
+        return code;
+    }
+    /*!
+     * Build the line-start table from given text, used when the code was parsed
+     * from a buffer other than this->code.
+     */
+    template<class T>
+    void indexLines(const T* text, size_t size)
+    {
+        lineStarts.clear();
+        lineStarts.push_back(0);
+        continuationBytes.clear();
+        for(size_t i = 0; i < size; i++)
+        {
+            if(text[i] == '\n')
+                lineStarts.push_back((int)i + 1);
+            //UTF-8 continuation bytes are remembered so columns can be counted in
+            //characters without the text
+            else if(sizeof(T) == 1 && Utf8::isContinuation((unsigned char)text[i]))
+                continuationBytes.push_back((int)i);
+        }
+    }
+    /*!
+     * Resolve the 1-based line and column of given offset.
+     * The line-start table is built from code on first call.
+     */
+    void getPosition(int offset, int& line, int& column)
+    {
+        if(lineStarts.empty())
+        {
+            if(isUtf8())
+                indexLines(utf8.c_str(), utf8.size());
+            else
+                indexLines(code.c_str(), code.size());
+        }
+        std::vector<int>::const_iterator iter = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+        line = (int)(iter - lineStarts.begin());
+        column = offset - *(iter - 1) + 1;
+        if(!continuationBytes.empty())
+        {
+            //column counts characters, continuation bytes are skipped
+            column -= (int)(std::lower_bound(continuationBytes.begin(), continuationBytes.end(), offset)
+                    - std::lower_bound(continuationBytes.begin(), continuationBytes.end(), *(iter - 1)));
+        }
+    }
+public:
+    /*!
+     * Comments of the code ordered by offset, recorded when the code is parsed
+     */
+    std::vector<CommentTrivia> comments;
+private:
+    static bool compareComment(const CommentTrivia& a, const CommentTrivia& b)
+    {
+        return a.offset < b.offset;
+    }
+private:
+    /*!
+     * Offset of the first character of each line
+     */
+    std::vector<int> lineStarts;
+    /*!
+     * Offset of each UTF-8 continuation byte, empty for wide or ASCII code
+     */
+    std::vector<int> continuationBytes;
 };
 typedef std::shared_ptr<SourceFile> SourceFilePtr;
 
+/*!
+ * Position of a node or token, the line and column are resolved on demand from the offset.
+ * It's trivially copyable, the source file is referred by the id given by SourceManager
+ * so copying tokens and creating nodes never touch the file's reference count, the line
+ * and column are resolved by the SourceManager of the compilation.
+ */
 struct SourceInfo
 {
-    SourceFilePtr sourceFile;
-    int line;
-    int column;
+    /*!
+     * Id of the source file in SourceManager, 0 if there's no source file
+     */
+    int fileId;
+    /*!
+     * Offset in code units from the beginning of the source file
+     */
+    int offset;
     SourceInfo()
-    :sourceFile(nullptr), line(0), column(0)
+    :fileId(0), offset(0)
     {}
 };
 
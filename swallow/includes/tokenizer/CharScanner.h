@@ -0,0 +1,81 @@
+/* CharScanner.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef CHAR_SCANNER_H
+#define CHAR_SCANNER_H
+#include "swallow_conf.h"
+#include <cstddef>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * Block based scanners used by tokenizer to skip runs of characters.
+ * SSE2 or AVX2 is used when the compiler targets them(e.g. -mavx2), otherwise
+ * characters are checked one by one.
+ * All scanners return the first character that doesn't belong to the run, or end.
+ * The const char* overloads scan UTF-8 encoded code, multi-byte sequences are decoded
+ * only when they may belong to the run.
+ */
+struct SWALLOW_EXPORT CharScanner
+{
+    /*!
+     * Skip white spaces
+     */
+    static const wchar_t* skipWhitespace(const wchar_t* p, const wchar_t* end);
+    /*!
+     * Skip identifier characters
+     */
+    static const wchar_t* skipIdentifier(const wchar_t* p, const wchar_t* end);
+    /*!
+     * Find the next line feed
+     */
+    static const wchar_t* findLineFeed(const wchar_t* p, const wchar_t* end);
+    /*!
+     * Find the next '*' or '/', which may begin or end a multi-line comment
+     */
+    static const wchar_t* findCommentMark(const wchar_t* p, const wchar_t* end);
+    /*!
+     * Count line feeds in given range, lastLineFeed will be set to the last line feed found
+     */
+    static int countLines(const wchar_t* p, const wchar_t* end, const wchar_t*& lastLineFeed);
+
+    static const char* skipWhitespace(const char* p, const char* end);
+    static const char* skipIdentifier(const char* p, const char* end);
+    static const char* findLineFeed(const char* p, const char* end);
+    static const char* findCommentMark(const char* p, const char* end);
+    static int countLines(const char* p, const char* end, const char*& lastLineFeed);
+    /*!
+     * Name of the instruction set used by the scanners, "avx2", "sse2" or "scalar"
+     */
+    static const char* getInstructionSet();
+};
+
+SWALLOW_NS_END
+
+#endif//CHAR_SCANNER_H
@@ -0,0 +1,120 @@
+/* StreamTokenizer.h --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef STREAM_TOKENIZER_H
+#define STREAM_TOKENIZER_H
+#include "Tokenizer.h"
+#include <string>
+
+SWALLOW_NS_BEGIN
+
+/*!
+ * Tokenize UTF-8 code that arrives in chunks.
+ * Code is fed block by block, a token is returned as soon as following input can no
+ * longer change it, tokens and string interpolations may span chunk boundaries.
+ * Only the code after the last returned token is kept, so the whole input never needs
+ * to be resident at once.
+ * Offsets in returned tokens are counted from the beginning of the whole input.
+ */
+class SWALLOW_EXPORT StreamTokenizer
+{
+public:
+    StreamTokenizer();
+public:
+    /*!
+     * Append next chunk of UTF-8 encoded code
+     */
+    void feed(const char* data, size_t size);
+    /*!
+     * Append next chunk of code, it will be encoded as UTF-8
+     */
+    void feed(const std::wstring& data);
+    /*!
+     * Tells the tokenizer there's no more input, the remaining code will be tokenized
+     * as the end of the input.
+     */
+    void finish();
+    /*!
+     * Drop all buffered code and start a new input
+     */
+    void reset();
+    /*!
+     * Read next complete token, returns false if more input is needed or the end of input
+     * is reached. TokenizerError is only thrown after finish() is called, before that an
+     * error may be resolved by following input.
+     * Token::utf8 stays valid until next call to feed() or next().
+     */
+    bool next(Token& token);
+    /*!
+     * Check if the end of input is reached
+     */
+    bool isFinished() const;
+    /*!
+     * Check if buffered code contains an incomplete token, e.g. an unterminated comment
+     */
+    bool hasPendingToken() const;
+
+    void setContext(TokenizerContext context);
+    void setSourceFile(const SourceFilePtr& file);
+
+    /*!
+     * Resolve line and column of given offset, the offset should not be earlier than
+     * the last returned token.
+     */
+    void getPosition(int offset, int& line, int& column) const;
+private:
+    /*!
+     * Drop code that has been tokenized
+     */
+    void compact();
+private:
+    Tokenizer tokenizer;
+    /*!
+     * Code that hasn't been tokenized, with a few bytes before it for the operator rules
+     */
+    std::string buffer;
+    /*!
+     * Offset of the first byte of buffer in the whole input
+     */
+    int base;
+    /*!
+     * Tokenizer state relative to the buffer
+     */
+    TokenizerState state;
+    bool finished;
+    /*!
+     * Line feeds in the dropped code, and characters after the last of them
+     */
+    int droppedLines;
+    int droppedColumns;
+};
+
+SWALLOW_NS_END
+
+#endif//STREAM_TOKENIZER_H
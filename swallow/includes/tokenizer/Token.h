@@ -60,9 +60,11 @@ enum TokenizerContext
     TokenizerContextDeclaration = TokenizerContextFile | TokenizerContextClass | TokenizerContextFunctionBody,
     TokenizerContextAll = TokenizerContextFile | TokenizerContextOperator | TokenizerContextClass | TokenizerContextComputedProperty | TokenizerContextFunctionSignature | TokenizerContextCaptureList,
 };
+/*!
+ * The inherited offset is the tokenizer's cursor
+ */
 struct TokenizerState : SourceInfo
 {
-    int cursor;
     bool hasSpace;
     int inStringExpression;
     TokenizerContext context;
@@ -107,6 +109,18 @@ struct Token
     TokenType::T type;
     std::wstring token;
     size_t size;
+    /*!
+     * The source code of this token, points into the code that tokenizer is working on.
+     * Only one of text and utf8 is set depending on the code's encoding, length is
+     * measured in code units of that encoding.
+     */
+    const wchar_t* text;
+    const char* utf8;
+    size_t length;
+    /*!
+     * Id of identifier or operator in the tokenizer's string pool, 0 if it's not interned
+     */
+    int symbol;
     TokenizerState state;
     void append(wchar_t ch)
     {
@@ -36,9 +36,11 @@
 
 SWALLOW_NS_BEGIN
 
+class StringPool;
 
 struct TokenizerError
 {
+    int offset;
     int line;
     int column;
     int errorCode;
@@ -60,12 +62,33 @@ public:
     Tokenizer(const wchar_t* data);
     ~Tokenizer();
 public:
+    /*!
+     * Set the code to tokenize, the tokenizer will keep its own copy of the code
+     */
     void set(const wchar_t* data);
+    /*!
+     * Set the code to tokenize without copying it, the tokenizer lexes directly over
+     * given buffer, the buffer should be kept alive until the tokenizing is finished.
+     * The buffer doesn't need to be zero-terminated.
+     */
+    void setView(const wchar_t* data, size_t size);
+    /*!
+     * Set the UTF-8 encoded code to tokenize without copying or widening it.
+     * Offsets in token states are byte offsets in this mode, and tokens refer to their
+     * text by Token::utf8 instead of Token::text.
+     */
+    void setUtf8View(const char* data, size_t size);
     bool next(Token& token);
     bool peek(Token& token);
 
     const std::wstring& getKeyword(Keyword::T k);
 
+    /*!
+     * Find the keyword information of given identifier regardless of the context,
+     * return nullptr if it's not a keyword
+     */
+    static const KeywordInfo* findKeyword(const wchar_t* identifier, size_t length);
+
     /*!
      * Save current state for restoring later
      */
@@ -84,47 +107,96 @@ public:
      */
     void setContext(TokenizerContext context);
 
+    /*!
+     * Check if the token would be lexed differently when tokenizer is in another context
+     */
+    bool isContextSensitive(const Token& token) const;
+
     /*!
      * Tells the tokenizer the current file
      */
     void setSourceFile(const SourceFilePtr& file);
+
+    /*!
+     * Tells the tokenizer where to intern identifiers and operators, they're not interned if it's NULL
+     */
+    void setStringPool(StringPool* pool);
+
+    /*!
+     * When enabled comments are not returned as tokens, they are skipped without building
+     * their text and recorded in the source file's comment table
+     */
+    void setSkipComments(bool skip);
+    /*!
+     * Whether skipped comments are recorded in the source file, it's disabled when
+     * the comments are already recorded and the source file is shared by multiple threads
+     */
+    void setRecordComments(bool record);
+
+    /*!
+     * Resolve line and column of given offset in the code being tokenized
+     */
+    void getPosition(int offset, int& line, int& column) const;
 private:
     bool nextImpl(Token& token);
     void resetToken(Token& token);
     bool skipSpaces();
+    bool skipComment();
+    void advance(const wchar_t* to);
+    void advance(const char* to);
     bool get(wchar_t &ch);
     void unget();
     bool peek(wchar_t &ch);
+    wchar_t charAt(int offset) const;
+    wchar_t charBefore(int offset) const;
     
     wchar_t must_get();
     void match(wchar_t ch);
     
     
-    bool hasWhiteLeft(const wchar_t* cursor);
-    bool hasWhiteRight(const wchar_t* cursor);
-    OperatorType::T calculateOperatorType(const wchar_t* begin, const wchar_t* end);
+    bool hasWhiteLeft(int offset);
+    bool hasWhiteRight(int offset);
+    OperatorType::T calculateOperatorType(int begin, int end);
     
     bool readSymbol(Token& token, TokenType::T type);
     bool readOperator(Token& token, bool dotOperator, int max);
     bool readComment(Token& token);
     bool readMultilineComment(Token& token);
+    template<class T>
+    const T* readComment(Token& token, const T* begin, const T* end);
     bool readString(Token& token);
     bool readNumber(Token& token);
     bool readNumberLiteral(Token& token, int base, int64_t& out);
     bool readFraction(Token& token, int base, double& out);
     bool readIdentifier(Token& token);
 
-    KeywordInfo* getKeyword(const std::wstring& identifier);
+    const KeywordInfo* getKeyword(const std::wstring& identifier);
 private:
     void error(int errorCode, const std::wstring& str = L"");
 private:
-    wchar_t* data;
+    /*!
+     * The copy of the code owned by this tokenizer, or NULL if the code is borrowed
+     */
+    wchar_t* buffer;
+    const wchar_t* data;
     const wchar_t* end;
+    /*!
+     * The UTF-8 code being tokenized, or NULL if the code is wide characters
+     */
+    const char* utf8;
+    const char* utf8End;
+    /*!
+     * Size of the code in code units, bytes for UTF-8 code
+     */
     size_t size;
+    bool skipComments;
+    bool recordComments;
+    /*!
+     * The file that comments are recorded to
+     */
+    SourceFilePtr sourceFile;
+    StringPool* stringPool;
     TokenizerState state;
-    int positions[16];
-    std::map<std::wstring, KeywordInfo> keywords;
-    std::map<Keyword::T, std::wstring> keywordNames;
 };
 
 
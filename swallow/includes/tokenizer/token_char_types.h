@@ -31,7 +31,13 @@
 #define TOKEN_CHAR_TYPES_H
 #define CHECK(A, B) if(ch >= A && ch <= B)return true;
 
-static inline bool iswhite(wchar_t ch)
+/*
+ The classifiers take Unicode code points instead of wchar_t, so characters beyond
+ the BMP are classified correctly no matter how wide wchar_t is on the platform,
+ and UTF-8 source can be classified without widening it first.
+ */
+
+static inline bool iswhite(unsigned ch)
 {
     switch(ch)
     {
@@ -81,7 +87,7 @@ static inline bool iswhite(wchar_t ch)
 
 
  */
-inline static bool isOperatorHead(wchar_t ch)
+inline static bool isOperatorHead(unsigned ch)
 {
     switch(ch)
     {
@@ -126,7 +132,7 @@ inline static bool isOperatorHead(wchar_t ch)
             return false;
     }
 }
-static bool isOperatorCharacter(wchar_t ch)
+inline static bool isOperatorCharacter(unsigned ch)
 {
     if(isOperatorHead(ch))
         return true;
@@ -139,7 +145,7 @@ static bool isOperatorCharacter(wchar_t ch)
     return false;
 }
 
-static bool isDotOperatorCharacter(wchar_t ch)
+inline static bool isDotOperatorCharacter(unsigned ch)
 {
     if(ch == '.')
         return true;
@@ -174,7 +180,7 @@ inline static int to_digit(wchar_t ch)
 
 
 
-inline static bool isIdentifierHead(wchar_t ch)
+inline static bool isIdentifierHead(unsigned ch)
 {
     if(ch >= 'a' && ch <= 'z')
         return true;
@@ -257,12 +263,13 @@ inline static bool isIdentifierHead(wchar_t ch)
     return false;
 }
 
-inline static bool isIdentifierCharacter(wchar_t ch)
+inline static bool isIdentifierCharacter(unsigned ch)
 {
-    
     // identifier-character → Digit 0 through 9
     if(ch >= '0' && ch <= '9')
         return true;
+    if(ch < 0x80)
+        return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
     // identifier-character → U+0300–U+036F, U+1DC0–U+1DFF, U+20D0–U+20FF, or U+FE20–U+FE2F
     CHECK(0x0300, 0x036F)
     CHECK(0x1DC0, 0x1DFF)
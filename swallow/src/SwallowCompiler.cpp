@@ -36,20 +36,36 @@
 #include "semantics/DeclarationAnalyzer.h"
 #include "semantics/GlobalScope.h"
 #include "common/CompilerResults.h"
+#include "common/MappedFile.h"
+#include "common/SwallowUtils.h"
+#include "common/Errors.h"
+#include "common/SourceManager.h"
 #include "parser/Parser.h"
+#include "parser/Parser_Details.h"
+#include "parser/DeclarationSplitter.h"
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 using namespace std;
 USE_SWALLOW_NS
 
 SwallowCompiler::SwallowCompiler(const wstring& moduleName)
 {
     symbolRegistry = new SymbolRegistry();
+    sourceManager = new SourceManager();
     compilerResults = new CompilerResults();
+    compilerResults->setSourceManager(sourceManager);
     nodeFactory = new ScopedNodeFactory();
+    //parsed identifiers and the scopes of parsed nodes share the ids of the compilation's pool
+    nodeFactory->setStringPool(symbolRegistry->getStringPool());
     module = ModulePtr(new Module(moduleName, symbolRegistry->getGlobalScope()->getModuleType()));
     operatorResolver = new OperatorResolver(symbolRegistry, compilerResults);
     semanticAnalyzer = new SemanticAnalyzer(symbolRegistry, compilerResults, module);
     declarationAnalyzer = new DeclarationAnalyzer(semanticAnalyzer, semanticAnalyzer->getContext());
-    scope = new SymbolScope();
+    scope = new SymbolScope(symbolRegistry->getStringPool());
+    parsingThreads = 0;
+    splitSize = 64 * 1024;
 }
 SwallowCompiler::~SwallowCompiler()
 {
@@ -58,16 +74,29 @@ SwallowCompiler::~SwallowCompiler()
     delete operatorResolver;
     delete nodeFactory;
     delete compilerResults;
+    delete sourceManager;
     delete symbolRegistry;
 }
 void SwallowCompiler::addSourceFile(const SourceFilePtr& sourceFile)
 {
+    sourceManager->addFile(sourceFile);
     sourceFiles.push_back(sourceFile);
 }
 void SwallowCompiler::addSource(const wstring& name, const wstring& code)
 {
     addSourceFile(SourceFilePtr(new SourceFile(name, code)));
 }
+void SwallowCompiler::addSource(const wstring& name, const std::string& utf8)
+{
+    addSourceFile(SourceFilePtr(new SourceFile(name, utf8)));
+}
+void SwallowCompiler::addSourcePath(const std::string& path)
+{
+    SourceFilePtr sourceFile(new SourceFile());
+    sourceFile->fileName = SwallowUtils::toWString(path);
+    sourceFile->path = path;
+    addSourceFile(sourceFile);
+}
 
 ProgramPtr SwallowCompiler::createProgramNode()
 {
@@ -83,39 +112,263 @@ bool SwallowCompiler::compile()
 }
 bool SwallowCompiler::compile(std::vector<ProgramPtr>& programs)
 {
-    programs.clear();
+    bool ret = true;
     try
     {
-        for(const SourceFilePtr& source : sourceFiles)
+        if(!parse(programs))
+            throw Abort();
+        for(size_t i = 0; i < programs.size(); i++)
         {
-            ProgramPtr program = createProgramNode();
-            programs.push_back(program);
-            Parser parser(nodeFactory, compilerResults);
-            parser.setSourceFile(source);
-            if(!parser.parse(source->code.c_str(), program))
-                throw Abort();
-
-            program->accept(operatorResolver);
-            //program->accept(declarationAnalyzer);
-            program->accept(semanticAnalyzer);
+            //the file scope is lent to each program during the analysis
+            ScopedProgramPtr sp = dynamic_pointer_cast<ScopedProgram>(programs[i]);
+            if(sp)
+                sp->setScope(scope);
+            programs[i]->accept(operatorResolver);
+            //programs[i]->accept(declarationAnalyzer);
+            programs[i]->accept(semanticAnalyzer);
+            if(sp && i > 0)
+                sp->setScope(nullptr);
         }
     }
     catch(const Abort&)
     {
-        //TODO: refactor compiler
-        // ScopedProgram shouldn't maintaince its own scope.
-        for(ProgramPtr p : programs)
+        ret = false;
+    }
+    releaseScope(programs);
+    return ret;
+}
+/*!
+ * TODO: refactor compiler
+ * ScopedProgram shouldn't maintaince its own scope.
+ * All programs share the file scope, only the first one keeps it so it's released only once.
+ */
+void SwallowCompiler::releaseScope(const std::vector<ProgramPtr>& programs)
+{
+    for(size_t i = 0; i < programs.size(); i++)
+    {
+        if(ScopedProgramPtr sp = dynamic_pointer_cast<ScopedProgram>(programs[i]))
+        {
+            sp->setScope(i == 0 ? scope : nullptr);
+        }
+    }
+}
+
+/*!
+ * A source file or a chunk of a large source file to parse, each job has its own results
+ * so parsers running in different threads only share the node factory.
+ * The factory's create methods only touch its NodeArena, which is safe to allocate from
+ * concurrently: each thread bumps its own slab and only locks the arena for a new slab.
+ * The factory and its arena must not be replaced(setArena) while jobs are running.
+ * Identifiers and operators are interned through each parser's own front of the compilation's
+ * string pool, which only locks the shared pool to merge a string it hasn't seen.
+ */
+struct SwallowCompiler::ParseJob
+{
+    SourceFilePtr source;
+    ProgramPtr program;
+    /*!
+     * Code of the chunk in [begin, end), both are NULL when the whole file is parsed
+     */
+    const wchar_t* code;
+    const char* utf8;
+    int begin;
+    int end;
+    CompilerResults compilerResults;
+    bool parsed;
+    int recoveredStatements;
+
+    ParseJob(const SourceFilePtr& source, const ProgramPtr& program)
+        :source(source), program(program), code(NULL), utf8(NULL), begin(0), end(0), parsed(false), recoveredStatements(0)
+    {}
+};
+
+static void skipByteOrderMark(const char*& code, size_t& size)
+{
+    if(size >= 3 && !memcmp(code, "\xEF\xBB\xBF", 3))
+    {
+        code += 3;
+        size -= 3;
+    }
+}
+
+bool SwallowCompiler::parse(std::vector<ProgramPtr>& programs)
+{
+    programs.clear();
+    recoveredStatements.clear();
+    //nodes of last compilation are freed with their own arena once the caller releases them
+    nodeFactory->resetArena();
+    size_t threads = parsingThreads > 0 ? parsingThreads : std::thread::hardware_concurrency();
+    std::vector<ParseJob> jobs;
+    //first job of each file, a large file is split into chunks when it can be parsed in parallel
+    std::vector<size_t> fileJobs;
+    std::vector<std::shared_ptr<MappedFile> > mappedFiles;
+    for(const SourceFilePtr& source : sourceFiles)
+    {
+        ProgramPtr program = createProgramNode();
+        programs.push_back(program);
+        fileJobs.push_back(jobs.size());
+        if(threads <= 1 || splitSize == 0 || !split(source, jobs, mappedFiles))
+            jobs.push_back(ParseJob(source, program));
+    }
+    fileJobs.push_back(jobs.size());
+    threads = std::min(threads, jobs.size());
+    if(threads <= 1)
+    {
+        for(ParseJob& job : jobs)
+            parse(job);
+    }
+    else
+    {
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> workers;
+        for(size_t i = 0; i < threads; i++)
         {
-            if(ScopedProgramPtr sp = dynamic_pointer_cast<ScopedProgram>(p))
+            workers.push_back(std::thread([&]()
             {
-                sp->setScope(scope);
+                for(size_t job = next++; job < jobs.size(); job = next++)
+                    parse(jobs[job]);
+            }));
+        }
+        for(std::thread& worker : workers)
+            worker.join();
+    }
+    releaseScope(programs);
+    //merge in the order of source files, so the results don't depend on the scheduling
+    bool ret = true;
+    for(size_t i = 0; i < programs.size(); i++)
+    {
+        int recovered = 0;
+        for(size_t j = fileJobs[i]; j < fileJobs[i + 1]; j++)
+        {
+            const ParseJob& job = jobs[j];
+            //stitch the statements of chunks back in source order
+            if(job.program != programs[i])
+            {
+                for(int k = 0; k < job.program->numStatements(); k++)
+                    programs[i]->addStatement(job.program->getStatement(k));
             }
-            
+            compilerResults->add(job.compilerResults);
+            recovered += job.recoveredStatements;
+            ret = ret && job.parsed;
         }
+        recoveredStatements.push_back(recovered);
+    }
+    return ret;
+}
+/*!
+ * Split a large source file into chunks of top-level declarations and add a job for each chunk,
+ * returns false if the file should be parsed as a whole.
+ */
+bool SwallowCompiler::split(const SourceFilePtr& source, std::vector<ParseJob>& jobs, std::vector<std::shared_ptr<MappedFile> >& mappedFiles)
+{
+    const wchar_t* code = NULL;
+    const char* utf8 = NULL;
+    size_t size = 0;
+    if(source->isUtf8())
+    {
+        utf8 = source->utf8.c_str();
+        size = source->utf8.size();
+    }
+    else if(source->path.empty() || !source->code.empty())
+    {
+        code = source->code.c_str();
+        size = source->code.size();
+    }
+    else
+    {
+        //the mapping is kept until all chunks are parsed
+        std::shared_ptr<MappedFile> file(new MappedFile());
+        if(!file->open(source->path.c_str()))
+            return false;
+        utf8 = file->getData();
+        size = file->getSize();
+        skipByteOrderMark(utf8, size);
+        mappedFiles.push_back(file);
+    }
+    if(size < splitSize * 2)
+        return false;
+    std::vector<int> chunks;
+    DeclarationSplitter splitter;
+    splitter.setSourceFile(source);
+    bool splitted = utf8 ? splitter.split(utf8, size, splitSize, chunks) : splitter.split(code, size, splitSize, chunks);
+    if(!splitted || chunks.size() < 2)
         return false;
+    //positions are resolved by parsers of all chunks, the line starts need to be ready before
+    if(utf8)
+        source->indexLines(utf8, size);
+    else
+        source->indexLines(code, size);
+    chunks.push_back((int)size);
+    for(size_t i = 0; i + 1 < chunks.size(); i++)
+    {
+        ParseJob job(source, nodeFactory->createProgram());
+        job.code = code;
+        job.utf8 = utf8;
+        job.begin = chunks[i];
+        job.end = chunks[i + 1];
+        jobs.push_back(job);
     }
     return true;
 }
+void SwallowCompiler::parse(ParseJob& job)
+{
+    job.compilerResults.setSourceManager(sourceManager);
+    Parser parser(nodeFactory, &job.compilerResults);
+    parser.setSourceFile(job.source);
+    parser.setFlags(parser.getFlags() | RECOVER_ERRORS);
+    //expressions are built in precedence order, OperatorResolver only rotates the ones with unknown operators
+    parser.setSymbolRegistry(symbolRegistry);
+    if(job.utf8)
+        job.parsed = parser.parseChunk(job.utf8, job.begin, job.end, job.program);
+    else if(job.code)
+        job.parsed = parser.parseChunk(job.code, job.begin, job.end, job.program);
+    else
+        job.parsed = parse(parser, job);
+    job.recoveredStatements = parser.getStatistics().statementsRecovered;
+}
+/*!
+ * Parse the source file into program, files added by path are mapped only during the parsing
+ */
+bool SwallowCompiler::parse(Parser& parser, ParseJob& job)
+{
+    const SourceFilePtr& source = job.source;
+    const ProgramPtr& program = job.program;
+    if(source->isUtf8())
+        return parser.parse(source->utf8.c_str(), source->utf8.size(), program);
+    if(source->path.empty() || !source->code.empty())
+        return parser.parse(source->code.c_str(), source->code.size(), program);
+
+    MappedFile file;
+    if(!file.open(source->path.c_str()))
+    {
+        SourceInfo info;
+        info.fileId = source->id;
+        job.compilerResults.add(ErrorLevel::Fatal, info, Errors::E_CANNOT_OPEN_SOURCE_FILE_1, source->fileName);
+        return false;
+    }
+    const char* code = file.getData();
+    size_t size = file.getSize();
+    skipByteOrderMark(code, size);
+    //the AST doesn't refer to the code, the mapping is released when file goes out of scope
+    return parser.parse(code, size, program);
+}
+void SwallowCompiler::setParsingThreads(int threads)
+{
+    parsingThreads = threads;
+}
+void SwallowCompiler::setSplitSize(size_t size)
+{
+    splitSize = size;
+}
+int SwallowCompiler::getRecoveredStatements(const SourceFilePtr& sourceFile) const
+{
+    for(size_t i = 0; i < recoveredStatements.size(); i++)
+    {
+        if(sourceFiles[i] == sourceFile)
+            return recoveredStatements[i];
+    }
+    return 0;
+}
 ModulePtr SwallowCompiler::getModule()
 {
     return module;
@@ -128,6 +381,10 @@ CompilerResults* SwallowCompiler::getCompilerResults()
 {
     return compilerResults;
 }
+SourceManager* SwallowCompiler::getSourceManager()
+{
+    return sourceManager;
+}
 
 SymbolRegistry* SwallowCompiler::getSymbolRegistry()
 {
@@ -29,6 +29,7 @@
  */
 #include "ast/ArrayLiteral.h"
 #include "ast/NodeVisitor.h"
+#include "ast/NodeFactory.h"
 USE_SWALLOW_NS
 
 ArrayLiteral::ArrayLiteral()
@@ -43,15 +44,42 @@ ArrayLiteral::~ArrayLiteral()
 }
 void ArrayLiteral::push(const ExpressionPtr& item)
 {
+    materialize();
 	elements.push_back(item);
 }
 ExpressionPtr ArrayLiteral::getElement(int i)
 {
+    materialize();
     return elements[i];
 }
 int ArrayLiteral::numElements()const
 {
-    return elements.size();
+    return elements.size() + literals.size();
+}
+bool ArrayLiteral::isCompact()const
+{
+    return !literals.empty();
+}
+bool ArrayLiteral::canCompact()const
+{
+    return elements.empty();
+}
+LiteralColumns& ArrayLiteral::getLiterals()
+{
+    return literals;
+}
+
+void ArrayLiteral::materialize()
+{
+    if(literals.empty())
+        return;
+    //the nodes are created without a factory if it's already gone
+    std::shared_ptr<NodeFactory> factory = literals.lockNodeFactory();
+    int num = literals.size();
+    elements.reserve(num);
+    for(int i = 0; i < num; i++)
+        elements.push_back(literals.materialize(factory.get(), sourceInfo, i));
+    literals.clear();
 }
 
 void ArrayLiteral::accept(NodeVisitor* visitor)
@@ -60,9 +88,11 @@ void ArrayLiteral::accept(NodeVisitor* visitor)
 }
 std::vector<ExpressionPtr>::iterator ArrayLiteral::begin()
 {
+    materialize();
     return elements.begin();
 }
 std::vector<ExpressionPtr>::iterator ArrayLiteral::end()
 {
+    materialize();
     return elements.end();
 }
@@ -61,7 +61,7 @@ void Closure::setCapture(const ExpressionPtr& capture)
 {
     this->capture = capture;
 }
-ExpressionPtr Closure::getCapture()
+const ExpressionPtr& Closure::getCapture()
 {
     return capture;
 }
@@ -70,7 +70,7 @@ void Closure::setParameters(const ParametersNodePtr& val)
 {
     parameters = val;
 }
-ParametersNodePtr Closure::getParameters()
+const ParametersNodePtr& Closure::getParameters()
 {
     return parameters;
 }
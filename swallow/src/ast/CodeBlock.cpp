@@ -36,6 +36,8 @@ USE_SWALLOW_NS
 CodeBlock::CodeBlock()
     :Statement(NodeType::CodeBlock)
 {
+    lazyBody.begin = lazyBody.end = 0;
+    lazyBody.flags = lazyBody.context = 0;
 }
 CodeBlock::~CodeBlock()
 {
@@ -53,13 +55,35 @@ void CodeBlock::addStatement(const StatementPtr& st)
 }
 int CodeBlock::numStatements()
 {
+    if(!isLoaded())
+        load();
     return statements.size();
 }
 StatementPtr CodeBlock::getStatement(int idx)
 {
+    if(!isLoaded())
+        load();
     return statements[idx];
 }
 
+void CodeBlock::setLazyBody(const LazyBody& body)
+{
+    lazyBody = body;
+}
+const LazyBody& CodeBlock::getLazyBody() const
+{
+    return lazyBody;
+}
+void CodeBlock::load()
+{
+    if(isLoaded())
+        return;
+    //mark it loaded first, the loader adds statements through this block
+    CodeBlockLoaderPtr loader = lazyBody.loader;
+    lazyBody.loader = nullptr;
+    loader->load(this);
+}
+
 
 void CodeBlock::setAttributes(const Attributes& attrs)
 {
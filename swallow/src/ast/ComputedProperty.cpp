@@ -98,7 +98,7 @@ void ComputedProperty::setSetter(const CodeBlockPtr& setter)
 {
     this->setter = setter;
 }
-CodeBlockPtr ComputedProperty::getSetter()
+const CodeBlockPtr& ComputedProperty::getSetter()
 {
     return setter;
 }
@@ -116,7 +116,7 @@ void ComputedProperty::setGetter(const CodeBlockPtr& getter)
 {
     this->getter = getter;
 }
-CodeBlockPtr ComputedProperty::getGetter()
+const CodeBlockPtr& ComputedProperty::getGetter()
 {
     return getter;
 }
@@ -126,7 +126,7 @@ void ComputedProperty::setWillSet(const CodeBlockPtr& willSet)
 {
     this->willSet = willSet;
 }
-CodeBlockPtr ComputedProperty::getWillSet()
+const CodeBlockPtr& ComputedProperty::getWillSet()
 {
     return willSet;
 }
@@ -135,7 +135,7 @@ void ComputedProperty::setDidSet(const CodeBlockPtr& didSet)
 {
     this->didSet = didSet;
 }
-CodeBlockPtr ComputedProperty::getDidSet()
+const CodeBlockPtr& ComputedProperty::getDidSet()
 {
     return didSet;
 }
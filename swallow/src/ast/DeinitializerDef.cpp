@@ -48,7 +48,7 @@ void DeinitializerDef::accept(NodeVisitor* visitor)
 }
 
 
-CodeBlockPtr DeinitializerDef::getBody()
+const CodeBlockPtr& DeinitializerDef::getBody()
 {
     return body;
 }
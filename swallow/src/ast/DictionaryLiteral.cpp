@@ -29,6 +29,8 @@
  */
 #include "ast/DictionaryLiteral.h"
 #include "ast/NodeVisitor.h"
+#include "ast/NodeFactory.h"
+#include <cassert>
 USE_SWALLOW_NS
 
 
@@ -43,12 +45,52 @@ DictionaryLiteral::~DictionaryLiteral()
 
 void DictionaryLiteral::insert(const ExpressionPtr& key, const ExpressionPtr& value)
 {
+    materialize();
 	items.push_back(std::make_pair(key, value));
 }
 
 int DictionaryLiteral::numElements()const
 {
-    return items.size();
+    return items.size() + keys.size();
+}
+
+bool DictionaryLiteral::isCompact()const
+{
+    return !keys.empty();
+}
+
+bool DictionaryLiteral::canCompact()const
+{
+    return items.empty();
+}
+
+LiteralColumns& DictionaryLiteral::getLiteralKeys()
+{
+    return keys;
+}
+
+LiteralColumns& DictionaryLiteral::getLiteralValues()
+{
+    return values;
+}
+
+void DictionaryLiteral::materialize()
+{
+    if(keys.empty())
+        return;
+    assert(keys.size() == values.size());
+    //the nodes are created without a factory if it's already gone
+    std::shared_ptr<NodeFactory> factory = keys.lockNodeFactory();
+    int num = keys.size();
+    items.reserve(num);
+    for(int i = 0; i < num; i++)
+    {
+        ExpressionPtr key = keys.materialize(factory.get(), sourceInfo, i);
+        ExpressionPtr value = values.materialize(factory.get(), sourceInfo, i);
+        items.push_back(std::make_pair(key, value));
+    }
+    keys.clear();
+    values.clear();
 }
 
 
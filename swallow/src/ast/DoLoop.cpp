@@ -51,7 +51,7 @@ void DoLoop::setCodeBlock(const CodeBlockPtr& codeBlock)
 {
     this->codeBlock = codeBlock;
 }
-CodeBlockPtr DoLoop::getCodeBlock()
+const CodeBlockPtr& DoLoop::getCodeBlock()
 {
     return codeBlock;
 }
@@ -60,7 +60,7 @@ void DoLoop::setCondition(const ExpressionPtr& expression)
 {
     this->condition = expression;
 }
-ExpressionPtr DoLoop::getCondition()
+const ExpressionPtr& DoLoop::getCondition()
 {
     return condition;
 }
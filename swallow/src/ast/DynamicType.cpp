@@ -44,7 +44,7 @@ void DynamicType::setExpression(const ExpressionPtr& expr)
 {
     this->expression = expr;
 }
-ExpressionPtr DynamicType::getExpression()
+const ExpressionPtr& DynamicType::getExpression()
 {
     return expression;
 }
@@ -61,7 +61,7 @@ void ForInLoop::setContainer(const ExpressionPtr& val)
 {
     this->container = val;
 }
-ExpressionPtr ForInLoop::getContainer()
+const ExpressionPtr& ForInLoop::getContainer()
 {
     return container;
 }
@@ -70,7 +70,7 @@ void ForInLoop::setCodeBlock(const CodeBlockPtr& val)
 {
     codeBlock = val;
 }
-CodeBlockPtr ForInLoop::getCodeBlock()
+const CodeBlockPtr& ForInLoop::getCodeBlock()
 {
     return codeBlock;
 }
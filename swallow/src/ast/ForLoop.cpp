@@ -59,7 +59,7 @@ ExpressionPtr ForLoop::getInit(int idx) const
     return inits[idx];
 }
 
-ValueBindingsPtr ForLoop::getInitializer() const
+const ValueBindingsPtr& ForLoop::getInitializer() const
 {
     return initializer;
 }
@@ -74,7 +74,7 @@ void ForLoop::setCondition(const ExpressionPtr& cond)
 {
     condition = cond;
 }
-ExpressionPtr ForLoop::getCondition()
+const ExpressionPtr& ForLoop::getCondition()
 {
     return condition;
 }
@@ -92,7 +92,7 @@ void ForLoop::setCodeBlock(const CodeBlockPtr& codeBlock)
 {
     this->codeBlock = codeBlock;
 }
-CodeBlockPtr ForLoop::getCodeBlock()
+const CodeBlockPtr& ForLoop::getCodeBlock()
 {
     return codeBlock;
 }
@@ -43,7 +43,7 @@ void ForcedValue::setExpression(const ExpressionPtr& expr)
 {
     this->expression = expr;
 }
-ExpressionPtr ForcedValue::getExpression()
+const ExpressionPtr& ForcedValue::getExpression()
 {
     return expression;
 }
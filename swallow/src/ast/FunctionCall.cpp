@@ -48,7 +48,7 @@ void FunctionCall::setFunction(const ExpressionPtr& expr)
 {
     function = expr;
 }
-ExpressionPtr FunctionCall::getFunction()
+const ExpressionPtr& FunctionCall::getFunction()
 {
     return function;
 }
@@ -56,7 +56,7 @@ void FunctionCall::setArguments(const ParenthesizedExpressionPtr& arguments)
 {
     this->arguments = arguments;
 }
-ParenthesizedExpressionPtr FunctionCall::getArguments()
+const ParenthesizedExpressionPtr& FunctionCall::getArguments()
 {
     return arguments;
 }
@@ -67,7 +67,7 @@ void FunctionCall::setTrailingClosure(const ClosurePtr& trailingClosure)
 }
 
 
-ClosurePtr FunctionCall::getTrailingClosure()
+const ClosurePtr& FunctionCall::getTrailingClosure()
 {
     return trailingClosure;
 }
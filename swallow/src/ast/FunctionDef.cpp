@@ -94,7 +94,7 @@ void FunctionDef::setBody(const CodeBlockPtr& body)
 {
     this->body = body;
 }
-CodeBlockPtr FunctionDef::getBody()
+const CodeBlockPtr& FunctionDef::getBody()
 {
     return body;
 }
@@ -32,7 +32,7 @@
 USE_SWALLOW_NS
 
 Identifier::Identifier()
-    :Expression(NodeType::Identifier)
+    :Expression(NodeType::Identifier), symbol(0)
 {
 }
 
@@ -53,7 +53,7 @@ void IfStatement::setCondition(const ExpressionPtr& expr)
 {
     this->condition = expr;
 }
-ExpressionPtr IfStatement::getCondition()
+const ExpressionPtr& IfStatement::getCondition()
 {
     return condition;
 }
@@ -62,7 +62,7 @@ void IfStatement::setThen(const CodeBlockPtr& thenPart)
 {
     this->thenPart = thenPart;
 }
-CodeBlockPtr IfStatement::getThen()
+const CodeBlockPtr& IfStatement::getThen()
 {
     return thenPart;
 }
@@ -71,7 +71,7 @@ void IfStatement::setElse(const StatementPtr& elsePart)
 {
     this->elsePart = elsePart;
 }
-StatementPtr IfStatement::getElse()
+const StatementPtr& IfStatement::getElse()
 {
     return elsePart;
 }
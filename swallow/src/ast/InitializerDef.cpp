@@ -52,7 +52,7 @@ void InitializerDef::setParameters(const ParametersNodePtr& parameters)
 {
     this->parameters = parameters;
 }
-ParametersNodePtr InitializerDef::getParameters()
+const ParametersNodePtr& InitializerDef::getParameters()
 {
     return parameters;
 }
@@ -61,7 +61,7 @@ void InitializerDef::setBody(const CodeBlockPtr& body)
 {
     this->body = body;
 }
-CodeBlockPtr InitializerDef::getBody()
+const CodeBlockPtr& InitializerDef::getBody()
 {
     return body;
 }
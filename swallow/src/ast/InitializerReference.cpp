@@ -44,7 +44,7 @@ void InitializerReference::setExpression(const ExpressionPtr& expr)
 {
     this->expression = expr;
 }
-ExpressionPtr InitializerReference::getExpression()
+const ExpressionPtr& InitializerReference::getExpression()
 {
     return expression;
 }
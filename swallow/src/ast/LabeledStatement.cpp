@@ -61,7 +61,7 @@ void LabeledStatement::setStatement(const StatementPtr& statement)
     this->statement = statement;
 }
 
-StatementPtr LabeledStatement::getStatement()
+const StatementPtr& LabeledStatement::getStatement()
 {
     return statement;
 }
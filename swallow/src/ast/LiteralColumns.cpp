@@ -0,0 +1,178 @@
+/* LiteralColumns.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ast/LiteralColumns.h"
+#include "ast/NodeFactory.h"
+#include "ast/IntegerLiteral.h"
+#include "ast/FloatLiteral.h"
+#include "ast/StringLiteral.h"
+#include <cassert>
+
+USE_SWALLOW_NS
+
+
+LiteralColumns::LiteralColumns()
+{
+}
+
+void LiteralColumns::setNodeFactory(const std::weak_ptr<NodeFactory>& nodeFactory, const NodeArenaPtr& arena)
+{
+    this->nodeFactory = nodeFactory;
+    this->arena = arena;
+}
+std::shared_ptr<NodeFactory> LiteralColumns::lockNodeFactory() const
+{
+    return nodeFactory.lock();
+}
+
+void LiteralColumns::setElementType(const TypePtr& type)
+{
+    this->elementType = type;
+}
+const TypePtr& LiteralColumns::getElementType() const
+{
+    return elementType;
+}
+
+void LiteralColumns::addRow(NodeType::T type, int offset, const std::wstring& text)
+{
+    types.push_back((unsigned char)type);
+    offsets.push_back(offset);
+    texts.append(text);
+    textEnds.push_back((int)texts.size());
+}
+
+void LiteralColumns::addInteger(int offset, const std::wstring& text, int64_t value)
+{
+    Number n;
+    n.i = value;
+    numbers.push_back(n);
+    addRow(NodeType::IntegerLiteral, offset, text);
+}
+
+void LiteralColumns::addFloat(int offset, const std::wstring& text, double value)
+{
+    Number n;
+    n.d = value;
+    numbers.push_back(n);
+    addRow(NodeType::FloatLiteral, offset, text);
+}
+
+void LiteralColumns::addString(int offset, const std::wstring& value)
+{
+    Number n;
+    n.i = 0;
+    numbers.push_back(n);
+    addRow(NodeType::StringLiteral, offset, value);
+}
+
+bool LiteralColumns::add(const ExpressionPtr& literal)
+{
+    if(!literal)
+        return false;
+    int offset = literal->getSourceInfo()->offset;
+    switch(literal->getNodeType())
+    {
+        case NodeType::IntegerLiteral:
+        {
+            IntegerLiteralPtr i = std::static_pointer_cast<IntegerLiteral>(literal);
+            addInteger(offset, i->valueAsString, i->value);
+            return true;
+        }
+        case NodeType::FloatLiteral:
+        {
+            FloatLiteralPtr f = std::static_pointer_cast<FloatLiteral>(literal);
+            addFloat(offset, f->valueAsString, f->value);
+            return true;
+        }
+        case NodeType::StringLiteral:
+        {
+            StringLiteralPtr s = std::static_pointer_cast<StringLiteral>(literal);
+            addString(offset, s->value);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void LiteralColumns::clear()
+{
+    //release the storage as well, the columns won't be used once materialized
+    std::vector<unsigned char>().swap(types);
+    std::vector<int>().swap(offsets);
+    std::vector<Number>().swap(numbers);
+    std::vector<int>().swap(textEnds);
+    std::wstring().swap(texts);
+}
+
+std::wstring LiteralColumns::getText(int i) const
+{
+    int begin = i == 0 ? 0 : textEnds[i - 1];
+    return texts.substr(begin, textEnds[i] - begin);
+}
+int LiteralColumns::getTextLength(int i) const
+{
+    return textEnds[i] - (i == 0 ? 0 : textEnds[i - 1]);
+}
+
+ExpressionPtr LiteralColumns::materialize(NodeFactory* factory, const SourceInfo& base, int i) const
+{
+    SourceInfo info = base;
+    info.offset = offsets[i];
+    switch(getType(i))
+    {
+        case NodeType::IntegerLiteral:
+        {
+            IntegerLiteralPtr ret = factory ? factory->createInteger(info) : NodeFactory::createDetached<IntegerLiteral>(arena, info);
+            ret->valueAsString = getText(i);
+            ret->value = numbers[i].i;
+            ret->setType(elementType);
+            return ret;
+        }
+        case NodeType::FloatLiteral:
+        {
+            FloatLiteralPtr ret = factory ? factory->createFloat(info) : NodeFactory::createDetached<FloatLiteral>(arena, info);
+            ret->valueAsString = getText(i);
+            ret->value = numbers[i].d;
+            ret->setType(elementType);
+            return ret;
+        }
+        case NodeType::StringLiteral:
+        {
+            StringLiteralPtr ret = factory ? factory->createString(info) : NodeFactory::createDetached<StringLiteral>(arena, info);
+            ret->value = getText(i);
+            ret->setType(elementType);
+            return ret;
+        }
+        default:
+            assert(0 && "Invalid literal type");
+            return nullptr;
+    }
+}
@@ -48,7 +48,7 @@ void MemberAccess::setField(const IdentifierPtr& field)
     this->field = field;
 }
 
-ExpressionPtr MemberAccess::getSelf()
+const ExpressionPtr& MemberAccess::getSelf()
 {
     return self;
     
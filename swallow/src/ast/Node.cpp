@@ -32,17 +32,48 @@
 #include <cassert>
 #include <set>
 #include <algorithm>
+#ifdef TRACE_NODE
+#include <mutex>
+#endif//TRACE_NODE
 USE_SWALLOW_NS
 
 #ifdef TRACE_NODE
-int Node::NodeCount = 0;
-std::list<Node*> Node::UnreleasedNodes;
+/*!
+ * Nodes can be created and released by parsers running in different threads
+ */
+static std::mutex NodeTraceLock;
+static Node* TraceHead = nullptr;
+static Node* TraceTail = nullptr;
+static int NodeCount = 0;
 
+int Node::getNodeCount()
+{
+    std::lock_guard<std::mutex> lock(NodeTraceLock);
+    return NodeCount;
+}
+std::vector<Node*> Node::getUnreleasedNodes()
+{
+    std::lock_guard<std::mutex> lock(NodeTraceLock);
+    std::vector<Node*> ret;
+    for(Node* n = TraceHead; n; n = n->traceNext)
+        ret.push_back(n);
+    return ret;
+}
+void Node::resetTrace()
+{
+    std::lock_guard<std::mutex> lock(NodeTraceLock);
+    Node* n = TraceHead;
+    while(n)
+    {
+        Node* next = n->traceNext;
+        n->tracePrev = n->traceNext = nullptr;
+        n = next;
+    }
+    TraceHead = TraceTail = nullptr;
+    NodeCount = 0;
+}
 #endif
 
-
-
-
 /*!
 * Used for debugging, convert node type into it's class name
 */
@@ -75,6 +106,7 @@ const char* Node::nodeTypeToName(NodeType::T nodeType)
     CASE_TYPE(DynamicType)
     CASE_TYPE(EnumCasePattern)
     CASE_TYPE(Enum)
+    CASE_TYPE(ErrorStatement)
     CASE_TYPE(Extension)
     CASE_TYPE(Fallthrough)
     CASE_TYPE(FloatLiteral)
@@ -135,20 +167,36 @@ const char* Node::nodeTypeToName(NodeType::T nodeType)
 
 
 Node::Node(NodeType::T nodeType)
-:nodeType(nodeType), nodeFactory(nullptr)
+:nodeType(nodeType), nodeFactory(nullptr), linkedParent(nullptr)
 {
 #ifdef TRACE_NODE
+    std::lock_guard<std::mutex> lock(NodeTraceLock);
     NodeCount++;
-    UnreleasedNodes.push_back(this);
+    tracePrev = TraceTail;
+    traceNext = nullptr;
+    if(TraceTail)
+        TraceTail->traceNext = this;
+    else
+        TraceHead = this;
+    TraceTail = this;
 #endif
 }
 Node::~Node()
 {
 #ifdef TRACE_NODE
+    std::lock_guard<std::mutex> lock(NodeTraceLock);
+    //nodes created before last resetTrace are not in the list
+    if(!tracePrev && TraceHead != this)
+        return;
     NodeCount--;
-    std::list<Node*>::iterator iter = std::find(UnreleasedNodes.begin(), UnreleasedNodes.end(), this);
-    if(iter != UnreleasedNodes.end())
-        UnreleasedNodes.erase(iter);
+    if(tracePrev)
+        tracePrev->traceNext = traceNext;
+    else
+        TraceHead = traceNext;
+    if(traceNext)
+        traceNext->tracePrev = tracePrev;
+    else
+        TraceTail = tracePrev;
 #endif
 }
 
@@ -169,3 +217,14 @@ NodePtr Node::getParentNode() const
 {
     return parentNode.lock();
 }
+void Node::setParentNode(Node* parent)
+{
+    //only update the link when a pass moved the node to another parent
+    if(parent == linkedParent && (!parent || !parentNode.expired()))
+        return;
+    linkedParent = parent;
+    if(parent)
+        parentNode = parent->shared_from_this();
+    else
+        parentNode.reset();
+}
@@ -0,0 +1,128 @@
+/* NodeArena.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ast/NodeArena.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+USE_SWALLOW_NS
+
+
+/*!
+ * Bump pointer of a thread into an arena's slab
+ */
+struct ArenaCursor
+{
+    unsigned long arena;
+    char* cursor;
+    char* end;
+};
+/*!
+ * A worker thread may switch between a few arenas, each keeps its slab
+ */
+static const int CURSORS = 4;
+static thread_local ArenaCursor cursors[CURSORS];
+static thread_local int nextCursor = 0;
+static std::atomic<unsigned long> arenaIds(0);
+
+
+NodeArena::NodeArena()
+:id(++arenaIds), owner(std::this_thread::get_id()), cursor(nullptr), end(nullptr), reservedBytes(0)
+{
+}
+NodeArena::~NodeArena()
+{
+    for(char* slab : slabs)
+    {
+        free(slab);
+    }
+}
+
+char* NodeArena::allocateSlab(size_t size)
+{
+    char* ret = static_cast<char*>(malloc(size));
+    if(!ret)
+        throw std::bad_alloc();
+    std::lock_guard<std::mutex> guard(lock);
+    slabs.push_back(ret);
+    reservedBytes += size;
+    return ret;
+}
+
+void* NodeArena::bump(char*& top, char*& limit, size_t size)
+{
+    if(size <= (size_t)(limit - top))
+    {
+        void* ret = top;
+        top += size;
+        return ret;
+    }
+    //large nodes get their own slab and leave current slab to small ones
+    if(size > SLAB_SIZE / 8)
+        return allocateSlab(size);
+    top = allocateSlab(SLAB_SIZE);
+    limit = top + SLAB_SIZE;
+    void* ret = top;
+    top += size;
+    return ret;
+}
+
+void* NodeArena::allocate(size_t size)
+{
+    size = (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+    if(std::this_thread::get_id() == owner)
+        return bump(cursor, end, size);
+    ArenaCursor* c = nullptr;
+    for(int i = 0; i < CURSORS && !c; i++)
+    {
+        if(cursors[i].arena == id)
+            c = &cursors[i];
+    }
+    if(!c)
+    {
+        c = &cursors[nextCursor];
+        nextCursor = (nextCursor + 1) % CURSORS;
+        c->arena = id;
+        c->cursor = c->end = nullptr;
+    }
+    return bump(c->cursor, c->end, size);
+}
+
+size_t NodeArena::numSlabs()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return slabs.size();
+}
+
+size_t NodeArena::getReservedBytes()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return reservedBytes;
+}
@@ -29,17 +29,49 @@
  */
 #include "ast/NodeFactory.h"
 #include "ast/ast.h"
+#include "parser/ParserProfile.h"
+#include "common/StringPool.h"
 USE_SWALLOW_NS;
 
 
 NodeFactory::NodeFactory()
+:arena(new NodeArena()), stringPool(new StringPool()), self(this, [](NodeFactory*){})
 {
 }
 
+void NodeFactory::setStringPool(const StringPoolPtr& pool)
+{
+    this->stringPool = pool;
+}
+const StringPoolPtr& NodeFactory::getStringPool() const
+{
+    return stringPool;
+}
+void NodeFactory::setArena(const NodeArenaPtr& arena)
+{
+    this->arena = arena;
+}
+const NodeArenaPtr& NodeFactory::getArena() const
+{
+    return arena;
+}
+void NodeFactory::resetArena()
+{
+    if(arena)
+        arena = NodeArenaPtr(new NodeArena());
+}
+std::weak_ptr<NodeFactory> NodeFactory::getWeakReference() const
+{
+    return self;
+}
+
 void NodeFactory::bindNode(const SourceInfo&s, Node* n)
 {
     *n->getSourceInfo() = s;
     n->nodeFactory = this;
+#ifdef PARSER_PROFILE
+    ParserProfile::countAllocation();
+#endif
 }
 
 
@@ -106,11 +138,16 @@ BinaryOperatorPtr NodeFactory::createBinary(const SourceInfo&state)
 
 ArrayLiteralPtr NodeFactory::createArrayLiteral(const SourceInfo& state)
 {
-    return create<ArrayLiteral>(state);
+    ArrayLiteralPtr ret = create<ArrayLiteral>(state);
+    ret->getLiterals().setNodeFactory(self, arena);
+    return ret;
 }
 DictionaryLiteralPtr NodeFactory::createDictionaryLiteral(const SourceInfo& state)
 {
-    return create<DictionaryLiteral>(state);
+    DictionaryLiteralPtr ret = create<DictionaryLiteral>(state);
+    ret->getLiteralKeys().setNodeFactory(self, arena);
+    ret->getLiteralValues().setNodeFactory(self, arena);
+    return ret;
 }
 CompileConstantPtr NodeFactory::createCompilecConstant(const SourceInfo&state)
 {
@@ -213,6 +250,10 @@ FallthroughStatementPtr NodeFactory::createFallthrough(const SourceInfo& state)
 {
     return create<FallthroughStatement>(state);
 }
+ErrorStatementPtr NodeFactory::createErrorStatement(const SourceInfo& state)
+{
+    return create<ErrorStatement>(state);
+}
 ReturnStatementPtr NodeFactory::createReturn(const SourceInfo& state)
 {
     return create<ReturnStatement>(state);
@@ -72,7 +72,7 @@ void NodeVisitor::visitForIn(const ForInLoopPtr& node)
 
 void NodeVisitor::visitForLoop(const ForLoopPtr& node)
 {
-    for(ExpressionPtr init : node->inits)
+    for(const ExpressionPtr& init : node->inits)
     {
         ACCEPT(init);
     }
@@ -100,7 +100,10 @@ void NodeVisitor::visitOperator(const OperatorDefPtr& node)
 
 void NodeVisitor::visitArrayLiteral(const ArrayLiteralPtr& node)
 {
-    for(ExpressionPtr expr : node->elements)
+    //plain literals have no child node, compact ones are not created only to be visited
+    if(node->isCompact())
+        return;
+    for(const ExpressionPtr& expr : *node)
     {
         ACCEPT(expr);
     }
@@ -108,7 +111,9 @@ void NodeVisitor::visitArrayLiteral(const ArrayLiteralPtr& node)
 
 void NodeVisitor::visitDictionaryLiteral(const DictionaryLiteralPtr& node)
 {
-    for(auto entry : *node)
+    if(node->isCompact())
+        return;
+    for(const auto& entry : *node)
     {
         ACCEPT(entry.first);
         ACCEPT(entry.second);
@@ -131,6 +136,9 @@ void NodeVisitor::visitContinue(const ContinueStatementPtr& node)
 void NodeVisitor::visitFallthrough(const FallthroughStatementPtr& node)
 {
 }
+void NodeVisitor::visitErrorStatement(const ErrorStatementPtr& node)
+{
+}
 
 void NodeVisitor::visitIf(const IfStatementPtr& node)
 {
@@ -142,7 +150,7 @@ void NodeVisitor::visitIf(const IfStatementPtr& node)
 void NodeVisitor::visitSwitchCase(const SwitchCasePtr& node)
 {
     ACCEPT(node->getControlExpression());
-    for(CaseStatementPtr c : *node)
+    for(const CaseStatementPtr& c : *node)
     {
         ACCEPT(c);
     }
@@ -151,7 +159,7 @@ void NodeVisitor::visitSwitchCase(const SwitchCasePtr& node)
 
 void NodeVisitor::visitCase(const CaseStatementPtr& node)
 {
-    for(auto condition : node->getConditions())
+    for(const auto& condition : node->getConditions())
     {
         ACCEPT(condition.condition);
         ACCEPT(condition.guard);
@@ -161,7 +169,7 @@ void NodeVisitor::visitCase(const CaseStatementPtr& node)
 
 void NodeVisitor::visitCodeBlock(const CodeBlockPtr& node)
 {
-    for(auto st: *node)
+    for(const auto& st: *node)
     {
         ACCEPT(st);
     }
@@ -174,7 +182,7 @@ void NodeVisitor::visitParameter(const ParameterNodePtr& node)
 
 void NodeVisitor::visitParameters(const ParametersNodePtr& node)
 {
-    for(ParameterNodePtr p : *node)
+    for(const ParameterNodePtr& p : *node)
     {
         ACCEPT(p);
     }
@@ -182,7 +190,7 @@ void NodeVisitor::visitParameters(const ParametersNodePtr& node)
 
 void NodeVisitor::visitProgram(const ProgramPtr& node)
 {
-    for(StatementPtr st : *node)
+    for(const StatementPtr& st : *node)
     {
         ACCEPT(st);
     }
@@ -195,7 +203,7 @@ void NodeVisitor::visitValueBindingPattern(const ValueBindingPatternPtr& node)
 
 void NodeVisitor::visitValueBindings(const ValueBindingsPtr &node)
 {
-    for(ValueBindingPtr var : *node)
+    for(const ValueBindingPtr& var : *node)
     {
         ACCEPT(var);
     }
@@ -223,7 +231,7 @@ void NodeVisitor::visitAssignment(const AssignmentPtr& node)
 
 void NodeVisitor::visitClass(const ClassDefPtr& node)
 {
-    for(DeclarationPtr dec : *node)
+    for(const DeclarationPtr& dec : *node)
     {
         dec->accept(this);
     }
@@ -231,7 +239,7 @@ void NodeVisitor::visitClass(const ClassDefPtr& node)
 
 void NodeVisitor::visitStruct(const StructDefPtr& node)
 {
-    for(DeclarationPtr dec : *node)
+    for(const DeclarationPtr& dec : *node)
     {
         dec->accept(this);
     }
@@ -239,7 +247,7 @@ void NodeVisitor::visitStruct(const StructDefPtr& node)
 
 void NodeVisitor::visitEnum(const EnumDefPtr& node)
 {
-    for(DeclarationPtr dec : *node)
+    for(const DeclarationPtr& dec : *node)
     {
         dec->accept(this);
     }
@@ -247,7 +255,7 @@ void NodeVisitor::visitEnum(const EnumDefPtr& node)
 
 void NodeVisitor::visitProtocol(const ProtocolDefPtr& node)
 {
-    for(DeclarationPtr dec : *node)
+    for(const DeclarationPtr& dec : *node)
     {
         dec->accept(this);
     }
@@ -255,7 +263,7 @@ void NodeVisitor::visitProtocol(const ProtocolDefPtr& node)
 
 void NodeVisitor::visitExtension(const ExtensionDefPtr& node)
 {
-    for(DeclarationPtr dec : *node)
+    for(const DeclarationPtr& dec : *node)
     {
         dec->accept(this);
     }
@@ -263,7 +271,7 @@ void NodeVisitor::visitExtension(const ExtensionDefPtr& node)
 
 void NodeVisitor::visitFunction(const FunctionDefPtr& node)
 {
-    for(ParametersNodePtr params : node->getParametersList())
+    for(const ParametersNodePtr& params : node->getParametersList())
     {
         ACCEPT(params);
     }
@@ -374,7 +382,7 @@ void NodeVisitor::visitOptionalChaining(const OptionalChainingPtr& node)
 
 void NodeVisitor::visitParenthesizedExpression(const ParenthesizedExpressionPtr& node)
 {
-    for(auto term : *node)
+    for(const auto& term : *node)
     {
         ACCEPT(term.expression);
     }
@@ -382,7 +390,7 @@ void NodeVisitor::visitParenthesizedExpression(const ParenthesizedExpressionPtr&
 
 void NodeVisitor::visitStringInterpolation(const StringInterpolationPtr &node)
 {
-    for(auto expr : * node)
+    for(const auto& expr : * node)
     {
         ACCEPT(expr);
     }
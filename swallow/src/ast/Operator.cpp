@@ -31,7 +31,7 @@
 USE_SWALLOW_NS
 
 Operator::Operator(NodeType::T nodeType)
-    :Expression(nodeType), operatorType(OperatorType::_), associativity(Associativity::None), precedence(100)
+    :Expression(nodeType), operatorType(OperatorType::_), associativity(Associativity::None), precedence(100), sorted(false)
 {
     
 }
@@ -45,7 +45,7 @@ void OptionalChaining::setExpression(const ExpressionPtr& expr)
 {
     this->expression = expr;
 }
-ExpressionPtr OptionalChaining::getExpression()
+const ExpressionPtr& OptionalChaining::getExpression()
 {
     return expression;
 }
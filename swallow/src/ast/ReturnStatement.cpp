@@ -49,7 +49,7 @@ void ReturnStatement::setExpression(const ExpressionPtr& expr)
 {
     this->expression = expr;
 }
-ExpressionPtr ReturnStatement::getExpression()
+const ExpressionPtr& ReturnStatement::getExpression()
 {
     return expression;
 }
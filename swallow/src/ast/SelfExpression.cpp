@@ -47,7 +47,7 @@ void SelfExpression::setExpression(const ExpressionPtr& expr)
 {
     this->expression = expr;
 }
-ExpressionPtr SelfExpression::getExpression()
+const ExpressionPtr& SelfExpression::getExpression()
 {
     return expression;
 }
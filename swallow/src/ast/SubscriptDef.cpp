@@ -51,7 +51,7 @@ void SubscriptDef::setParameters(const ParametersNodePtr& params)
 {
     this->parameters = params;
 }
-ParametersNodePtr SubscriptDef::getParameters()
+const ParametersNodePtr& SubscriptDef::getParameters()
 {
     return parameters;
 }
@@ -78,7 +78,7 @@ void SubscriptDef::setGetter(const CodeBlockPtr& getter)
 {
     this->getter = getter;
 }
-CodeBlockPtr SubscriptDef::getGetter()
+const CodeBlockPtr& SubscriptDef::getGetter()
 {
     return getter;
 }
@@ -87,7 +87,7 @@ void SubscriptDef::setSetter(const CodeBlockPtr& setter)
 {
     this->setter = setter;
 }
-CodeBlockPtr SubscriptDef::getSetter()
+const CodeBlockPtr& SubscriptDef::getSetter()
 {
     return setter;
 }
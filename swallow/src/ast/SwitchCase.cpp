@@ -52,7 +52,7 @@ void SwitchCase::setControlExpression(const ExpressionPtr& expr)
 {
     this->controlExpression = expr;
 }
-ExpressionPtr SwitchCase::getControlExpression()
+const ExpressionPtr& SwitchCase::getControlExpression()
 {
     return controlExpression;
 }
@@ -74,7 +74,7 @@ void SwitchCase::setDefaultCase(const CaseStatementPtr& c)
 {
     this->defaultCase = c;
 }
-CaseStatementPtr SwitchCase::getDefaultCase()
+const CaseStatementPtr& SwitchCase::getDefaultCase()
 {
     return defaultCase;
 }
@@ -51,7 +51,7 @@ void TypedPattern::setPattern(const PatternPtr& pattern)
 {
     this->pattern = pattern;
 }
-PatternPtr TypedPattern::getPattern()const
+const PatternPtr& TypedPattern::getPattern()const
 {
     return pattern;
 }
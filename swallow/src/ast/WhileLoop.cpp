@@ -52,7 +52,7 @@ void WhileLoop::setCodeBlock(const CodeBlockPtr& codeBlock)
 {
     this->codeBlock = codeBlock;
 }
-CodeBlockPtr WhileLoop::getCodeBlock()
+const CodeBlockPtr& WhileLoop::getCodeBlock()
 {
     return codeBlock;
 }
@@ -61,7 +61,7 @@ void WhileLoop::setCondition(const ExpressionPtr& expression)
 {
     this->condition = expression;
 }
-ExpressionPtr WhileLoop::getCondition()
+const ExpressionPtr& WhileLoop::getCondition()
 {
     return condition;
 }
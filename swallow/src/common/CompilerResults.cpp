@@ -32,6 +32,18 @@
 USE_SWALLOW_NS
 
 
+CompilerResults::CompilerResults()
+    :sourceManager(nullptr)
+{
+}
+void CompilerResults::setSourceManager(const SourceManager* sourceManager)
+{
+    this->sourceManager = sourceManager;
+}
+const SourceManager* CompilerResults::getSourceManager() const
+{
+    return sourceManager;
+}
 void CompilerResults::clear()
 {
     results.clear();
@@ -46,7 +58,8 @@ const CompilerResult& CompilerResults::getResult(int i) const
 }
 void CompilerResults::add(ErrorLevel::T level, const SourceInfo& sourceInfo, int code, const ResultItems& items)
 {
-    results.push_back(CompilerResult(level, sourceInfo, code, items));
+    SourceFilePtr sourceFile = sourceManager ? sourceManager->getFile(sourceInfo.fileId) : nullptr;
+    results.push_back(CompilerResult(level, sourceInfo, code, items, sourceFile));
 }
 void CompilerResults::add(ErrorLevel::T level, const SourceInfo& sourceInfo, int code, const std::wstring& item)
 {
@@ -54,3 +67,7 @@ void CompilerResults::add(ErrorLevel::T level, const SourceInfo& sourceInfo, int
     items.push_back(item);
     add(level, sourceInfo, code, items);
 }
+void CompilerResults::add(const CompilerResults& results)
+{
+    this->results.insert(this->results.end(), results.results.begin(), results.results.end());
+}
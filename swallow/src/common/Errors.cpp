@@ -66,6 +66,7 @@ std::wstring Errors::getErrorTemplate(int errorCode)
         case Errors::E_UNEXPECTED_CHARACTER_A_IN_STRING_INTERPOLATION: return L"Unexpected '%0' character in string interpolation";
         case Errors::E_INVALID_ESCAPE_SEQUENCE_IN_LITERAL: return L"Invalid escape sequence in literal";
         case Errors::E_COMPUTED_PROPERTY_CANNOT_BE_DECLARED_UNDER_FOR_LOOP: return L"Computed property cannot be declared under for loop";
+        case Errors::E_CANNOT_OPEN_SOURCE_FILE_1: return L"Cannot open source file %0";
 
 
         case Errors::E_INVALID_REDECLARATION_1: return L"Invalid redeclaration of '%0'";
@@ -0,0 +1,101 @@
+/* MappedFile.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "common/MappedFile.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+USE_SWALLOW_NS
+
+MappedFile::MappedFile()
+    :data(NULL), size(0), mapped(false)
+{
+}
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const char* path)
+{
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if(fd == -1)
+        return false;
+    struct stat st;
+    if(fstat(fd, &st) == -1 || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        return false;
+    }
+    if(st.st_size == 0)
+    {
+        //empty file cannot be mapped
+        ::close(fd);
+        data = "";
+        return true;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    //the mapping keeps the file referenced
+    ::close(fd);
+    if(p == MAP_FAILED)
+        return false;
+    //the parser reads the code from beginning to end
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+    data = (const char*)p;
+    size = (size_t)st.st_size;
+    mapped = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(mapped)
+        munmap((void*)data, size);
+    data = NULL;
+    size = 0;
+    mapped = false;
+}
+
+bool MappedFile::isOpen() const
+{
+    return data != NULL;
+}
+
+const char* MappedFile::getData() const
+{
+    return data;
+}
+
+size_t MappedFile::getSize() const
+{
+    return size;
+}
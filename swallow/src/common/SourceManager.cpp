@@ -0,0 +1,75 @@
+/* SourceManager.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "common/SourceManager.h"
+#include <atomic>
+#include <type_traits>
+
+USE_SWALLOW_NS
+
+static_assert(std::is_trivially_copyable<SourceInfo>::value, "SourceInfo must be trivially copyable");
+
+/*!
+ * Last id given to a source file by any manager
+ */
+static std::atomic<int> LastFileId(0);
+
+
+int SourceManager::addFile(const SourceFilePtr& file)
+{
+    if(!file)
+        return 0;
+    if(file->id == 0)
+        file->id = ++LastFileId;
+    files[file->id] = file;
+    return file->id;
+}
+
+SourceFilePtr SourceManager::getFile(int id) const
+{
+    std::unordered_map<int, SourceFilePtr>::const_iterator iter = files.find(id);
+    if(iter == files.end())
+        return nullptr;
+    return iter->second;
+}
+
+bool SourceManager::getPosition(const SourceInfo& info, int& line, int& column) const
+{
+    line = column = 0;
+    SourceFilePtr file = getFile(info.fileId);
+    if(!file)
+        return false;
+    file->getPosition(info.offset, line, column);
+    return true;
+}
+
+int SourceManager::numFiles() const
+{
+    return (int)files.size();
+}
@@ -0,0 +1,162 @@
+/* StringPool.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "common/StringPool.h"
+#include <cwchar>
+#include <cassert>
+USE_SWALLOW_NS
+
+
+StringPool::StringPool(const std::shared_ptr<StringPool>& shared)
+    :shared(shared)
+{
+    assert((!shared || !shared->shared) && "A front can only be created from a shared pool");
+    slots.resize(256, 0);
+    if(!shared)
+        intern(L"", 0);
+}
+
+unsigned StringPool::hash(const wchar_t* str, size_t length)
+{
+    //FNV-1a
+    unsigned h = 2166136261u;
+    for(size_t i = 0; i < length; i++)
+    {
+        h ^= (unsigned)str[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*!
+ * Returns the slot index that contains given string, or the empty slot it should be put into
+ */
+int StringPool::lookup(const wchar_t* str, size_t length, unsigned h) const
+{
+    unsigned mask = (unsigned)slots.size() - 1;
+    for(unsigned i = h & mask; ; i = (i + 1) & mask)
+    {
+        int slot = slots[i];
+        if(!slot)
+            return (int)i;
+        const Entry& entry = entries[slot - 1];
+        if(entry.hash == h && entry.str->size() == length && !wmemcmp(entry.str->c_str(), str, length))
+            return (int)i;
+    }
+}
+
+void StringPool::grow()
+{
+    std::vector<int> old;
+    old.swap(slots);
+    slots.resize(old.size() * 2, 0);
+    unsigned mask = (unsigned)slots.size() - 1;
+    for(int slot : old)
+    {
+        if(!slot)
+            continue;
+        unsigned i = entries[slot - 1].hash & mask;
+        while(slots[i])
+            i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+int StringPool::intern(const wchar_t* str, size_t length)
+{
+    unsigned h = hash(str, length);
+    int slot = lookup(str, length, h);
+    if(slots[slot])
+        return entries[slots[slot] - 1].id;
+    Entry entry;
+    entry.hash = h;
+    if(shared)
+    {
+        //new to this front, merge it into the shared pool
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        entry.id = shared->intern(str, length);
+        entry.str = &shared->strings[entry.id];
+    }
+    else
+    {
+        entry.id = (int)strings.size();
+        strings.push_back(std::wstring(str, length));
+        entry.str = &strings.back();
+    }
+    //keep load factor under 1/2
+    if((entries.size() + 1) * 2 > slots.size())
+    {
+        grow();
+        slot = lookup(str, length, h);
+    }
+    entries.push_back(entry);
+    slots[slot] = (int)entries.size();
+    return entry.id;
+}
+
+int StringPool::intern(const std::wstring& str)
+{
+    return intern(str.c_str(), str.size());
+}
+
+int StringPool::find(const wchar_t* str, size_t length) const
+{
+    int slot = slots[lookup(str, length, hash(str, length))];
+    if(slot)
+        return entries[slot - 1].id;
+    if(!shared)
+        return -1;
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    return shared->find(str, length);
+}
+
+int StringPool::find(const std::wstring& str) const
+{
+    return find(str.c_str(), str.size());
+}
+
+const std::wstring& StringPool::get(int id) const
+{
+    if(shared)
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        return shared->strings[id];
+    }
+    return strings[id];
+}
+
+int StringPool::size() const
+{
+    return (int)entries.size();
+}
+
+const std::shared_ptr<StringPool>& StringPool::getShared() const
+{
+    return shared;
+}
@@ -28,6 +28,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "common/SwallowUtils.h"
+#include "common/Utf8.h"
+#include "common/MappedFile.h"
 #include <sstream>
 #include <fstream>
 #include <cassert>
@@ -86,21 +88,24 @@ std::vector<std::string> SwallowUtils::readDirectory(const char* path)
 
 std::wstring SwallowUtils::readFile(const char* fileName)
 {
-
-    wifstream wif;
-    wif.open(fileName, istream::in);
-    if(!wif.is_open())
+    return Utf8::decode(readUtf8File(fileName));
+}
+std::string SwallowUtils::readUtf8File(const char* fileName)
+{
+    ifstream f;
+    f.open(fileName, istream::in | istream::binary);
+    if(!f.is_open())
     {
         cerr << "Failed to open swift source file for testing, file name " <<fileName<<endl;
         abort();
     }
-    //wif.imbue(std::locale(std::locale(), new std::codecvt_utf8<wchar_t>));
-    wstringstream wss;
-    assert(!wif.eof() && "Failed to open file.");
-    wss << wif.rdbuf();
-    wstring ret = wss.str();
+    stringstream ss;
+    ss << f.rdbuf();
+    string ret = ss.str();
+    //skip the byte order mark
+    if(ret.compare(0, 3, "\xEF\xBB\xBF") == 0)
+        ret.erase(0, 3);
     return ret;
-
 }
 void SwallowUtils::dumpCompilerResults(const CompilerResults& compilerResults, std::wostream& out)
 {
@@ -116,7 +121,19 @@ void SwallowUtils::dumpCompilerResults(const CompilerResults& compilerResults, s
 
         //separate source code by lines
         vector<wstring> lines;
-        wstringstream stream(res.sourceFile->code);
+        wstring code;
+        if(res.sourceFile)
+            code = res.sourceFile->getCode();
+        if(code.empty() && res.sourceFile && !res.sourceFile->path.empty())
+        {
+            //the file is no longer mapped after parsing, map it again to show the source
+            MappedFile file;
+            if(file.open(res.sourceFile->path.c_str()))
+                Utf8::append(code, file.getData(), file.getData() + file.getSize());
+            if(!code.empty() && code[0] == 0xFEFF)
+                code.erase(0, 1);
+        }
+        wstringstream stream(code);
         wstring line;
         while(getline(stream, line))
         {
@@ -175,21 +192,16 @@ std::wstring SwallowUtils::toString(int i)
     return s.str();
 }
 /*!
- * A simplified approach to convert std::string to std::wstring
+ * Convert UTF-8 encoded std::string to std::wstring
  */
 std::wstring SwallowUtils::toWString(const std::string& str)
 {
-    wstring ret;
-    ret.append(str.begin(), str.end());
-    return ret;
-
+    return Utf8::decode(str);
 }
 /*!
- * A simplified approach to convert std::wstring to std::string
+ * Convert std::wstring to UTF-8 encoded std::string
  */
 std::string SwallowUtils::toString(const std::wstring& str)
 {
-    string ret;
-    ret.append(str.begin(), str.end());
-    return ret;
+    return Utf8::encode(str);
 }
@@ -0,0 +1,124 @@
+/* DeclarationSplitter.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "parser/DeclarationSplitter.h"
+#include "tokenizer/Tokenizer.h"
+USE_SWALLOW_NS
+
+/*!
+ * Check if the token can begin a top-level declaration
+ */
+static bool isDeclarationBegin(const Token& token)
+{
+    if(token.type == TokenType::Attribute)
+        return true;
+    return token.type == TokenType::Identifier && token.identifier.type == KeywordType::Declaration && !token.identifier.backtick;
+}
+
+DeclarationSplitter::DeclarationSplitter()
+{
+}
+
+void DeclarationSplitter::setSourceFile(const SourceFilePtr& sourceFile)
+{
+    this->sourceFile = sourceFile;
+}
+
+bool DeclarationSplitter::split(const wchar_t* code, size_t size, size_t chunkSize, std::vector<int>& chunks)
+{
+    Tokenizer tokenizer(NULL);
+    tokenizer.setView(code, size);
+    return split(tokenizer, code, chunkSize, chunks);
+}
+
+bool DeclarationSplitter::split(const char* code, size_t size, size_t chunkSize, std::vector<int>& chunks)
+{
+    Tokenizer tokenizer(NULL);
+    tokenizer.setUtf8View(code, size);
+    return split(tokenizer, code, chunkSize, chunks);
+}
+
+template<class T>
+bool DeclarationSplitter::split(Tokenizer& tokenizer, const T* code, size_t chunkSize, std::vector<int>& chunks)
+{
+    chunks.clear();
+    chunks.push_back(0);
+    if(sourceFile)
+        sourceFile->comments.clear();
+    tokenizer.setSourceFile(sourceFile);
+    tokenizer.setSkipComments(true);
+    Token token;
+    int depth = 0;
+    int end = 0;
+    //the previous token is a '}' that closes a top-level declaration
+    bool closed = false;
+    try
+    {
+        while(tokenizer.next(token))
+        {
+            int offset = token.state.offset;
+            if(closed && isDeclarationBegin(token) && offset - chunks.back() >= (int)chunkSize)
+            {
+                //the declaration must start a new line
+                for(int i = end; i < offset; i++)
+                {
+                    if(code[i] == '\n')
+                    {
+                        chunks.push_back(offset);
+                        break;
+                    }
+                }
+            }
+            switch(token.type)
+            {
+                case TokenType::OpenBrace:
+                case TokenType::OpenParen:
+                case TokenType::OpenBracket:
+                    depth++;
+                    break;
+                case TokenType::CloseBrace:
+                case TokenType::CloseParen:
+                case TokenType::CloseBracket:
+                    if(depth > 0)
+                        depth--;
+                    break;
+                default:
+                    break;
+            }
+            closed = depth == 0 && token.type == TokenType::CloseBrace;
+            end = tokenizer.save().offset;
+        }
+    }
+    catch(const TokenizerError&)
+    {
+        chunks.resize(1);
+        return false;
+    }
+    return true;
+}
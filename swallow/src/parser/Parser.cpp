@@ -28,12 +28,19 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "parser/Parser.h"
+#include "parser/ParserProfile.h"
 #include "tokenizer/Tokenizer.h"
 #include "ast/NodeFactory.h"
 #include "ast/ast.h"
 #include "common/CompilerResults.h"
 #include "common/Errors.h"
+#include "semantics/SymbolRegistry.h"
+#include "semantics/SymbolScope.h"
+#include "semantics/GlobalScope.h"
+#include "common/StringPool.h"
 #include <memory>
+#include <cstring>
+#include <cwchar>
 using namespace Swallow;
 
 
@@ -41,13 +48,24 @@ Parser::Parser(NodeFactory* nodeFactory, CompilerResults* compilerResults)
     :nodeFactory(nodeFactory), compilerResults(compilerResults)
 {
     tokenizer = new Tokenizer(NULL);
+    //comments never reach parser, they're kept in source file's comment table
+    tokenizer->setSkipComments(true);
+    lookahead.resize(LOOKAHEAD_SIZE);
+    genericVerdicts.resize(GENERIC_VERDICT_SIZE);
+    generation = 0;
+    dropLookahead();
     functionName = L"<top>";
     sourceFile = SourceFilePtr(new SourceFile());
     sourceFile->fileName = L"<code>";
+    tokenizer->setSourceFile(sourceFile);
     flags = 0;
+    symbolRegistry = NULL;
+    profile = NULL;
+    reset((const wchar_t*)NULL, 0);
 }
 Parser::~Parser()
 {
+    detachBodyLoader();
     delete tokenizer;
 }
 
@@ -56,10 +74,47 @@ void Parser::setSourceFile(const SourceFilePtr& sourceFile)
     this->sourceFile = sourceFile;
     tokenizer->setSourceFile(sourceFile);
 }
+void Parser::reset(const SourceFilePtr& sourceFile, CompilerResults* compilerResults)
+{
+    setSourceFile(sourceFile);
+    this->compilerResults = compilerResults;
+    fileOperators.clear();
+    incompleteOperators.clear();
+    sortedOperators.clear();
+    reset((const wchar_t*)NULL, 0);
+}
 void Parser::setFunctionName(const wchar_t* function)
 {
     this->functionName = functionName;
 }
+void Parser::setSymbolRegistry(SymbolRegistry* registry)
+{
+    this->symbolRegistry = registry;
+    bindStringPool();
+}
+
+void Parser::setProfile(ParserProfile* profile)
+{
+    this->profile = profile;
+}
+
+bool Parser::getInfixOperator(int symbol, int& precedence, Associativity::T& associativity)
+{
+    InfixOperatorMap::iterator iter = fileOperators.find(symbol);
+    if(iter != fileOperators.end())
+    {
+        precedence = iter->second.precedence;
+        associativity = iter->second.associativity;
+        return true;
+    }
+    //only the global scope is read, it's shared by parsers of all threads and never changed while parsing
+    OperatorInfo* op = symbolRegistry->getOperator(symbolRegistry->getGlobalScope(), symbol, OperatorType::InfixBinary);
+    if(!op)
+        return false;
+    precedence = op->precedence.infix;
+    associativity = op->associativity;
+    return true;
+}
 int Parser::getFlags() const
 {
     return flags;
@@ -68,6 +123,73 @@ void Parser::setFlags(int flags)
 {
     this->flags = flags;
 }
+const ParserStatistics& Parser::getStatistics() const
+{
+    return statistics;
+}
+/*!
+ * Reset the tokenizer with given code and drop all buffered tokens
+ */
+void Parser::reset(const wchar_t* code, size_t size)
+{
+    this->code = code;
+    this->utf8 = NULL;
+    this->codeSize = size;
+    tokenizer->setView(code, size);
+    //positions are resolved through source file, it needs the line starts of the code
+    //if the code is not the source file's
+    if(code && sourceFile->code.c_str() != code)
+        sourceFile->indexLines(code, size);
+    resetLookahead();
+}
+void Parser::reset(const char* code, size_t size)
+{
+    this->code = NULL;
+    this->utf8 = code;
+    this->codeSize = size;
+    tokenizer->setUtf8View(code, size);
+    if(code && sourceFile->utf8.c_str() != code)
+        sourceFile->indexLines(code, size);
+    resetLookahead();
+}
+/*!
+ * Drop all buffered tokens
+ */
+void Parser::resetLookahead()
+{
+    //bodies skipped from previous code can't be loaded after this
+    detachBodyLoader();
+    //buffered tokens are dropped in constant time, the slots are only cleared when generation wraps
+    if(++generation == 0)
+        dropLookahead();
+    memset(&statistics, 0, sizeof(statistics));
+    bindStringPool();
+}
+void Parser::bindStringPool()
+{
+    StringPoolPtr shared = symbolRegistry ? symbolRegistry->getStringPool() : nodeFactory ? nodeFactory->getStringPool() : nullptr;
+    if(stringPool && stringPool->getShared() == shared)
+        return;
+    //ids of the previous pool mean nothing in the new one
+    fileOperators.clear();
+    stringPool = StringPoolPtr(new StringPool(shared));
+    tokenizer->setStringPool(stringPool.get());
+}
+/*!
+ * Clear all slots of lookahead buffer and generic verdicts, and start from the first generation
+ */
+void Parser::dropLookahead()
+{
+    for(LookaheadSlot& slot : lookahead)
+    {
+        slot.generation = 0;
+    }
+    for(GenericArgumentVerdict& verdict : genericVerdicts)
+    {
+        verdict.generation = 0;
+    }
+    generation = 1;
+}
 /*!
  * Read next token from tokenizer, throw exception if EOF reached.
  */
@@ -78,6 +200,56 @@ void Parser::expect_next(Token& token)
     compilerResults->add(ErrorLevel::Fatal, token.state, Errors::E_UNEXPECTED_EOF);
     throw Abort();
 }
+/*!
+ * Put a lexed token into the lookahead buffer
+ */
+void Parser::storeToken(int cursor, const Token& token, const TokenizerState& end)
+{
+    LookaheadSlot& slot = lookahead[cursor & (LOOKAHEAD_SIZE - 1)];
+    slot.generation = generation;
+    slot.cursor = cursor;
+    slot.contextSensitive = tokenizer->isContextSensitive(token);
+    slot.token = token;
+    slot.end = end;
+}
+/*!
+ * Read next non-comment token, the lookahead buffer will be checked before lexing
+ */
+bool Parser::readToken(Token& token)
+{
+    statistics.tokensRequested++;
+    //Tokens are keyed by the position and context they were lexed from, a token read after
+    //restore/peek will be served from the buffer instead of lexing the same characters again
+    TokenizerState state = tokenizer->save();
+    LookaheadSlot& slot = lookahead[state.offset & (LOOKAHEAD_SIZE - 1)];
+    if(slot.generation == generation && slot.cursor == state.offset
+       && slot.token.state.inStringExpression == state.inStringExpression
+       && (!slot.contextSensitive || slot.token.state.context == state.context))
+    {
+        statistics.lookaheadHits++;
+        //the buffered token may be lexed in another context, keep parser's current context
+        token = slot.token;
+        token.state.context = state.context;
+        TokenizerState end = slot.end;
+        end.context = state.context;
+        tokenizer->restore(end);
+        return true;
+    }
+    while (tokenizer->next(token))
+    {
+        statistics.tokensLexed++;
+        if (token.type == TokenType::Comment)
+            continue;
+        //the token can be requested again from where previous token ends(after next)
+        //or from where the token begins(after peek or restore)
+        TokenizerState end = tokenizer->save();
+        storeToken(state.offset, token, end);
+        if(token.state.offset != state.offset)
+            storeToken(token.state.offset, token, end);
+        return true;
+    }
+    return false;
+}
 /*!
  * Peek next token from tokenizer, return false if EOF reached.
  */
@@ -86,14 +258,10 @@ bool Parser::peek(Token& token)
     token.type = TokenType::_;
     try
     {
-        while (tokenizer->next(token))
-        {
-            if (token.type == TokenType::Comment)
-                continue;
-            tokenizer->restore(token);
-            return true;
-        }
-        return false;
+        if(!readToken(token))
+            return false;
+        tokenizer->restore(token);
+        return true;
     }
     catch(const TokenizerError& e)
     {
@@ -107,10 +275,9 @@ bool Parser::next(Token& token)
 {
     try
     {
-        while (tokenizer->next(token))
+        if(readToken(token))
         {
-            if (token.type == TokenType::Comment)
-                continue;
+            PROFILE_TOKEN();
             return true;
         }
         //eof reached, fill token with end-of-file for compiler error
@@ -119,9 +286,8 @@ bool Parser::next(Token& token)
     }
     catch(const TokenizerError& e)
     {
-        token.state.line = e.line;
-        token.state.column = e.column;
-        token.state.sourceFile = sourceFile;
+        token.state.offset = e.offset;
+        token.state.fileId = sourceFile->id;
         tassert(token, false, e.errorCode, e.item);
         return false;
     }
@@ -131,6 +297,7 @@ bool Parser::next(Token& token)
  */
 void Parser::restore(Token& token)
 {
+    PROFILE_BACKTRACK();
     tokenizer->restore(token);
 }
 /*!
@@ -243,7 +410,7 @@ void Parser::expect_identifier(Token& token)
  */
 void Parser::unexpected(Token& token)
 {
-    token.state.sourceFile = sourceFile;
+    token.state.fileId = sourceFile->id;
     compilerResults->add(ErrorLevel::Fatal, token.state, Errors::E_UNEXPECTED_1, token.token);
     throw Abort();
 }
@@ -263,14 +430,14 @@ void Parser::tassert(Token& token, bool cond, int errorCode, const std::wstring&
 }
 void Parser::error(Token& token, int errorCode, const std::vector<std::wstring>& s)
 {
-    token.state.sourceFile = sourceFile;
+    token.state.fileId = sourceFile->id;
     compilerResults->add(ErrorLevel::Fatal, token.state, errorCode, s);
     throw Abort();
 }
 
 NodePtr Parser::parseStatement(const wchar_t* code)
 {
-    tokenizer->set(code);
+    reset(code, wcslen(code));
     NodePtr ret = NULL;
     try
     {
@@ -295,13 +462,58 @@ ProgramPtr Parser::parse(const wchar_t* code)
 }
 bool Parser::parse(const wchar_t* code, const ProgramPtr& program)
 {
-    tokenizer->set(code);
+    return parse(code, wcslen(code), program);
+}
+bool Parser::parse(const wchar_t* code, size_t size, const ProgramPtr& program)
+{
+    sourceFile->comments.clear();
+    fileOperators.clear();
+    reset(code, size);
+    return parseStatements(program);
+}
+bool Parser::parse(const char* code, size_t size, const ProgramPtr& program)
+{
+    sourceFile->comments.clear();
+    fileOperators.clear();
+    reset(code, size);
+    return parseStatements(program);
+}
+bool Parser::parseChunk(const wchar_t* code, int begin, int end, const ProgramPtr& program)
+{
+    this->code = code;
+    this->utf8 = NULL;
+    this->codeSize = end;
+    tokenizer->setView(code, end);
+    return parseChunk(begin, program);
+}
+bool Parser::parseChunk(const char* code, int begin, int end, const ProgramPtr& program)
+{
+    this->code = NULL;
+    this->utf8 = code;
+    this->codeSize = end;
+    tokenizer->setUtf8View(code, end);
+    return parseChunk(begin, program);
+}
+bool Parser::parseChunk(int begin, const ProgramPtr& program)
+{
+    resetLookahead();
+    fileOperators.clear();
+    TokenizerState state = tokenizer->save();
+    state.offset = begin;
+    tokenizer->restore(state);
+    tokenizer->setRecordComments(false);
+    bool ret = parseStatements(program);
+    tokenizer->setRecordComments(true);
+    return ret;
+}
+bool Parser::parseStatements(const ProgramPtr& program)
+{
     try
     {
         Token token;
         while(peek(token))
         {
-            StatementPtr statement = parseStatement();
+            StatementPtr statement = parseRecoverableStatement();
             if(!statement)
                 break;
             program->addStatement(statement);
@@ -312,5 +524,6 @@ bool Parser::parse(const wchar_t* code, const ProgramPtr& program)
     {
         return false;
     }
-    return true;
+    //the program is kept for error recovery, but the parse is still considered failed
+    return statistics.errorsRecovered == 0;
 }
@@ -0,0 +1,193 @@
+/* ParserProfile.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "parser/ParserProfile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <cstdio>
+
+USE_SWALLOW_NS
+using namespace std;
+
+/*!
+ * Names of productions indexed by id, productions are registered on their first call
+ */
+static vector<const char*> ProductionNames;
+static mutex ProductionNamesLock;
+/*!
+ * AST nodes created by current thread, parsers of different threads are profiled separately
+ */
+static thread_local int Allocations = 0;
+
+ParserProfile::ParserProfile()
+{
+    clear();
+}
+
+bool ParserProfile::isEnabled()
+{
+#ifdef PARSER_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+int ParserProfile::getProductionId(const char* name)
+{
+    lock_guard<mutex> lock(ProductionNamesLock);
+    for(size_t i = 0; i < ProductionNames.size(); i++)
+    {
+        if(!strcmp(ProductionNames[i], name))
+            return (int)i;
+    }
+    ProductionNames.push_back(name);
+    return (int)ProductionNames.size() - 1;
+}
+
+const char* ParserProfile::getProductionName(int id)
+{
+    lock_guard<mutex> lock(ProductionNamesLock);
+    if(id < 0 || id >= (int)ProductionNames.size())
+        return NULL;
+    return ProductionNames[id];
+}
+
+void ParserProfile::countAllocation()
+{
+    Allocations++;
+}
+
+long long ParserProfile::now()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ParserProfile::clear()
+{
+    counters.clear();
+    tokens = 0;
+    backtracks = 0;
+}
+
+void ParserProfile::add(const ParserProfile& profile)
+{
+    if(counters.size() < profile.counters.size())
+        counters.resize(profile.counters.size(), ProductionCounters());
+    for(size_t i = 0; i < profile.counters.size(); i++)
+    {
+        const ProductionCounters& src = profile.counters[i];
+        ProductionCounters& dest = counters[i];
+        dest.calls += src.calls;
+        dest.inclusiveTime += src.inclusiveTime;
+        dest.tokens += src.tokens;
+        dest.allocations += src.allocations;
+        dest.backtracks += src.backtracks;
+    }
+    tokens += profile.tokens;
+    backtracks += profile.backtracks;
+}
+
+int ParserProfile::numProductions() const
+{
+    return counters.size();
+}
+
+const ProductionCounters& ParserProfile::getCounters(int id) const
+{
+    return counters[id];
+}
+
+ProductionCounters& ParserProfile::enter(int id)
+{
+    if(id >= (int)counters.size())
+        counters.resize(id + 1, ProductionCounters());
+    ProductionCounters& ret = counters[id];
+    ret.calls++;
+    ret.depth++;
+    return ret;
+}
+
+ProductionCounters& ParserProfile::leave(int id)
+{
+    ProductionCounters& ret = counters[id];
+    ret.depth--;
+    return ret;
+}
+
+int ParserProfile::getAllocations() const
+{
+    return Allocations;
+}
+
+void ParserProfile::dump(ostream& out, int maxRows) const
+{
+    vector<int> ids;
+    for(size_t i = 0; i < counters.size(); i++)
+    {
+        if(counters[i].calls > 0)
+            ids.push_back(i);
+    }
+    sort(ids.begin(), ids.end(), [this](int a, int b){
+        return counters[a].inclusiveTime > counters[b].inclusiveTime;
+    });
+    if(maxRows > 0 && (int)ids.size() > maxRows)
+        ids.resize(maxRows);
+    char line[256];
+    snprintf(line, sizeof(line), "%-36s %10s %12s %10s %10s %10s\n", "production", "calls", "ms", "tokens", "nodes", "backtracks");
+    out<<line;
+    for(int id : ids)
+    {
+        const ProductionCounters& c = counters[id];
+        snprintf(line, sizeof(line), "%-36s %10d %12.3f %10d %10d %10d\n", getProductionName(id), c.calls,
+                 c.inclusiveTime / 1e6, c.tokens, c.allocations, c.backtracks);
+        out<<line;
+    }
+}
+
+void ParserProfile::dumpJSON(ostream& out) const
+{
+    out<<"[";
+    bool first = true;
+    for(size_t i = 0; i < counters.size(); i++)
+    {
+        const ProductionCounters& c = counters[i];
+        if(c.calls == 0)
+            continue;
+        if(!first)
+            out<<",";
+        first = false;
+        out<<"\n  {\"production\": \""<<getProductionName(i)<<"\", \"calls\": "<<c.calls
+           <<", \"time\": "<<c.inclusiveTime<<", \"tokens\": "<<c.tokens
+           <<", \"nodes\": "<<c.allocations<<", \"backtracks\": "<<c.backtracks<<"}";
+    }
+    out<<"\n]\n";
+}
@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "parser/Parser.h"
+#include "parser/ParserProfile.h"
 #include "ast/NodeFactory.h"
 #include "ast/ast.h"
 
@@ -35,6 +36,7 @@ using namespace Swallow;
 
 void Parser::parseAttributes(std::vector<AttributePtr>& attributes)
 {
+    PROFILE_PRODUCTION();
     attributes.clear();
     while(predicate(L"@"))
     {
@@ -58,6 +60,7 @@ void Parser::parseAttributes(std::vector<AttributePtr>& attributes)
 */
 AttributePtr Parser::parseAttribute()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(L"@", token);
     AttributePtr ret = nodeFactory->createAttribute(token.state);
@@ -78,6 +81,7 @@ AttributePtr Parser::parseAttribute()
 }
 void Parser::parseBalancedToken(const AttributePtr& attr)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     switch(token.type)
@@ -98,6 +102,7 @@ void Parser::parseBalancedToken(const AttributePtr& attr)
 }
 void Parser::parseBalancedTokens(const AttributePtr& attr, const wchar_t* end)
 {
+    PROFILE_PRODUCTION();
     while(!predicate(end))
     {
         parseBalancedToken(attr);
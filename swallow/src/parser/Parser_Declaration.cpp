@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "parser/Parser.h"
+#include "parser/ParserProfile.h"
 #include "tokenizer/Tokenizer.h"
 #include "ast/NodeFactory.h"
 #include "ast/ast.h"
@@ -61,6 +62,7 @@ using namespace Swallow;
 */
 DeclarationPtr Parser::parseDeclaration()
 {
+    PROFILE_PRODUCTION();
     Token token;
     std::vector<AttributePtr> attrs;
     if(predicate(L"@"))
@@ -117,6 +119,7 @@ DeclarationPtr Parser::parseDeclaration()
 
 int Parser::parseDeclarationModifiers()
 {
+    PROFILE_PRODUCTION();
 
     Token token, t;
     int ret = 0;
@@ -243,6 +246,7 @@ void Parser::verifyDeclarationSpecifiers(const Token& token, int actualSpecifier
 */
 DeclarationPtr Parser::parseImport(const std::vector<AttributePtr>& attrs)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Import, token);
     ImportPtr ret = nodeFactory->createImport(token.state);
@@ -306,6 +310,7 @@ DeclarationPtr Parser::parseImport(const std::vector<AttributePtr>& attrs)
 */
 DeclarationPtr Parser::parseLet(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     Flags flag(this, UNDER_LET);
     expect(Keyword::Let, token);
@@ -342,6 +347,7 @@ DeclarationPtr Parser::parseLet(const std::vector<AttributePtr>& attrs, int modi
 
 ValueBindingPtr Parser::parseVariableDeclaration()
 {
+    PROFILE_PRODUCTION();
     Token token;
     Attributes attrs;
     
@@ -390,6 +396,7 @@ ValueBindingPtr Parser::parseVariableDeclaration()
 */
 DeclarationPtr Parser::parseVar(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
 
     Token token;
     expect(Keyword::Var, token);
@@ -470,9 +477,14 @@ DeclarationPtr Parser::parseVar(const std::vector<AttributePtr>& attrs, int modi
                 //‌ variable-declaration → variable-declaration-head variable-name type-annotation code-block
                 CodeBlockPtr getter = nodeFactory->createCodeBlock(token.state);
                 prop->setGetter(getter);
+                if(this->flags & SKIP_BODIES)
+                {
+                    skipStatements(getter);
+                    break;
+                }
                 do
                 {
-                    StatementPtr st = parseStatement();
+                    StatementPtr st = parseRecoverableStatement();
                     getter->addStatement(st);
                 }while(!predicate(L"}"));
                 break;
@@ -488,6 +500,7 @@ willSet-clause → attributes opt willSet setter-name opt code-block
 */
 void Parser::parseWillSetClause(const ComputedPropertyPtr& property, bool opt)
 {
+    PROFILE_PRODUCTION();
     Token token;
     if(!peek(token))
         return;
@@ -505,7 +518,7 @@ void Parser::parseWillSetClause(const ComputedPropertyPtr& property, bool opt)
         property->setWillSetSetter(token.token);
         expect(L")");
     }
-    CodeBlockPtr cb = parseCodeBlock();
+    CodeBlockPtr cb = parseFunctionBody();
     property->setWillSet(cb);
 }
 /*
@@ -513,6 +526,7 @@ void Parser::parseWillSetClause(const ComputedPropertyPtr& property, bool opt)
 */
 void Parser::parseDidSetClause(const ComputedPropertyPtr& property, bool opt)
 {
+    PROFILE_PRODUCTION();
     Token token;
     if(!peek(token))
         return;
@@ -527,7 +541,7 @@ void Parser::parseDidSetClause(const ComputedPropertyPtr& property, bool opt)
         property->setDidSetSetter(token.token);
         expect(L")");
     }
-    CodeBlockPtr cb = parseCodeBlock();
+    CodeBlockPtr cb = parseFunctionBody();
     property->setDidSet(cb);
 }
 
@@ -537,6 +551,7 @@ void Parser::parseDidSetClause(const ComputedPropertyPtr& property, bool opt)
  */
 void Parser::parseWillSetDidSetBlock(const ComputedPropertyPtr& property)
 {
+    PROFILE_PRODUCTION();
     Token token;
     Attributes attrs;
 
@@ -566,6 +581,7 @@ void Parser::parseWillSetDidSetBlock(const ComputedPropertyPtr& property)
 */
 std::pair<CodeBlockPtr, std::pair<std::wstring, CodeBlockPtr> > Parser::parseGetterSetterBlock()
 {
+    PROFILE_PRODUCTION();
     Token token;
     Attributes attrs;
     parseAttributes(attrs);
@@ -579,7 +595,7 @@ std::pair<CodeBlockPtr, std::pair<std::wstring, CodeBlockPtr> > Parser::parseGet
     if(token.getKeyword() == Keyword::Get)
     {
         expect_next(token);
-        getter = parseCodeBlock();
+        getter = parseFunctionBody();
         getter->setAttributes(attrs);
         modifiers = parseAccessorModifiers();
         peek(token);
@@ -595,7 +611,7 @@ std::pair<CodeBlockPtr, std::pair<std::wstring, CodeBlockPtr> > Parser::parseGet
         parseAttributes(attrs);
         modifiers = parseAccessorModifiers();
         expect(Keyword::Get);
-        getter = parseCodeBlock();
+        getter = parseFunctionBody();
         getter->setAttributes(attrs);
     }
     return std::make_pair(getter, setter);
@@ -605,6 +621,7 @@ std::pair<CodeBlockPtr, std::pair<std::wstring, CodeBlockPtr> > Parser::parseGet
 */
 std::pair<std::wstring, CodeBlockPtr> Parser::parseSetterClause()
 {
+    PROFILE_PRODUCTION();
     Token token;
     Attributes attrs;
     expect(Keyword::Set);
@@ -615,7 +632,7 @@ std::pair<std::wstring, CodeBlockPtr> Parser::parseSetterClause()
         expect(L")");
         name = token.token;
     }
-    CodeBlockPtr setter = parseCodeBlock();
+    CodeBlockPtr setter = parseFunctionBody();
     return std::make_pair(name, setter);
 }
 /*
@@ -626,6 +643,7 @@ std::pair<std::wstring, CodeBlockPtr> Parser::parseSetterClause()
 */
 std::pair<CodeBlockPtr, CodeBlockPtr> Parser::parseGetterSetterKeywordBlock()
 {
+    PROFILE_PRODUCTION();
     Token token;
     Attributes attributes;
     CodeBlockPtr getter = NULL;
@@ -672,6 +690,7 @@ std::pair<CodeBlockPtr, CodeBlockPtr> Parser::parseGetterSetterKeywordBlock()
  */
 int Parser::parseAccessorModifiers()
 {
+    PROFILE_PRODUCTION();
     int ret = 0;
     Token token;
     while(next(token))
@@ -703,6 +722,7 @@ int Parser::parseAccessorModifiers()
 */
 DeclarationPtr Parser::parseTypealias(const Attributes& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Typealias, token);
     expect_identifier(token);
@@ -751,6 +771,7 @@ DeclarationPtr Parser::parseTypealias(const Attributes& attrs, int modifiers)
 */
 DeclarationPtr Parser::parseFunc(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Func, token);
     FunctionDefPtr ret = nodeFactory->createFunction(token.state);
@@ -796,7 +817,7 @@ DeclarationPtr Parser::parseFunc(const std::vector<AttributePtr>& attrs, int mod
     if(hasBody)
     {
         ENTER_CONTEXT(TokenizerContextFunctionBody);
-        CodeBlockPtr body = parseCodeBlock();
+        CodeBlockPtr body = parseFunctionBody();
         ret->setBody(body);
     }
     else
@@ -821,6 +842,7 @@ DeclarationPtr Parser::parseFunc(const std::vector<AttributePtr>& attrs, int mod
 */
 ParametersNodePtr Parser::parseParameterClause()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(L"(", token);
     ParametersNodePtr ret = nodeFactory->createParameters(token.state);
@@ -908,6 +930,7 @@ ParametersNodePtr Parser::parseParameterClause()
 */
 DeclarationPtr Parser::parseEnum(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Enum);
     Flags flag(this);
@@ -942,8 +965,9 @@ DeclarationPtr Parser::parseEnum(const std::vector<AttributePtr>& attrs, int mod
     {
         if(!match(Keyword::Case))
         {
-            DeclarationPtr decl = parseDeclaration();
-            ret->addDeclaration(decl);
+            DeclarationPtr decl = parseRecoverableDeclaration();
+            if(decl)
+                ret->addDeclaration(decl);
             continue;
         }
         //parse cases
@@ -985,6 +1009,7 @@ DeclarationPtr Parser::parseEnum(const std::vector<AttributePtr>& attrs, int mod
 */
 DeclarationPtr Parser::parseStruct(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Struct, token);
     StructDefPtr ret = nodeFactory->createStruct(token.state);
@@ -1019,8 +1044,9 @@ DeclarationPtr Parser::parseStruct(const std::vector<AttributePtr>& attrs, int m
     expect(L"{");
     while(!predicate(L"}"))
     {
-        DeclarationPtr decl = parseDeclaration();
-        ret->addDeclaration(decl);
+        DeclarationPtr decl = parseRecoverableDeclaration();
+        if(decl)
+            ret->addDeclaration(decl);
         match(L";");
     }
     expect(L"}");
@@ -1037,6 +1063,7 @@ DeclarationPtr Parser::parseStruct(const std::vector<AttributePtr>& attrs, int m
 */
 DeclarationPtr Parser::parseClass(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Class, token);
     ClassDefPtr ret = nodeFactory->createClass(token.state);
@@ -1068,8 +1095,9 @@ DeclarationPtr Parser::parseClass(const std::vector<AttributePtr>& attrs, int mo
     expect(L"{");
     while(!predicate(L"}"))
     {
-        DeclarationPtr decl = parseDeclaration();
-        ret->addDeclaration(decl);
+        DeclarationPtr decl = parseRecoverableDeclaration();
+        if(decl)
+            ret->addDeclaration(decl);
     }
     expect(L"}");
     //sort member declarations by priority
@@ -1115,6 +1143,7 @@ DeclarationPtr Parser::parseClass(const std::vector<AttributePtr>& attrs, int mo
 */
 DeclarationPtr Parser::parseProtocol(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Protocol);
     ProtocolDefPtr ret = nodeFactory->createProtocol(token.state);
@@ -1142,8 +1171,9 @@ DeclarationPtr Parser::parseProtocol(const std::vector<AttributePtr>& attrs, int
     
     while(!predicate(L"}"))
     {
-        DeclarationPtr decl = parseDeclaration();
-        ret->addDeclaration(decl);
+        DeclarationPtr decl = parseRecoverableDeclaration();
+        if(decl)
+            ret->addDeclaration(decl);
     }
     expect(L"}");
     return ret;
@@ -1158,6 +1188,7 @@ DeclarationPtr Parser::parseProtocol(const std::vector<AttributePtr>& attrs, int
 */
 DeclarationPtr Parser::parseInit(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Init, token);
     bool failable = false, implicitFailable = false;
@@ -1189,7 +1220,7 @@ DeclarationPtr Parser::parseInit(const std::vector<AttributePtr>& attrs, int mod
     else
     {
         ENTER_CONTEXT(TokenizerContextFunctionBody);
-        CodeBlockPtr body = parseCodeBlock();
+        CodeBlockPtr body = parseFunctionBody();
         ret->setBody(body);
     }
     return ret;
@@ -1201,6 +1232,7 @@ DeclarationPtr Parser::parseInit(const std::vector<AttributePtr>& attrs, int mod
 */
 DeclarationPtr Parser::parseDeinit(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Deinit, token);
     DeinitializerDefPtr ret = nodeFactory->createDeinitializer(token.state);
@@ -1212,7 +1244,7 @@ DeclarationPtr Parser::parseDeinit(const std::vector<AttributePtr>& attrs, int m
     }
     else
     {
-        CodeBlockPtr body = parseCodeBlock();
+        CodeBlockPtr body = parseFunctionBody();
         ret->setBody(body);
     }
     return ret;
@@ -1225,6 +1257,7 @@ DeclarationPtr Parser::parseDeinit(const std::vector<AttributePtr>& attrs, int m
 */
 DeclarationPtr Parser::parseExtension(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     Flags flags(this, UNDER_EXTENSION);
     expect(Keyword::Extension, token);
@@ -1248,8 +1281,9 @@ DeclarationPtr Parser::parseExtension(const std::vector<AttributePtr>& attrs, in
 
     while(!predicate(L"}"))
     {
-        DeclarationPtr decl = parseDeclaration();
-        ret->addDeclaration(decl);
+        DeclarationPtr decl = parseRecoverableDeclaration();
+        if(decl)
+            ret->addDeclaration(decl);
     }
     expect(L"}");
     return ret;
@@ -1266,6 +1300,7 @@ DeclarationPtr Parser::parseExtension(const std::vector<AttributePtr>& attrs, in
 */
 DeclarationPtr Parser::parseSubscript(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Subscript, token);
     ParametersNodePtr params = parseParameterClause();
@@ -1311,7 +1346,7 @@ DeclarationPtr Parser::parseSubscript(const std::vector<AttributePtr>& attrs, in
         else
         {
             tokenizer->restore(s);
-            CodeBlockPtr cb = parseCodeBlock();
+            CodeBlockPtr cb = parseFunctionBody();
             ret->setGetter(cb);
         }
     }
@@ -1333,6 +1368,7 @@ DeclarationPtr Parser::parseSubscript(const std::vector<AttributePtr>& attrs, in
 */
 DeclarationPtr Parser::parseOperator(const std::vector<AttributePtr>& attrs, int modifiers)
 {
+    PROFILE_PRODUCTION();
     Token token;
     //validate modifiers
     if((modifiers & (DeclarationModifiers::Prefix | DeclarationModifiers::Postfix | DeclarationModifiers::Infix)) == 0)
@@ -1360,6 +1396,7 @@ DeclarationPtr Parser::parseOperator(const std::vector<AttributePtr>& attrs, int
     tassert(token, token.type == TokenType::Operator, Errors::E_EXPECT_OPERATOR_1, token.token);
     op->setName(token.token);
     op->setType(type);
+    int symbol = token.symbol;
     expect(L"{");
     while(!match(L"}"))
     {
@@ -1396,5 +1433,12 @@ DeclarationPtr Parser::parseOperator(const std::vector<AttributePtr>& attrs, int
                 unexpected(token);
         }
     }
+    if(type == OperatorType::InfixBinary)
+    {
+        //expressions after the declaration can be built in precedence order
+        InfixOperator& info = fileOperators[symbol];
+        info.precedence = op->getPrecedence();
+        info.associativity = op->getAssociativity();
+    }
     return op;
 }
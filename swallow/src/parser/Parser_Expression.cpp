@@ -28,11 +28,13 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "parser/Parser.h"
+#include "parser/ParserProfile.h"
 #include "parser/Parser_Details.h"
 #include "tokenizer/Tokenizer.h"
 #include "ast/NodeFactory.h"
 #include "ast/ast.h"
 #include "common/Errors.h"
+#include "common/StringPool.h"
 
 
 
@@ -40,6 +42,7 @@ using namespace Swallow;
 
 ExpressionPtr Parser::parseFloat()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     FloatLiteralPtr ret = nodeFactory->createFloat(token.state);
@@ -49,6 +52,7 @@ ExpressionPtr Parser::parseFloat()
 }
 ExpressionPtr Parser::parseInteger()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     IntegerLiteralPtr ret = nodeFactory->createInteger(token.state);
@@ -68,6 +72,7 @@ static void appendString(NodeFactory* nodeFactory, const StringInterpolationPtr&
 }
 ExpressionPtr Parser::parseString()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     if(!token.string.expressionFollowed)
@@ -97,13 +102,14 @@ ExpressionPtr Parser::parseString()
  */
 ExpressionPtr Parser::parsePrefixExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     if(match(L"&"))
     {
         //in-out-expression → & identifier
         expect_identifier(token);
         IdentifierPtr identifier = nodeFactory->createIdentifier(token.state);
-        identifier->setIdentifier(token.token);
+        identifier->setIdentifier(token.token, token.symbol);
         InOutParameterNode ret = nodeFactory->createInOutParameter(token.state);
         ret->setOperand(identifier);
         return ret;
@@ -139,6 +145,7 @@ ExpressionPtr Parser::parsePrefixExpression()
  */
 ExpressionPtr Parser::parsePostfixExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     // postfix-expression → primary-expression
     ExpressionPtr ret =  parsePrimaryExpression();
@@ -190,7 +197,7 @@ ExpressionPtr Parser::parsePostfixExpression()
             else
             {
                 IdentifierPtr field = nodeFactory->createIdentifier(token.state);
-                field->setIdentifier(token.token);
+                field->setIdentifier(token.token, token.symbol);
                 access->setField(field);
             }
             ret = access;
@@ -273,6 +280,7 @@ ExpressionPtr Parser::parsePostfixExpression()
  */
 FunctionCallPtr Parser::parseFunctionCallExpression()
 {
+    PROFILE_PRODUCTION();
     FunctionCallPtr ret = nodeFactory->createFunctionCall(tokenizer->save());
     if(predicate(L"("))
     {
@@ -307,6 +315,7 @@ FunctionCallPtr Parser::parseFunctionCallExpression()
  */
 ExpressionPtr Parser::parsePrimaryExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     peek(token);
     if(token.type == TokenType::Identifier)
@@ -355,7 +364,7 @@ ExpressionPtr Parser::parsePrimaryExpression()
     {
         expect_next(token);
         IdentifierPtr id = nodeFactory->createIdentifier(token.state);
-        id->setIdentifier(L"_");
+        id->setIdentifier(L"_", stringPool->intern(L"_"));
         return id;
     }
     
@@ -371,7 +380,7 @@ ExpressionPtr Parser::parsePrimaryExpression()
         expect_next(token);
         expect_identifier(token);
         IdentifierPtr field = nodeFactory->createIdentifier(token.state);
-        field->setIdentifier(token.token);
+        field->setIdentifier(token.token, token.symbol);
         MemberAccessPtr ret = nodeFactory->createMemberAccess(token.state);
         ret->setField(field);
         return ret;
@@ -379,8 +388,45 @@ ExpressionPtr Parser::parsePrimaryExpression()
     return NULL;
 }
 
+/*!
+ * Check if the token can be a part of generic argument clause
+ */
+static bool isGenericArgumentToken(const Token& t)
+{
+    switch(t.type)
+    {
+        case TokenType::Identifier:
+            switch(t.identifier.keyword)
+            {
+                case Keyword::_:
+                case Keyword::SelfType:
+                case Keyword::Type:
+                case Keyword::Protocol:
+                case Keyword::Inout:
+                    return true;
+                default:
+                    return false;
+            }
+        case TokenType::Operator:
+            return t == L"<" || t == L">" || t == L"->" || t == L"!" || t == L"?" || t == L"...";
+        case TokenType::Optional:
+        case TokenType::Dot:
+        case TokenType::Attribute:
+        case TokenType::Colon:
+        case TokenType::Comma:
+        case TokenType::OpenParen:
+        case TokenType::CloseParen:
+        case TokenType::OpenBracket:
+        case TokenType::CloseBracket:
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool Parser::isGenericArgument()
 {
+    PROFILE_PRODUCTION();
     /*
     if(!(this->flags & ENABLE_GENERIC))
         return false;
@@ -391,12 +437,23 @@ bool Parser::isGenericArgument()
         restore(token);
         return false;
     }
+    //the same '<' can be checked again after backtracking, reuse the verdict
+    GenericArgumentVerdict& verdict = genericVerdicts[token.state.offset & (GENERIC_VERDICT_SIZE - 1)];
+    if(verdict.generation == generation && verdict.offset == token.state.offset)
+    {
+        restore(token);
+        return verdict.generic;
+    }
+    //The clause only contains types, stop at the first token that cannot appear in a type
+    //or at the scan limit, so a chain of comparisons will not be scanned to its end for each '<'
     int nestedLevel = 1;
+    int brackets = 0;
     bool ret = false;
-    while(true)
+    for(int i = 0; i < MAX_GENERIC_ARGUMENT_TOKENS; i++)
     {
-        if(!next(t))
+        if(!next(t) || !isGenericArgumentToken(t))
             break;
+        statistics.genericLookaheadTokens++;
         if(t == L"<")
             nestedLevel ++;
         else if(t == L">")
@@ -408,10 +465,18 @@ bool Parser::isGenericArgument()
                 break;
             }
         }
-        else if(t.type == TokenType::OpenBrace)
-            break;
+        else if(t.type == TokenType::OpenParen || t.type == TokenType::OpenBracket)
+            brackets++;
+        else if(t.type == TokenType::CloseParen || t.type == TokenType::CloseBracket)
+        {
+            if(--brackets < 0)
+                break;
+        }
     }
     restore(token);
+    verdict.generation = generation;
+    verdict.offset = token.state.offset;
+    verdict.generic = ret;
     return ret;
 }
 /*
@@ -423,6 +488,7 @@ bool Parser::isGenericArgument()
 */
 GenericArgumentDefPtr Parser::parseGenericArgumentDef()
 {
+    PROFILE_PRODUCTION();
     Token token;
     ENTER_CONTEXT(TokenizerContextType);
     expect(L"<", token);
@@ -447,6 +513,7 @@ GenericArgumentDefPtr Parser::parseGenericArgumentDef()
  */
 ParenthesizedExpressionPtr Parser::parseParenthesizedExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     match(L"(", token);
     ParenthesizedExpressionPtr ret = nodeFactory->createParenthesizedExpression(token.state);
@@ -467,6 +534,7 @@ ParenthesizedExpressionPtr Parser::parseParenthesizedExpression()
 
 void Parser::parseExpressionItem(const ParenthesizedExpressionPtr& parent)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     if(token.type == TokenType::Identifier && token.identifier.keyword == Keyword::_ && match(L":"))
@@ -493,11 +561,12 @@ void Parser::parseExpressionItem(const ParenthesizedExpressionPtr& parent)
  */
 ExpressionPtr Parser::parseSelfExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Self);
     expect_next(token);
     IdentifierPtr self = nodeFactory->createIdentifier(token.state);
-    self->setIdentifier(L"self");
+    self->setIdentifier(L"self", stringPool->intern(L"self"));
     if(token == L".")
     {
         expect_next(token);
@@ -505,7 +574,7 @@ ExpressionPtr Parser::parseSelfExpression()
         if(token.identifier.keyword != Keyword::_ && token.identifier.keyword != Keyword::Init)
             unexpected(token);
         IdentifierPtr field = nodeFactory->createIdentifier(token.state);
-        field->setIdentifier(token.token);
+        field->setIdentifier(token.token, token.symbol);
         MemberAccessPtr ret = nodeFactory->createMemberAccess(token.state);
         ret->setField(field);
         ret->setSelf(self);
@@ -539,10 +608,11 @@ ExpressionPtr Parser::parseSelfExpression()
  */
 ExpressionPtr Parser::parseSuperExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Super, token);
     IdentifierPtr super = nodeFactory->createIdentifier(token.state);
-    super->setIdentifier(L"super");
+    super->setIdentifier(L"super", stringPool->intern(L"super"));
     expect_next(token);
     if(token == L".")
     {
@@ -552,7 +622,7 @@ ExpressionPtr Parser::parseSuperExpression()
         if(token.identifier.keyword != Keyword::_ && token.identifier.keyword != Keyword::Init)
             unexpected(token);
         IdentifierPtr field = nodeFactory->createIdentifier(token.state);
-        field->setIdentifier(token.token);
+        field->setIdentifier(token.token, token.symbol);
         MemberAccessPtr ret = nodeFactory->createMemberAccess(token.state);
         ret->setSelf(super);
         ret->setField(field);
@@ -579,10 +649,11 @@ ExpressionPtr Parser::parseSuperExpression()
 
 IdentifierPtr Parser::parseIdentifier()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_identifier(token);
     IdentifierPtr ret = nodeFactory->createIdentifier(token.state);
-    ret->setIdentifier(token.token);
+    ret->setIdentifier(token.token, token.symbol);
     
     if(isGenericArgument())
     {
@@ -606,6 +677,7 @@ IdentifierPtr Parser::parseIdentifier()
  */
 ExpressionPtr Parser::parseLiteralExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     // literal-expression → literal
@@ -639,11 +711,19 @@ ExpressionPtr Parser::parseLiteralExpression()
         if(token.type == TokenType::Comma || token.type == TokenType::CloseBracket)//array
         {
             ArrayLiteralPtr array = nodeFactory->createArrayLiteral(token.state);
-            array->push(ExpressionPtr(tmp));
+            if(!array->getLiterals().add(tmp))
+                array->push(ExpressionPtr(tmp));
             while(match(L","))
             {
                 if(predicate(L"]"))
                     break;
+                //plain literals are kept in columns without creating nodes
+                Token literal;
+                if(array->canCompact() && parsePlainLiteral(literal, false))
+                {
+                    appendLiteral(array->getLiterals(), literal);
+                    continue;
+                }
                 tmp = parseExpression();
                 array->push(ExpressionPtr(tmp));
             }
@@ -657,11 +737,28 @@ ExpressionPtr Parser::parseLiteralExpression()
             ExpressionPtr key = tmp;
             ExpressionPtr value = parseExpression();
             tassert(token, value != NULL, Errors::E_EXPECT_EXPRESSION_1, token.token);
-            dict->insert(key, value);
+            LiteralColumns& keys = dict->getLiteralKeys();
+            if(!keys.add(key) || !dict->getLiteralValues().add(value))
+            {
+                keys.clear();
+                dict->insert(key, value);
+            }
             while(match(L","))
             {
                 if(predicate(L"]"))
                     break;
+                Token k, v;
+                if(dict->canCompact() && parsePlainLiteral(k, true))
+                {
+                    expect(L":");
+                    if(parsePlainLiteral(v, false))
+                    {
+                        appendLiteral(dict->getLiteralKeys(), k);
+                        appendLiteral(dict->getLiteralValues(), v);
+                        continue;
+                    }
+                    restore(k);
+                }
                 key = parseExpression();
                 expect(L":");
                 value = parseExpression();
@@ -686,8 +783,10 @@ ExpressionPtr Parser::parseLiteralExpression()
             }
             case Keyword::Line:
             {
+                int line, column;
+                sourceFile->getPosition(token.state.offset, line, column);
                 std::wstringstream ss;
-                ss<<token.state.column;
+                ss<<column;
                 CompileConstantPtr c = nodeFactory->createCompilecConstant(token.state);
                 c->setName(L"__LINE__");
                 c->setValue(ss.str());
@@ -695,8 +794,10 @@ ExpressionPtr Parser::parseLiteralExpression()
             }
             case Keyword::Column:
             {
+                int line, column;
+                sourceFile->getPosition(token.state.offset, line, column);
                 std::wstringstream ss;
-                ss<<token.state.line;
+                ss<<line;
                 CompileConstantPtr c = nodeFactory->createCompilecConstant(token.state);
                 c->setName(L"__COLUMN__");
                 c->setValue(ss.str());
@@ -717,8 +818,46 @@ ExpressionPtr Parser::parseLiteralExpression()
     unexpected(token);
     return NULL;
 }
+bool Parser::parsePlainLiteral(Token& token, bool dictionaryKey)
+{
+    PROFILE_PRODUCTION();
+    if(!next(token))
+        return false;
+    bool plain = token.type == TokenType::Integer || token.type == TokenType::Float
+        || (token.type == TokenType::String && !token.string.expressionFollowed);
+    if(plain)
+    {
+        //the literal must not be an operand of other expressions
+        Token t;
+        if(peek(t))
+        {
+            if(dictionaryKey ? t.type == TokenType::Colon : (t.type == TokenType::Comma || t.type == TokenType::CloseBracket))
+                return true;
+        }
+    }
+    restore(token);
+    return false;
+}
+
+void Parser::appendLiteral(LiteralColumns& columns, const Token& token)
+{
+    switch(token.type)
+    {
+        case TokenType::Integer:
+            columns.addInteger(token.state.offset, token.token, token.number.value);
+            break;
+        case TokenType::Float:
+            columns.addFloat(token.state.offset, token.token, token.number.dvalue);
+            break;
+        default:
+            columns.addString(token.state.offset, token.token);
+            break;
+    }
+}
+
 ExpressionPtr Parser::parseLiteral()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     switch(token.type)
@@ -772,6 +911,7 @@ ExpressionPtr Parser::parseLiteral()
 }
 std::pair<ExpressionPtr, ExpressionPtr> Parser::parseDictionaryLiteralItem()
 {
+    PROFILE_PRODUCTION();
     ExpressionPtr key = parseExpression();
     expect(L":");
     ExpressionPtr value = parseExpression();
@@ -802,12 +942,17 @@ static inline bool isBinaryExpr(const Token& token)
  */
 ExpressionPtr Parser::parseExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     ExpressionPtr ret = parsePrefixExpression();
     peek(token);
     
     //‌ binary-expressions → binary-expressionbinary-expressionsopt
-    if(isBinaryExpr(token))
+    if(isBinaryExpr(token) && symbolRegistry)
+    {
+        ret = parseSortedExpression(ret);
+    }
+    else if(isBinaryExpr(token))
     {
         ret = parseBinaryExpression(ret);
         for(bool succ = peek(token); succ && isBinaryExpr(token); succ = peek(token))
@@ -818,6 +963,95 @@ ExpressionPtr Parser::parseExpression()
 
     return ret;
 }
+/*!
+ * Build the binary expressions by precedence climbing, the operators whose right operand
+ * is not complete are kept in a stack, an operator is completed when an operator that
+ * binds looser arrives, in the same way as OperatorResolver::rotateRequired decides.
+ * Conditional operator and 'as?' take the whole expression before them as lhs like the
+ * left-leaning tree does, they're never rotated by OperatorResolver.
+ */
+ExpressionPtr Parser::parseSortedExpression(const ExpressionPtr& lhs)
+{
+    PROFILE_PRODUCTION();
+    Token token;
+    ScratchFrame<BinaryOperatorPtr> incomplete(incompleteOperators);
+    ScratchFrame<BinaryOperatorPtr> operators(sortedOperators);
+    ExpressionPtr operand = lhs;
+    for(bool succ = peek(token); succ && isBinaryExpr(token); succ = peek(token))
+    {
+        int precedence = -1;
+        Associativity::T associativity = Associativity::None;
+        bool infix = token.type == TokenType::Operator && (token == L"=" || token.operators.type == OperatorType::InfixBinary);
+        bool known = infix && getInfixOperator(token.symbol, precedence, associativity);
+        BinaryOperatorPtr cast;
+        if(token.type == TokenType::Identifier)
+        {
+            //type-casting operator is complete after its type, it binds its lhs by the precedence of 'is' or 'as'
+            cast = std::static_pointer_cast<BinaryOperator>(parseBinaryExpression(nullptr));
+            known = getInfixOperator(stringPool->intern(cast->getOperator()), precedence, associativity);
+        }
+        //complete the operators that bind tighter, all of them if it's not a known operator
+        while(!incomplete.empty())
+        {
+            const BinaryOperatorPtr& top = incompleteOperators.back();
+            if(top->getPrecedence() < precedence)
+                break;
+            if(top->getPrecedence() == precedence && top->getAssociativity() == Associativity::Right)
+                break;
+            top->setRHS(operand);
+            operand = top;
+            incompleteOperators.pop_back();
+        }
+        if(infix && !known)
+        {
+            //the operator may be declared later or in another file, leave the rest to OperatorResolver
+            for(succ = peek(token); succ && isBinaryExpr(token); succ = peek(token))
+            {
+                operand = parseBinaryExpression(operand);
+            }
+            return operand;
+        }
+        if(cast)
+        {
+            cast->setLHS(operand);
+            operand = cast;
+            if(known)
+                sortedOperators.push_back(cast);
+            continue;
+        }
+        if(!infix)
+        {
+            operand = parseBinaryExpression(operand);
+            continue;
+        }
+        expect_next(token);
+        BinaryOperatorPtr op;
+        if(token == L"=")
+            op = nodeFactory->createAssignment(token.state);
+        else
+        {
+            op = nodeFactory->createBinary(token.state);
+            op->setOperator(token.token);
+        }
+        op->setPrecedence(precedence);
+        op->setAssociativity(associativity);
+        op->setLHS(operand);
+        incompleteOperators.push_back(op);
+        sortedOperators.push_back(op);
+        operand = parsePrefixExpression();
+    }
+    while(!incomplete.empty())
+    {
+        incompleteOperators.back()->setRHS(operand);
+        operand = incompleteOperators.back();
+        incompleteOperators.pop_back();
+    }
+    for(size_t i = operators.base; i < sortedOperators.size(); i++)
+    {
+        sortedOperators[i]->setSorted(true);
+    }
+    return operand;
+}
 /*
  GRAMMAR OF A BINARY EXPRESSION
  
@@ -828,6 +1062,7 @@ ExpressionPtr Parser::parseExpression()
  */
 ExpressionPtr Parser::parseBinaryExpression(const ExpressionPtr& lhs)
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     if(token.type == TokenType::Identifier)
@@ -918,6 +1153,7 @@ ExpressionPtr Parser::parseBinaryExpression(const ExpressionPtr& lhs)
 */
 ClosurePtr Parser::parseClosureExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(L"{", token);
     ClosurePtr ret = nodeFactory->createClosure(token.state);
@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "parser/Parser.h"
+#include "parser/ParserProfile.h"
 #include "parser/Parser_Details.h"
 #include "ast/NodeFactory.h"
 #include "ast/ast.h"
@@ -46,6 +47,7 @@ using namespace Swallow;
 */
 PatternPtr Parser::parsePattern()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     if(token.type == TokenType::Identifier)
@@ -57,7 +59,7 @@ PatternPtr Parser::parsePattern()
             case Keyword::_:
             {
                 IdentifierPtr id = nodeFactory->createIdentifier(token.state);
-                id->setIdentifier(token.token);
+                id->setIdentifier(token.token, token.symbol);
                 if((flags & UNDER_CASE) == 0)//type annotation is not parsed when it's inside a let/var
                 {
                     if(match(L":"))
@@ -147,6 +149,7 @@ PatternPtr Parser::parsePattern()
 */
 PatternPtr Parser::parseEnumPattern()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(L".");
     expect_identifier(token);
@@ -169,6 +172,7 @@ PatternPtr Parser::parseEnumPattern()
 */
 PatternPtr Parser::parseTypeCastingPattern()
 {
+    PROFILE_PRODUCTION();
     Token token;
     if(match(Keyword::Is, token))
     {
@@ -194,6 +198,7 @@ PatternPtr Parser::parseTypeCastingPattern()
  */
 PatternPtr Parser::parseTuple()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(L"(", token);
     TuplePtr ret = nodeFactory->createTuple(token.state);
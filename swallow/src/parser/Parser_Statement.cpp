@@ -28,14 +28,95 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "parser/Parser.h"
+#include "parser/ParserProfile.h"
 #include "parser/Parser_Details.h"
 #include "ast/NodeFactory.h"
 #include "ast/ast.h"
 #include "common/Errors.h"
 #include "tokenizer/Tokenizer.h"
+#include "common/ScopedValue.h"
 #include <cassert>
+#include <algorithm>
 using namespace Swallow;
 
+SWALLOW_NS_BEGIN
+/*!
+ * Loads the bodies skipped by a parser, they are parsed from the same code by a parser
+ * created on the first load.
+ * The code is shared with the source file when it's the source file's buffer, otherwise
+ * it's copied, so the caller's buffer can go away after the parse.
+ * The node factory, compiler results and symbol registry are borrowed from the parser
+ * that skipped the bodies, the loader is detached when that parser is reset or destroyed,
+ * so the bodies must be loaded before that, e.g. by the semantic analysis of the same compilation.
+ */
+class LazyBodyLoader : public CodeBlockLoader, public std::enable_shared_from_this<LazyBodyLoader>
+{
+public:
+    LazyBodyLoader(Parser* skipper)
+        :nodeFactory(skipper->nodeFactory), compilerResults(skipper->compilerResults), sourceFile(skipper->sourceFile),
+         symbolRegistry(skipper->symbolRegistry), fileOperators(skipper->fileOperators),
+         code(skipper->code), utf8(skipper->utf8), size(skipper->codeSize), parser(NULL)
+    {
+        if(utf8 && utf8 != sourceFile->utf8.c_str())
+        {
+            utf8Copy.assign(utf8, size);
+            utf8 = utf8Copy.c_str();
+        }
+        else if(code && code != sourceFile->code.c_str())
+        {
+            codeCopy.assign(code, size);
+            code = codeCopy.c_str();
+        }
+    }
+    ~LazyBodyLoader()
+    {
+        delete parser;
+    }
+public:
+    virtual void load(CodeBlock* block)
+    {
+        assert(nodeFactory != NULL && "Skipped bodies must be loaded before their parser is reset or destroyed");
+        if(!nodeFactory)
+            throw Abort();
+        if(!parser)
+        {
+            parser = new Parser(nodeFactory, compilerResults);
+            parser->setSourceFile(sourceFile);
+            parser->setSymbolRegistry(symbolRegistry);
+            parser->fileOperators = fileOperators;
+            if(utf8)
+                parser->reset(utf8, size);
+            else
+                parser->reset(code, size);
+        }
+        parser->parseLazyBody(block, shared_from_this());
+    }
+    /*!
+     * Drop everything borrowed from the parser that skipped the bodies
+     */
+    void detach()
+    {
+        delete parser;
+        parser = NULL;
+        nodeFactory = NULL;
+        compilerResults = NULL;
+        symbolRegistry = NULL;
+    }
+private:
+    NodeFactory* nodeFactory;
+    CompilerResults* compilerResults;
+    SourceFilePtr sourceFile;
+    SymbolRegistry* symbolRegistry;
+    Parser::InfixOperatorMap fileOperators;
+    const wchar_t* code;
+    const char* utf8;
+    size_t size;
+    std::wstring codeCopy;
+    std::string utf8Copy;
+    Parser* parser;
+};
+SWALLOW_NS_END
+
 /*
  statement → expression;opt
 ‌ statement → declaration;opt
@@ -47,6 +128,7 @@ using namespace Swallow;
 */
 StatementPtr Parser::parseStatement()
 {
+    PROFILE_PRODUCTION();
     Token token;
     if(peek(token))
     {
@@ -123,6 +205,7 @@ StatementPtr Parser::parseStatement()
 }
 StatementPtr Parser::parseLoopStatement()
 {
+    PROFILE_PRODUCTION();
     Token token;
     if(peek(token))
     {
@@ -152,6 +235,7 @@ StatementPtr Parser::parseLoopStatement()
 */
 StatementPtr Parser::parseForLoop()
 {
+    PROFILE_PRODUCTION();
     //check if it's a for-in loop
     Token token, t;
     expect(Keyword::For, token);
@@ -180,6 +264,7 @@ StatementPtr Parser::parseForLoop()
 */
 StatementPtr Parser::parseForIn()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::For, token);
     ForInLoopPtr ret = nodeFactory->createForInLoop(token.state);
@@ -205,6 +290,7 @@ StatementPtr Parser::parseForIn()
 }
 StatementPtr Parser::parseForStatement()
 {
+    PROFILE_PRODUCTION();
     std::vector<ExpressionPtr> inits;
 
     //‌ for-statement → forfor-initopt;expressionopt;expressionoptcode-block
@@ -278,6 +364,7 @@ StatementPtr Parser::parseForStatement()
 */
 StatementPtr Parser::parseWhileLoop()
 {
+    PROFILE_PRODUCTION();
     Token token;
     Flags flags(this, SUPPRESS_TRAILING_CLOSURE);
     expect(Keyword::While, token);
@@ -292,6 +379,7 @@ StatementPtr Parser::parseWhileLoop()
 //“while-condition → expression  declaration”
 ExpressionPtr Parser::parseConditionExpression()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     if(token.type == TokenType::Identifier && token.identifier.keyword != Keyword::_)
@@ -331,6 +419,7 @@ ExpressionPtr Parser::parseConditionExpression()
 */
 StatementPtr Parser::parseDoLoop()
 {
+    PROFILE_PRODUCTION();
     Token token;
     Flags flags(this, SUPPRESS_TRAILING_CLOSURE);
     expect(Keyword::Do, token);
@@ -351,6 +440,7 @@ StatementPtr Parser::parseDoLoop()
  */
 IfStatementPtr Parser::parseIf()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::If, token);
     IfStatementPtr ret = nodeFactory->createIf(token.state);
@@ -399,6 +489,7 @@ IfStatementPtr Parser::parseIf()
 */
 StatementPtr Parser::parseSwitch()
 {
+    PROFILE_PRODUCTION();
     Token token;
     Flags flags(this, UNDER_SWITCH_CASE | SUPPRESS_TRAILING_CLOSURE);
     
@@ -462,6 +553,7 @@ StatementPtr Parser::parseSwitch()
 }
 void Parser::parseSwitchStatements(const CaseStatementPtr& case_)
 {
+    PROFILE_PRODUCTION();
     Token token;
     Flags flags(this);
     flags -= SUPPRESS_TRAILING_CLOSURE;
@@ -489,6 +581,7 @@ void Parser::parseSwitchStatements(const CaseStatementPtr& case_)
 */
 StatementPtr Parser::parseBreak()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Break, token);
     BreakStatementPtr ret = nodeFactory->createBreak(token.state);
@@ -511,6 +604,7 @@ StatementPtr Parser::parseBreak()
 */
 StatementPtr Parser::parseContinue()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Continue, token);
     ContinueStatementPtr ret = nodeFactory->createContinue(token.state);
@@ -534,6 +628,7 @@ StatementPtr Parser::parseContinue()
 */
 StatementPtr Parser::parseFallthrough()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Fallthrough, token);
     FallthroughStatementPtr ret = nodeFactory->createFallthrough(token.state);
@@ -546,6 +641,7 @@ StatementPtr Parser::parseFallthrough()
 */
 StatementPtr Parser::parseReturn()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(Keyword::Return, token);
     ReturnStatementPtr ret = nodeFactory->createReturn(token.state);
@@ -571,6 +667,7 @@ StatementPtr Parser::parseReturn()
 */
 StatementPtr Parser::parseLabeledStatement()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_identifier(token);
     std::wstring label = token.token;
@@ -609,6 +706,7 @@ StatementPtr Parser::parseLabeledStatement()
 
 CodeBlockPtr Parser::parseCodeBlock()
 {
+    PROFILE_PRODUCTION();
     Token token;
     Flags flags(this);
     flags -= SUPPRESS_TRAILING_CLOSURE;
@@ -617,9 +715,217 @@ CodeBlockPtr Parser::parseCodeBlock()
     //ENTER_CONTEXT(TokenizerContextUnknown);
     while(!match(L"}"))
     {
-        StatementPtr st = parseStatement();
+        StatementPtr st = parseRecoverableStatement();
         if(st != NULL)
             ret->addStatement(st);
     }
     return ret;
 }
+
+CodeBlockPtr Parser::parseFunctionBody()
+{
+    PROFILE_PRODUCTION();
+    if(!(flags & SKIP_BODIES))
+        return parseCodeBlock();
+    Token token;
+    Flags flags(this);
+    flags -= SUPPRESS_TRAILING_CLOSURE;
+    expect(L"{", token);
+    CodeBlockPtr ret = nodeFactory->createCodeBlock(token.state);
+    skipStatements(ret);
+    expect(L"}");
+    return ret;
+}
+
+void Parser::skipStatements(const CodeBlockPtr& block)
+{
+    PROFILE_PRODUCTION();
+    Token token;
+    TokenizerState state = tokenizer->save();
+    LazyBody body;
+    body.begin = state.offset;
+    body.flags = flags;
+    body.context = state.context;
+    int depth = 0;
+    while(true)
+    {
+        expect_next(token);
+        if(token.type == TokenType::OpenBrace)
+            depth++;
+        else if(token.type == TokenType::CloseBrace && depth-- == 0)
+            break;
+    }
+    restore(token);
+    body.end = token.state.offset;
+    if(!bodyLoader)
+        bodyLoader = CodeBlockLoaderPtr(new LazyBodyLoader(this));
+    body.loader = bodyLoader;
+    block->setLazyBody(body);
+}
+
+void Parser::detachBodyLoader()
+{
+    if(bodyLoader)
+        std::static_pointer_cast<LazyBodyLoader>(bodyLoader)->detach();
+    bodyLoader = nullptr;
+}
+
+void Parser::parseLazyBody(CodeBlock* block, const CodeBlockLoaderPtr& loader)
+{
+    PROFILE_PRODUCTION();
+    const LazyBody& body = block->getLazyBody();
+    //nested bodies skipped during this parse share the same loader
+    SCOPED_SET(bodyLoader, loader);
+    SCOPED_SET(flags, body.flags);
+    TokenizerState state = tokenizer->save();
+    state.offset = body.begin;
+    state.hasSpace = false;
+    state.inStringExpression = 0;
+    state.context = (TokenizerContext)body.context;
+    tokenizer->restore(state);
+    while(!predicate(L"}"))
+    {
+        StatementPtr st = parseRecoverableStatement();
+        if(st != NULL)
+            block->addStatement(st);
+    }
+}
+
+StatementPtr Parser::parseRecoverableStatement()
+{
+    PROFILE_PRODUCTION();
+    if(!(flags & RECOVER_ERRORS))
+        return parseStatement();
+    TokenizerState begin = tokenizer->save();
+    try
+    {
+        StatementPtr ret = parseStatement();
+        if(!ret && tokenizer->save().offset == begin.offset)
+        {
+            //nothing is consumed, report it to make progress
+            Token token;
+            if(peek(token))
+                unexpected(token);
+        }
+        if(statistics.errorsRecovered)
+            statistics.statementsRecovered++;
+        return ret;
+    }
+    catch(const Abort&)
+    {
+        //the error is already reported, skip the statement and continue with next one
+        ErrorStatementPtr ret = skipBrokenStatement(begin);
+        if(!ret)
+            throw;
+        statistics.errorsRecovered++;
+        return ret;
+    }
+}
+
+DeclarationPtr Parser::parseRecoverableDeclaration()
+{
+    PROFILE_PRODUCTION();
+    if(!(flags & RECOVER_ERRORS))
+        return parseDeclaration();
+    TokenizerState begin = tokenizer->save();
+    try
+    {
+        DeclarationPtr ret = parseDeclaration();
+        if(statistics.errorsRecovered)
+            statistics.statementsRecovered++;
+        return ret;
+    }
+    catch(const Abort&)
+    {
+        if(!skipBrokenStatement(begin))
+            throw;
+        statistics.errorsRecovered++;
+        return NULL;
+    }
+}
+
+ErrorStatementPtr Parser::skipBrokenStatement(const TokenizerState& begin)
+{
+    PROFILE_PRODUCTION();
+    Token token;
+    ErrorStatementPtr ret = NULL;
+    int braces = 0;
+    int parens = 0;
+    int end = begin.offset;
+    tokenizer->restore(begin);
+    while(true)
+    {
+        TokenizerState state = tokenizer->save();
+        try
+        {
+            if(!tokenizer->next(token))
+                break;
+        }
+        catch(const TokenizerError& e)
+        {
+            //skip the bad character
+            state.offset = std::max(e.offset, state.offset) + 1;
+            state.inStringExpression = 0;
+            if(!ret)
+                ret = nodeFactory->createErrorStatement(state);
+            tokenizer->restore(state);
+            end = state.offset;
+            continue;
+        }
+        //the first token is always skipped so the parser can make progress,
+        //an unclosed parenthesis/bracket stops at next line that starts a declaration
+        if(ret && braces == 0)
+        {
+            if(token.type == TokenType::CloseBrace)
+            {
+                tokenizer->restore(token);
+                break;
+            }
+            bool declaration = token.type == TokenType::Identifier && token.identifier.type == KeywordType::Declaration && !token.identifier.backtick;
+            if((parens == 0 || declaration) && hasLineBreak(end, token.state.offset))
+            {
+                tokenizer->restore(token);
+                break;
+            }
+        }
+        if(!ret)
+            ret = nodeFactory->createErrorStatement(token.state);
+        switch(token.type)
+        {
+            case TokenType::OpenBrace:
+                braces++;
+                break;
+            case TokenType::CloseBrace:
+                if(braces > 0)
+                    braces--;
+                break;
+            case TokenType::OpenParen:
+            case TokenType::OpenBracket:
+                parens++;
+                break;
+            case TokenType::CloseParen:
+            case TokenType::CloseBracket:
+                if(parens > 0)
+                    parens--;
+                break;
+            default:
+                break;
+        }
+        end = tokenizer->save().offset;
+        if(braces == 0 && parens == 0 && token.type == TokenType::Semicolon)
+            break;
+    }
+    if(ret)
+        ret->setEndOffset(end);
+    return ret;
+}
+
+bool Parser::hasLineBreak(int begin, int end) const
+{
+    for(int i = begin; i < end; i++)
+    {
+        if(utf8 ? utf8[i] == '\n' : code[i] == '\n')
+            return true;
+    }
+    return false;
+}
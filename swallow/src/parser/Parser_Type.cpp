@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "parser/Parser.h"
+#include "parser/ParserProfile.h"
 #include "parser/Parser_Details.h"
 #include "tokenizer/Tokenizer.h"
 #include "ast/NodeFactory.h"
@@ -41,6 +42,7 @@ using namespace Swallow;
 
 TypeNodePtr Parser::parseTypeAnnotation()
 {
+    PROFILE_PRODUCTION();
     Attributes attrs;
     if(predicate(L"@"))
     {
@@ -52,6 +54,7 @@ TypeNodePtr Parser::parseTypeAnnotation()
 }
 TypeNodePtr Parser::parseType()
 {
+    PROFILE_PRODUCTION();
     Token token;
     TypeNodePtr ret = NULL;
     expect_next(token);
@@ -142,6 +145,7 @@ TypeNodePtr Parser::parseType()
  */
 TypeNodePtr Parser::parseCollectionType()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(L"[", token);
     TypeNodePtr type = this->parseType();
@@ -176,6 +180,7 @@ TypeNodePtr Parser::parseCollectionType()
  */
 TupleTypePtr Parser::parseTupleType()
 {
+    PROFILE_PRODUCTION();
     Token token, token2;
     expect(L"(", token);
     TupleTypePtr ret = nodeFactory->createTupleType(token.state);
@@ -230,6 +235,7 @@ TupleTypePtr Parser::parseTupleType()
 */
 TypeIdentifierPtr Parser::parseTypeIdentifier()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect_next(token);
     if(token.type != TokenType::Identifier || (token.identifier.keyword != Keyword::_ && token.identifier.keyword != Keyword::SelfType))
@@ -261,6 +267,7 @@ TypeIdentifierPtr Parser::parseTypeIdentifier()
 }
 ProtocolCompositionPtr Parser::parseProtocolComposition()
 {
+    PROFILE_PRODUCTION();
     Token token;
     expect(L"protocol", token);
     ENTER_CONTEXT(TokenizerContextType);
@@ -303,6 +310,7 @@ ProtocolCompositionPtr Parser::parseProtocolComposition()
 
 GenericParametersDefPtr Parser::parseGenericParametersDef()
 {
+    PROFILE_PRODUCTION();
     Token token;
     ENTER_CONTEXT(TokenizerContextType);
     expect(L"<", token);
@@ -46,13 +46,17 @@ CollectionTypeAnalyzer::CollectionTypeAnalyzer(const TypePtr& contextualType, Gl
 void CollectionTypeAnalyzer::analyze(const ExpressionPtr& expr)
 {
     assert(expr != nullptr);
+    analyze(expr->getNodeType(), expr->getType());
+}
+
+void CollectionTypeAnalyzer::analyze(NodeType::T nodeType, const TypePtr& exprType)
+{
     if(contextualType)
         return;//already analyzed
-    TypePtr exprType = expr->getType();
     if(finalType && Type::equals(exprType, finalType))
         return;//
     assert(exprType != nullptr);
-    switch(expr->getNodeType())
+    switch(nodeType)
     {
         case NodeType::IntegerLiteral:
             if(finalType == nullptr)
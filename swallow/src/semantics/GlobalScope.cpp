@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "semantics/GlobalScope.h"
+#include "common/StringPool.h"
 #include "semantics/Type.h"
 #include "semantics/FunctionSymbol.h"
 #include "semantics/FunctionOverloadedSymbol.h"
@@ -62,7 +63,8 @@ using namespace std;
 
 
 
-GlobalScope::GlobalScope()
+GlobalScope::GlobalScope(const StringPoolPtr& stringPool)
+    :SymbolScope(stringPool)
 {
     module = Type::newType(L"Module", Type::Module);
 
@@ -99,6 +101,7 @@ void GlobalScope::initRuntime(SymbolRegistry* symbolRegistry)
 
     //cout<<"Loading runtime file"<<endl;
     ScopedNodeFactory nodeFactory;
+    nodeFactory.setStringPool(symbolRegistry->getStringPool());
     CompilerResults compilerResults;
     wstring code;
     ScopedProgramPtr ret;
@@ -148,7 +151,7 @@ void GlobalScope::initRuntime(SymbolRegistry* symbolRegistry)
         parser.setSourceFile(source);
 
         clock_t start = clock();
-        if(!parser.parse(code.c_str(), ret))
+        if(!parser.parse(source->code.c_str(), source->code.size(), ret))
             throw Abort();
         clock_t end = clock();
         printf("%fs used for parsing file\n", (float)((end - start) * 1.0f / CLOCKS_PER_SEC));
@@ -504,7 +507,7 @@ void GlobalScope::declareFunction(const std::wstring&name, int flags, const wcha
     FunctionSymbolPtr fn = vcreateFunction(name, flags, returnType, va);
     va_end(va);
 
-    auto iter = symbols.find(name);
+    auto iter = symbols.find(stringPool->intern(name));
     if(iter == symbols.end())
     {
         addSymbol(fn);
@@ -64,38 +64,104 @@ bool OperatorResolver::rotateRequired(const OperatorPtr& lhs, const OperatorPtr&
     }
     return leftOp->precedence.infix < rightOp->precedence.infix;
 }
+bool OperatorResolver::isRotatable(const PatternPtr& node)
+{
+    if(!node)
+        return false;
+    NodeType::T type = node->getNodeType();
+    return type == NodeType::BinaryOperator || type == NodeType::Assignment;
+}
+bool OperatorResolver::isTypeCasting(const BinaryOperatorPtr& node)
+{
+    return dynamic_cast<TypeCheck*>(node.get()) || dynamic_cast<TypeCast*>(node.get());
+}
 /*!
- * Sort the AST tree by precedence, if the precedence is the same, sort by associativity
+ * Sort the AST tree by precedence, if the precedence is the same, sort by associativity.
+ * The binary operators connected to the root are flattened into operands and operators
+ * in source order, then they're linked again with an explicit stack of the operators whose
+ * rhs is not complete, so long operator chains are sorted in linear time without recursion.
+ * Type-casting operators have no rhs, they're applied to the operand once the operators
+ * that bind tighter are complete.
  */
 OperatorPtr OperatorResolver::sortExpression(const OperatorPtr& op)
 {
-    OperatorPtr root = op;
-    OperatorPtr c;
-    if(op->numChildren() != 2)
+    if(!isRotatable(op))
+    {
+        op->accept(this);
+        return op;
+    }
+    std::vector<PatternPtr> operands;
+    std::vector<BinaryOperatorPtr> operators;
+    std::vector<BinaryOperatorPtr> stack;
+    bool sorted = true;
+    PatternPtr node = op;
+    BinaryOperatorPtr parent;
+    bool rhs = false;
+    while(true)
+    {
+        while(isRotatable(node))
+        {
+            parent = static_pointer_cast<BinaryOperator>(node);
+            rhs = false;
+            stack.push_back(parent);
+            node = parent->getLHS();
+        }
+        //operands are transformed in place, it's enough for the expression that is already sorted
+        PatternPtr operand = transform<Pattern>(node);
+        if(operand != node)
+        {
+            if(rhs)
+                parent->setRHS(operand);
+            else
+                parent->setLHS(operand);
+        }
+        operands.push_back(operand);
+        rhs = false;
+        while(!rhs && !stack.empty())
+        {
+            parent = stack.back();
+            stack.pop_back();
+            operators.push_back(parent);
+            sorted = sorted && parent->isSorted();
+            if(!isTypeCasting(parent))
+            {
+                node = parent->getRHS();
+                rhs = true;
+            }
+        }
+        if(!rhs)
+            break;
+    }
+    if(sorted)
         return op;
-    NodePtr left = op->get(0);
-    NodePtr right = op->get(1);
-    if(left && (c = std::dynamic_pointer_cast<Operator>(left)) && c->numChildren() == 2)
+    PatternPtr operand = operands[0];
+    std::vector<PatternPtr>::iterator nextOperand = operands.begin() + 1;
+    for(const BinaryOperatorPtr& current : operators)
     {
-        left = c = sortExpression(c);
-        if(rotateRequired(c, root))
+        while(!stack.empty() && !rotateRequired(stack.back(), current))
+        {
+            stack.back()->setRHS(operand);
+            operand = stack.back();
+            stack.pop_back();
+        }
+        current->setLHS(operand);
+        if(isTypeCasting(current))
         {
-            //make c the root
-            NodePtr r = c->get(1);
-            c->set(1, root);
-            root->set(0, r);
-            root = c;
-            //sort new right child
-            NodePtr r2 = sortExpression(std::static_pointer_cast<Operator>(c->get(1)));
-            c->set(1, r2);
-            return root;
+            operand = current;
         }
+        else
+        {
+            stack.push_back(current);
+            operand = *nextOperand++;
+        }
+    }
+    while(!stack.empty())
+    {
+        stack.back()->setRHS(operand);
+        operand = stack.back();
+        stack.pop_back();
     }
-    //sort old right child
-    c = std::dynamic_pointer_cast<Operator>(right);
-    if(c != NULL)
-        sortExpression(c);
-    return root;
+    return static_pointer_cast<Operator>(operand);
 }
 
 
@@ -224,6 +290,9 @@ void OperatorResolver::visitParenthesizedExpression(const ParenthesizedExpressio
 }
 void OperatorResolver::visitArrayLiteral(const ArrayLiteralPtr& node)
 {
+    //plain literals have no operator to resolve, leave them compact
+    if(node->isCompact())
+        return;
     for(auto& p : *node)
     {
         p = transform<Expression>(p);
@@ -231,6 +300,8 @@ void OperatorResolver::visitArrayLiteral(const ArrayLiteralPtr& node)
 }
 void OperatorResolver::visitDictionaryLiteral(const DictionaryLiteralPtr& node)
 {
+    if(node->isCompact())
+        return;
     for(auto& el : *node)
     {
         el.first = transform<Expression>(el.first);
@@ -30,6 +30,7 @@
 #include "semantics/ScopeOwner.h"
 #include "semantics/SymbolScope.h"
 #include "ast/Node.h"
+#include <cassert>
 
 USE_SWALLOW_NS
 
@@ -50,9 +51,14 @@ SymbolScope* ScopeOwner::getScope()
 {
     if(!symbolScope)
     {
-        symbolScope = new SymbolScope();
+        assert(stringPool != nullptr && "Scoped nodes must be created by ScopedNodeFactory");
+        symbolScope = new SymbolScope(stringPool);
         symbolScope->owner = dynamic_cast<Node*>(this);
     }
     return symbolScope;
 }
+void ScopeOwner::setStringPool(const StringPoolPtr& pool)
+{
+    stringPool = pool;
+}
 
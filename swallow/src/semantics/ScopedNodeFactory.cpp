@@ -35,31 +35,31 @@ USE_SWALLOW_NS
 
 EnumDefPtr ScopedNodeFactory::createEnum(const SourceInfo& state)
 {
-    return create<ScopedEnum>(state);
+    return createScoped<ScopedEnum>(state);
 }
 StructDefPtr ScopedNodeFactory::createStruct(const SourceInfo& state)
 {
-    return create<ScopedStruct>(state);
+    return createScoped<ScopedStruct>(state);
 }
 ClassDefPtr ScopedNodeFactory::createClass(const SourceInfo& state)
 {
-    return create<ScopedClass>(state);
+    return createScoped<ScopedClass>(state);
 }
 ProtocolDefPtr ScopedNodeFactory::createProtocol(const SourceInfo& state)
 {
-    return create<ScopedProtocol>(state);
+    return createScoped<ScopedProtocol>(state);
 }
 ProgramPtr ScopedNodeFactory::createProgram()
 {
-    return create<ScopedProgram>(SourceInfo());
+    return createScoped<ScopedProgram>(SourceInfo());
 }
 CodeBlockPtr ScopedNodeFactory::createCodeBlock(const SourceInfo& state)
 {
-    return create<ScopedCodeBlock>(state);
+    return createScoped<ScopedCodeBlock>(state);
 }
 ClosurePtr ScopedNodeFactory::createClosure(const SourceInfo& state)
 {
-    return create<ScopedClosure>(state);
+    return createScoped<ScopedClosure>(state);
 }
 FunctionDefPtr ScopedNodeFactory::createFunction(const SourceInfo& state)
 {
@@ -531,7 +531,7 @@ void SemanticAnalyzer::visitFunctionCall(const FunctionCallPtr& node)
             TypePtr selfType;
             if(ma->getSelf() != nullptr)//e.g.   var a : String? = .Some("fff")
             {
-                SCOPED_SET(currentNode, ma);
+                SCOPED_SET(currentNode, ma.get());
                 validateInitializerDelegation(ma);
                 ma->getSelf()->accept(this);
                 selfType = ma->getSelf()->getType();
@@ -43,6 +43,7 @@
 #include "semantics/CollectionTypeAnalyzer.h"
 #include <iostream>
 #include "common/ScopedValue.h"
+#include "common/StringPool.h"
 #include "semantics/InitializationTracer.h"
 #include "semantics/TypeResolver.h"
 
@@ -89,13 +90,7 @@ void SemanticAnalyzer::visitBooleanLiteral(const BooleanLiteralPtr& node)
 }
 void SemanticAnalyzer::visitString(const StringLiteralPtr& node)
 {
-    GlobalScope* scope = symbolRegistry->getGlobalScope();
-    if(ctx.contextualType && ctx.contextualType->canAssignTo(scope->StringLiteralConvertible()))
-        node->setType(ctx.contextualType);
-    else if(ctx.contextualType && node->value.length() == 1 && ctx.contextualType->canAssignTo(scope->UnicodeScalarLiteralConvertible()))
-        node->setType(ctx.contextualType);
-    else
-        node->setType(scope->String());
+    node->setType(getLiteralType(NodeType::StringLiteral, node->value.length()));
 }
 void SemanticAnalyzer::visitStringInterpolation(const StringInterpolationPtr &node)
 {
@@ -108,29 +103,49 @@ void SemanticAnalyzer::visitStringInterpolation(const StringInterpolationPtr &no
 }
 void SemanticAnalyzer::visitInteger(const IntegerLiteralPtr& node)
 {
-    GlobalScope* scope = symbolRegistry->getGlobalScope();
-    //TODO: it will changed to use standard library's overloaded type constructor to infer type when the facility is mature enough.
-    if(ctx.contextualType && ctx.contextualType->canAssignTo(scope->IntegerLiteralConvertible()))
-        node->setType(ctx.contextualType);
-    else if(ctx.contextualType && ctx.contextualType->canAssignTo(scope->FloatLiteralConvertible()))
-        node->setType(ctx.contextualType);
-    else
-        node->setType(scope->Int());
+    node->setType(getLiteralType(NodeType::IntegerLiteral, 0));
 }
 void SemanticAnalyzer::visitFloat(const FloatLiteralPtr& node)
+{
+    node->setType(getLiteralType(NodeType::FloatLiteral, 0));
+}
+TypePtr SemanticAnalyzer::getLiteralType(NodeType::T nodeType, size_t length)
 {
     GlobalScope* scope = symbolRegistry->getGlobalScope();
-    if(ctx.contextualType && ctx.contextualType->canAssignTo(scope->FloatLiteralConvertible()))
-        node->setType(ctx.contextualType);
-    else
-        node->setType(scope->Double());
+    switch(nodeType)
+    {
+        case NodeType::IntegerLiteral:
+            //TODO: it will changed to use standard library's overloaded type constructor to infer type when the facility is mature enough.
+            if(ctx.contextualType && ctx.contextualType->canAssignTo(scope->IntegerLiteralConvertible()))
+                return ctx.contextualType;
+            if(ctx.contextualType && ctx.contextualType->canAssignTo(scope->FloatLiteralConvertible()))
+                return ctx.contextualType;
+            return scope->Int();
+        case NodeType::FloatLiteral:
+            if(ctx.contextualType && ctx.contextualType->canAssignTo(scope->FloatLiteralConvertible()))
+                return ctx.contextualType;
+            return scope->Double();
+        case NodeType::StringLiteral:
+            if(ctx.contextualType && ctx.contextualType->canAssignTo(scope->StringLiteralConvertible()))
+                return ctx.contextualType;
+            if(ctx.contextualType && length == 1 && ctx.contextualType->canAssignTo(scope->UnicodeScalarLiteralConvertible()))
+                return ctx.contextualType;
+            return scope->String();
+        default:
+            assert(0 && "Not a plain literal");
+            return nullptr;
+    }
 }
 
 //Will be replaced by stdlib's type constructor
 bool SemanticAnalyzer::canConvertTo(const ExpressionPtr& expr, const TypePtr& type)
+{
+    return canConvertTo(expr->getNodeType(), expr->getType(), type);
+}
+bool SemanticAnalyzer::canConvertTo(NodeType::T nodeType, const TypePtr& exprType, const TypePtr& type)
 {
     GlobalScope* global = symbolRegistry->getGlobalScope();
-    switch(expr->getNodeType())
+    switch(nodeType)
     {
         case NodeType::IntegerLiteral:
             return type->canAssignTo(global->IntegerLiteralConvertible());
@@ -143,11 +158,26 @@ bool SemanticAnalyzer::canConvertTo(const ExpressionPtr& expr, const TypePtr& ty
         case NodeType::StringLiteral:
             return type->canAssignTo(global->StringLiteralConvertible());
         default:
-            return expr->getType()->canAssignTo(type);
+            return exprType->canAssignTo(type);
     }
     return false;
 }
 
+bool SemanticAnalyzer::analyzeLiterals(const LiteralColumns& literals, CollectionTypeAnalyzer& analyzer)
+{
+    int num = literals.size();
+    for(int i = 0; i < num; i++)
+    {
+        NodeType::T nodeType = literals.getType(i);
+        SCOPED_SET(ctx.contextualType, analyzer.finalType);
+        TypePtr type = getLiteralType(nodeType, literals.getTextLength(i));
+        analyzer.analyze(nodeType, type);
+        if(analyzer.differentTypes > 0 || !canConvertTo(nodeType, type, analyzer.finalType))
+            return false;
+    }
+    return true;
+}
+
 void SemanticAnalyzer::visitArrayLiteral(const ArrayLiteralPtr& node)
 {
     int num = node->numElements();
@@ -178,6 +208,17 @@ void SemanticAnalyzer::visitArrayLiteral(const ArrayLiteralPtr& node)
     }
 
     TypePtr elementType = ctx.contextualType != nullptr ? ctx.contextualType->getGenericArguments()->get(0) : nullptr;
+    if(node->isCompact())
+    {
+        //plain literals are typed from their columns, the nodes are only created to report errors
+        CollectionTypeAnalyzer analyzer(elementType, global);
+        if(analyzeLiterals(node->getLiterals(), analyzer))
+        {
+            node->getLiterals().setElementType(analyzer.finalType);
+            node->setType(global->makeArray(analyzer.finalType));
+            return;
+        }
+    }
     CollectionTypeAnalyzer analyzer(elementType, global);
     for(const ExpressionPtr& el : *node)
     {
@@ -200,13 +241,17 @@ void SemanticAnalyzer::visitArrayLiteral(const ArrayLiteralPtr& node)
     TypePtr arrayType = global->makeArray(analyzer.finalType);
     node->setType(arrayType);
 }
+static bool isOptional(const TypePtr& type, GlobalScope* global)
+{
+    return global->isOptional(type) || global->isImplicitlyUnwrappedOptional(type);
+}
 void SemanticAnalyzer::visitDictionaryLiteral(const DictionaryLiteralPtr& node)
 {
     TypePtr keyHint, valueHint;
     GlobalScope* global = symbolRegistry->getGlobalScope();
 
     //if it only contains one entry and both key and value are type, then it's a type constructor
-    if(node->numElements() == 1)
+    if(node->numElements() == 1 && !node->isCompact())
     {
         auto entry = *node->begin();
         TypeNodePtr keyTypeNode = expressionToType(entry.first);
@@ -250,6 +295,23 @@ void SemanticAnalyzer::visitDictionaryLiteral(const DictionaryLiteralPtr& node)
         return;
     }
 
+    if(node->isCompact())
+    {
+        //an optional key or value type needs the nodes to wrap the literals
+        CollectionTypeAnalyzer keyAnalyzer(keyHint, global);
+        CollectionTypeAnalyzer valueAnalyzer(valueHint, global);
+        if(analyzeLiterals(node->getLiteralKeys(), keyAnalyzer) && analyzeLiterals(node->getLiteralValues(), valueAnalyzer)
+           && !isOptional(keyAnalyzer.finalType, global) && !isOptional(valueAnalyzer.finalType, global))
+        {
+            node->getLiteralKeys().setElementType(keyAnalyzer.finalType);
+            node->getLiteralValues().setElementType(valueAnalyzer.finalType);
+            if(ctx.contextualType)
+                node->setType(ctx.contextualType);
+            else
+                node->setType(global->makeDictionary(keyAnalyzer.finalType, valueAnalyzer.finalType));
+            return;
+        }
+    }
     CollectionTypeAnalyzer keyAnalyzer(keyHint, global);
     CollectionTypeAnalyzer valueAnalyzer(valueHint, global);
 
@@ -378,7 +440,14 @@ void SemanticAnalyzer::visitIdentifier(const IdentifierPtr& id)
     SymbolScope* scope = NULL;
     declareImmediately(id->getIdentifier());
     const wstring& name = id->getIdentifier();
-    symbolRegistry->lookupSymbol(name, &scope, &sym);
+    //the parser interns identifiers in the registry's pool, so they're looked up without hashing the name again
+    if(id->getSymbol())
+    {
+        assert(symbolRegistry->getStringPool()->get(id->getSymbol()) == name && "Identifier is interned in another pool");
+        symbolRegistry->lookupSymbol(id->getSymbol(), &scope, &sym);
+    }
+    else
+        symbolRegistry->lookupSymbol(name, &scope, &sym);
     //not found by accesing from scope
     //look up again if it belongs to a super class
     if(!sym && ctx.currentType)
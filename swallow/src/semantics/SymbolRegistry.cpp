@@ -33,6 +33,7 @@
 #include "semantics/FunctionOverloadedSymbol.h"
 #include "semantics/FunctionSymbol.h"
 #include "semantics/GlobalScope.h"
+#include "common/StringPool.h"
 #include <cassert>
 
 using namespace Swallow;
@@ -40,7 +41,8 @@ using namespace Swallow;
 SymbolRegistry::SymbolRegistry()
 :currentScope(nullptr), fileScope(nullptr)
 {
-    globalScope = new GlobalScope();
+    stringPool = StringPoolPtr(new StringPool());
+    globalScope = new GlobalScope(stringPool);
     globalScope->initRuntime(this);
     enterScope(globalScope);
     //?:  Right associative, precedence level 100
@@ -61,10 +63,11 @@ bool SymbolRegistry::registerOperator(const std::wstring& name, OperatorType::T
 bool SymbolRegistry::registerOperator(SymbolScope* scope, const std::wstring& name, OperatorType::T type, Associativity::T associativity, int precedence, bool assignment)
 {
     assert(scope != nullptr && "Operator cannot be registered in an invalid scope");
-    SymbolScope::OperatorMap::iterator iter = scope->operators.find(name);
+    int symbol = scope->stringPool->intern(name);
+    SymbolScope::OperatorMap::iterator iter = scope->operators.find(symbol);
     if(iter == scope->operators.end())
     {
-        auto ret = scope->operators.insert(std::make_pair(name, OperatorInfo(name, associativity, assignment)));
+        auto ret = scope->operators.insert(std::make_pair(symbol, OperatorInfo(name, associativity, assignment)));
         iter = ret.first;
     }
     else
@@ -97,7 +100,21 @@ OperatorInfo* SymbolRegistry::getOperator(const std::wstring& name, int typeMask
 }
 OperatorInfo* SymbolRegistry::getOperator(SymbolScope* scope, const std::wstring& name, int typeMask)
 {
-    SymbolScope::OperatorMap::iterator iter = scope->operators.find(name);
+    int symbol = scope->stringPool->find(name);
+    if(symbol < 0)
+        return nullptr;
+    SymbolScope::OperatorMap::iterator iter = scope->operators.find(symbol);
+    if(iter == scope->operators.end())
+        return nullptr;
+    if((iter->second.type & typeMask) == 0)
+        return nullptr;
+    return &iter->second;
+}
+OperatorInfo* SymbolRegistry::getOperator(SymbolScope* scope, int symbol, int typeMask)
+{
+    //parsers of all threads come here, only scopes interned in the registry's pool can be keyed by the id directly
+    assert(scope->stringPool == stringPool);
+    SymbolScope::OperatorMap::iterator iter = scope->operators.find(symbol);
     if(iter == scope->operators.end())
         return nullptr;
     if((iter->second.type & typeMask) == 0)
@@ -120,6 +137,10 @@ bool SymbolRegistry::isInfixOperator(const std::wstring& name)
     return op != nullptr;
 }
 
+const StringPoolPtr& SymbolRegistry::getStringPool() const
+{
+    return stringPool;
+}
 GlobalScope* SymbolRegistry::getGlobalScope()
 {
     return globalScope;
@@ -173,8 +194,34 @@ bool SymbolRegistry::lookupSymbol(const std::wstring& name, SymbolScope** contai
 {
     return lookupSymbol(currentScope, name, container, ret, lazyResolve);
 }
+bool SymbolRegistry::lookupSymbol(int symbol, SymbolScope** container, SymbolPtr* ret, bool lazyResolve)
+{
+    return lookupSymbol(currentScope, symbol, container, ret, lazyResolve);
+}
+bool SymbolRegistry::lookupSymbol(SymbolScope* scope, int symbol, SymbolScope** container, SymbolPtr* ret, bool lazyResolve)
+{
+    SymbolScope* s = scope;
+    for(; s; s = s->parent)
+    {
+        //scopes of a node factory that isn't linked to the registry intern in their own pool
+        SymbolPtr sym = s->stringPool == stringPool ? s->lookup(symbol, lazyResolve) : s->lookup(stringPool->get(symbol), lazyResolve);
+        if(sym)
+        {
+            if(container)
+                *container = s;
+            if(ret)
+                *ret = sym;
+            return true;
+        }
+    }
+    return false;
+}
 bool SymbolRegistry::lookupSymbol(SymbolScope* scope, const std::wstring& name, SymbolScope** container, SymbolPtr* ret, bool lazyResolve)
 {
+    int id = stringPool->find(name);
+    if(id >= 0)
+        return lookupSymbol(scope, id, container, ret, lazyResolve);
+    //the name was never interned, only LazySymbolResolver can declare it
     SymbolScope* s = scope;
     for(; s; s = s->parent)
     {
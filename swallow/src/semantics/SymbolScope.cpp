@@ -30,14 +30,16 @@
 #include "semantics/SymbolScope.h"
 #include "semantics/SymbolRegistry.h"
 #include "semantics/Type.h"
+#include "common/StringPool.h"
 #include <cassert>
 #include <iostream>
 
 USE_SWALLOW_NS
 
-SymbolScope::SymbolScope()
-    :owner(NULL), parent(NULL)
+SymbolScope::SymbolScope(const StringPoolPtr& stringPool)
+    :stringPool(stringPool), owner(NULL), parent(NULL)
 {
+    assert(stringPool != nullptr);
     lazySymbolResolver = nullptr;
 }
 SymbolScope::~SymbolScope()
@@ -51,9 +53,10 @@ Node* SymbolScope::getOwner()
 void SymbolScope::addSymbol(const std::wstring& name, const SymbolPtr& symbol)
 {
     assert(!name.empty());
-    SymbolMap::iterator iter = symbols.find(name);
+    int id = stringPool->intern(name);
+    SymbolMap::iterator iter = symbols.find(id);
     assert(iter == symbols.end() && "The symbol already exists with the same name.");
-    this->symbols.insert(std::make_pair(name, symbol));
+    this->symbols.insert(std::make_pair(id, symbol));
 }
 void SymbolScope::addSymbol(const SymbolPtr& symbol)
 {
@@ -62,7 +65,10 @@ void SymbolScope::addSymbol(const SymbolPtr& symbol)
 
 void SymbolScope::removeSymbol(const SymbolPtr& symbol)
 {
-    SymbolMap::iterator iter = symbols.find(symbol->getName());
+    int id = stringPool->find(symbol->getName());
+    if(id < 0)
+        return;
+    SymbolMap::iterator iter = symbols.find(id);
     if(iter != symbols.end() && iter->second == symbol)
         symbols.erase(iter);
 
@@ -73,8 +79,12 @@ void SymbolScope::removeSymbol(const SymbolPtr& symbol)
     */
 bool SymbolScope::isSymbolDefined(const std::wstring& name)
 {
-    SymbolMap::iterator iter = symbols.find(name);
-    return iter != symbols.end();
+    int id = stringPool->find(name);
+    return id >= 0 && isSymbolDefined(id);
+}
+bool SymbolScope::isSymbolDefined(int symbol)
+{
+    return symbols.find(symbol) != symbols.end();
 }
 static SymbolPtr resolveTypeAlias(const SymbolPtr& sym)
 {
@@ -87,16 +97,26 @@ static SymbolPtr resolveTypeAlias(const SymbolPtr& sym)
 SymbolPtr SymbolScope::lookup(const std::wstring& name, bool lazyResolve)
 {
     assert(!name.empty());
-    SymbolMap::iterator iter = symbols.find(name);
+    //a name that was never interned is not declared in any scope, but LazySymbolResolver may still declare it
+    int id = stringPool->find(name);
+    if(id >= 0)
+        return lookup(id, lazyResolve);
+    if(lazySymbolResolver && lazyResolve && lazySymbolResolver->resolveLazySymbol(name))
+        return lookup(stringPool->intern(name), false);
+    return nullptr;
+}
+SymbolPtr SymbolScope::lookup(int symbol, bool lazyResolve)
+{
+    SymbolMap::iterator iter = symbols.find(symbol);
     if(iter != symbols.end())
         return resolveTypeAlias(iter->second);
     //check it in LazySymbolResolver
     if(lazySymbolResolver && lazyResolve)
     {
-        bool success = lazySymbolResolver->resolveLazySymbol(name);
+        bool success = lazySymbolResolver->resolveLazySymbol(stringPool->get(symbol));
         if(success)
         {
-            iter = symbols.find(name);
+            iter = symbols.find(symbol);
             if(iter != symbols.end())
             {
                 return resolveTypeAlias(iter->second);
@@ -113,7 +133,10 @@ bool SymbolScope::getExtension(const std::wstring& name, std::vector<TypePtr>**
 {
     if(result)
         *result = nullptr;
-    auto iter = extensions.find(name);
+    int id = stringPool->find(name);
+    if(id < 0)
+        return false;
+    auto iter = extensions.find(id);
     if(iter == extensions.end())
         return false;
     *result = &iter->second;
@@ -127,10 +150,11 @@ void SymbolScope::addExtension(const TypePtr& extension)
 {
     assert(extension != nullptr);
     assert(extension->getCategory() == Type::Extension);
-    auto iter = extensions.find(extension->getName());
+    int id = stringPool->intern(extension->getName());
+    auto iter = extensions.find(id);
     if(iter == extensions.end())
     {
-        iter = extensions.insert(std::make_pair(extension->getName(), std::vector<TypePtr>())).first;
+        iter = extensions.insert(std::make_pair(id, std::vector<TypePtr>())).first;
     }
     iter->second.push_back(extension);
 }
@@ -140,14 +164,17 @@ void SymbolScope::addExtension(const TypePtr& extension)
  */
 void SymbolScope::addForwardDeclaration(const TypePtr& type)
 {
-    forwardDeclarations.insert(make_pair(type->getName(), type));
+    forwardDeclarations.insert(make_pair(stringPool->intern(type->getName()), type));
 }
 /*!
  * Get a registered forward Declaration
  */
 TypePtr SymbolScope::getForwardDeclaration(const std::wstring& name)
 {
-    auto iter = forwardDeclarations.find(name);
+    int id = stringPool->find(name);
+    if(id < 0)
+        return nullptr;
+    auto iter = forwardDeclarations.find(id);
     if(iter == forwardDeclarations.end())
         return nullptr;
     return iter->second;
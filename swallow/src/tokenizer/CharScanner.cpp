@@ -0,0 +1,448 @@
+/* CharScanner.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "tokenizer/CharScanner.h"
+#include "tokenizer/token_char_types.h"
+#include "common/Utf8.h"
+#include <cwchar>
+
+#if defined(__GNUC__)
+#if defined(__AVX2__)
+#define SCANNER_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__)
+#define SCANNER_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+//SIMD scanners of wide characters work on 32bit wchar_t only
+#if WCHAR_MAX > 0xffff
+#define SCANNER_WIDE
+#endif
+
+USE_SWALLOW_NS
+
+namespace
+{
+#ifdef SCANNER_SSE2
+    /*!
+     * Lanes in [low, high]
+     */
+    inline __m128i inRange(__m128i v, int low, int high)
+    {
+        __m128i d = _mm_sub_epi32(v, _mm_set1_epi32(low));
+        return _mm_and_si128(_mm_cmpgt_epi32(d, _mm_set1_epi32(-1)), _mm_cmplt_epi32(d, _mm_set1_epi32(high - low + 1)));
+    }
+    inline __m128i equals(__m128i v, int ch)
+    {
+        return _mm_cmpeq_epi32(v, _mm_set1_epi32(ch));
+    }
+    inline unsigned toMask(__m128i v)
+    {
+        return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(v));
+    }
+    /*!
+     * Byte lanes in [low, high], compared as unsigned
+     */
+    inline __m128i inRangeBytes(__m128i v, int low, int high)
+    {
+        __m128i d = _mm_sub_epi8(v, _mm_set1_epi8((char)low));
+        return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8((char)(high - low))), d);
+    }
+    inline __m128i equalsBytes(__m128i v, int ch)
+    {
+        return _mm_cmpeq_epi8(v, _mm_set1_epi8((char)ch));
+    }
+    inline unsigned toMaskBytes(__m128i v)
+    {
+        return (unsigned)_mm_movemask_epi8(v);
+    }
+#endif
+#ifdef SCANNER_AVX2
+    inline __m256i inRange(__m256i v, int low, int high)
+    {
+        __m256i d = _mm256_sub_epi32(v, _mm256_set1_epi32(low));
+        return _mm256_and_si256(_mm256_cmpgt_epi32(d, _mm256_set1_epi32(-1)), _mm256_cmpgt_epi32(_mm256_set1_epi32(high - low + 1), d));
+    }
+    inline __m256i equals(__m256i v, int ch)
+    {
+        return _mm256_cmpeq_epi32(v, _mm256_set1_epi32(ch));
+    }
+    inline unsigned toMask(__m256i v)
+    {
+        return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(v));
+    }
+    inline __m256i inRangeBytes(__m256i v, int low, int high)
+    {
+        __m256i d = _mm256_sub_epi8(v, _mm256_set1_epi8((char)low));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8((char)(high - low))), d);
+    }
+    inline __m256i equalsBytes(__m256i v, int ch)
+    {
+        return _mm256_cmpeq_epi8(v, _mm256_set1_epi8((char)ch));
+    }
+    inline unsigned toMaskBytes(__m256i v)
+    {
+        return (unsigned)_mm256_movemask_epi8(v);
+    }
+#endif
+
+    /*!
+     * Predicates are written once for scalar and vector, the vector version returns all bits set
+     * in lanes that match. Only the operations available for both vector types are used.
+     */
+    struct Whitespace
+    {
+        template<class V>
+        static V match(V v)
+        {
+            //space, \t \n \v \f \r, null and zero width space
+            V ret = inRange(v, 0x09, 0x0D);
+            ret = ret | equals(v, 0x20);
+            ret = ret | equals(v, 0);
+            return ret | equals(v, 0x200b);
+        }
+        static bool match(wchar_t ch)
+        {
+            return iswhite(ch);
+        }
+    };
+    /*!
+     * ASCII identifier characters, others are checked by isIdentifierCharacter
+     */
+    struct AsciiIdentifier
+    {
+        template<class V>
+        static V match(V v)
+        {
+            V ret = inRange(v, 'a', 'z');
+            ret = ret | inRange(v, 'A', 'Z');
+            ret = ret | inRange(v, '0', '9');
+            return ret | equals(v, '_');
+        }
+        static bool match(wchar_t ch)
+        {
+            return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+        }
+    };
+    struct NotLineFeed
+    {
+        template<class V>
+        static V match(V v)
+        {
+            return ~equals(v, '\n');
+        }
+        static bool match(wchar_t ch)
+        {
+            return ch != '\n';
+        }
+    };
+    struct NotCommentMark
+    {
+        template<class V>
+        static V match(V v)
+        {
+            return ~(equals(v, '*') | equals(v, '/'));
+        }
+        static bool match(wchar_t ch)
+        {
+            return ch != '*' && ch != '/';
+        }
+    };
+
+    /*!
+     * Skip all characters that matches the predicate
+     */
+    template<class Predicate>
+    inline const wchar_t* scan(const wchar_t* p, const wchar_t* end)
+    {
+        //most runs are short, check the first character before entering vector loop
+        if(p >= end || !Predicate::match(*p))
+            return p;
+#if defined(SCANNER_AVX2) && defined(SCANNER_WIDE)
+        for(; end - p >= 8; p += 8)
+        {
+            unsigned mask = toMask(Predicate::match(_mm256_loadu_si256((const __m256i*)p)));
+            if(mask != 0xff)
+                return p + __builtin_ctz(~mask);
+        }
+#endif
+#if defined(SCANNER_SSE2) && defined(SCANNER_WIDE)
+        for(; end - p >= 4; p += 4)
+        {
+            unsigned mask = toMask(Predicate::match(_mm_loadu_si128((const __m128i*)p)));
+            if(mask != 0xf)
+                return p + __builtin_ctz(~mask);
+        }
+#endif
+        while(p < end && Predicate::match(*p))
+            p++;
+        return p;
+    }
+
+    /*!
+     * Predicates on UTF-8 bytes, only ASCII characters are matched here because
+     * bytes of a multi-byte sequence are never below 0x80.
+     */
+    struct AsciiWhitespaceBytes
+    {
+        template<class V>
+        static V match(V v)
+        {
+            V ret = inRangeBytes(v, 0x09, 0x0D);
+            ret = ret | equalsBytes(v, 0x20);
+            return ret | equalsBytes(v, 0);
+        }
+        static bool match(unsigned char ch)
+        {
+            return (ch >= 0x09 && ch <= 0x0D) || ch == 0x20 || ch == 0;
+        }
+    };
+    struct AsciiIdentifierBytes
+    {
+        template<class V>
+        static V match(V v)
+        {
+            V ret = inRangeBytes(v, 'a', 'z');
+            ret = ret | inRangeBytes(v, 'A', 'Z');
+            ret = ret | inRangeBytes(v, '0', '9');
+            return ret | equalsBytes(v, '_');
+        }
+        static bool match(unsigned char ch)
+        {
+            return AsciiIdentifier::match((wchar_t)ch);
+        }
+    };
+    struct NotLineFeedBytes
+    {
+        template<class V>
+        static V match(V v)
+        {
+            return ~equalsBytes(v, '\n');
+        }
+        static bool match(unsigned char ch)
+        {
+            return ch != '\n';
+        }
+    };
+    struct NotCommentMarkBytes
+    {
+        template<class V>
+        static V match(V v)
+        {
+            return ~(equalsBytes(v, '*') | equalsBytes(v, '/'));
+        }
+        static bool match(unsigned char ch)
+        {
+            return ch != '*' && ch != '/';
+        }
+    };
+
+    template<class Predicate>
+    inline const char* scan(const char* p, const char* end)
+    {
+        if(p >= end || !Predicate::match((unsigned char)*p))
+            return p;
+#ifdef SCANNER_AVX2
+        for(; end - p >= 32; p += 32)
+        {
+            unsigned mask = toMaskBytes(Predicate::match(_mm256_loadu_si256((const __m256i*)p)));
+            if(mask != 0xffffffffu)
+                return p + __builtin_ctz(~mask);
+        }
+#endif
+#ifdef SCANNER_SSE2
+        for(; end - p >= 16; p += 16)
+        {
+            unsigned mask = toMaskBytes(Predicate::match(_mm_loadu_si128((const __m128i*)p)));
+            if(mask != 0xffff)
+                return p + __builtin_ctz(~mask);
+        }
+#endif
+        while(p < end && Predicate::match((unsigned char)*p))
+            p++;
+        return p;
+    }
+}
+
+const wchar_t* CharScanner::skipWhitespace(const wchar_t* p, const wchar_t* end)
+{
+    return scan<Whitespace>(p, end);
+}
+
+const wchar_t* CharScanner::skipIdentifier(const wchar_t* p, const wchar_t* end)
+{
+    for(;;)
+    {
+        p = scan<AsciiIdentifier>(p, end);
+        if(p < end && *p >= 0x80 && isIdentifierCharacter(*p))
+        {
+            p++;
+            continue;
+        }
+        return p;
+    }
+}
+
+const wchar_t* CharScanner::findLineFeed(const wchar_t* p, const wchar_t* end)
+{
+    return scan<NotLineFeed>(p, end);
+}
+
+const wchar_t* CharScanner::findCommentMark(const wchar_t* p, const wchar_t* end)
+{
+    return scan<NotCommentMark>(p, end);
+}
+
+int CharScanner::countLines(const wchar_t* p, const wchar_t* end, const wchar_t*& lastLineFeed)
+{
+    int ret = 0;
+#if defined(SCANNER_AVX2) && defined(SCANNER_WIDE)
+    for(; end - p >= 8; p += 8)
+    {
+        unsigned mask = toMask(equals(_mm256_loadu_si256((const __m256i*)p), '\n'));
+        if(mask)
+        {
+            ret += __builtin_popcount(mask);
+            lastLineFeed = p + (31 - __builtin_clz(mask));
+        }
+    }
+#endif
+#if defined(SCANNER_SSE2) && defined(SCANNER_WIDE)
+    for(; end - p >= 4; p += 4)
+    {
+        unsigned mask = toMask(equals(_mm_loadu_si128((const __m128i*)p), '\n'));
+        if(mask)
+        {
+            ret += __builtin_popcount(mask);
+            lastLineFeed = p + (31 - __builtin_clz(mask));
+        }
+    }
+#endif
+    for(; p < end; p++)
+    {
+        if(*p == '\n')
+        {
+            ret++;
+            lastLineFeed = p;
+        }
+    }
+    return ret;
+}
+
+const char* CharScanner::skipWhitespace(const char* p, const char* end)
+{
+    for(;;)
+    {
+        p = scan<AsciiWhitespaceBytes>(p, end);
+        //zero width space U+200B
+        if(end - p >= 3 && p[0] == '\xE2' && p[1] == '\x80' && p[2] == '\x8B')
+        {
+            p += 3;
+            continue;
+        }
+        return p;
+    }
+}
+
+const char* CharScanner::skipIdentifier(const char* p, const char* end)
+{
+    for(;;)
+    {
+        p = scan<AsciiIdentifierBytes>(p, end);
+        if(p < end && (unsigned char)*p >= 0x80)
+        {
+            const char* next = p;
+            if(isIdentifierCharacter(Utf8::decode(next, end)))
+            {
+                p = next;
+                continue;
+            }
+        }
+        return p;
+    }
+}
+
+const char* CharScanner::findLineFeed(const char* p, const char* end)
+{
+    return scan<NotLineFeedBytes>(p, end);
+}
+
+const char* CharScanner::findCommentMark(const char* p, const char* end)
+{
+    return scan<NotCommentMarkBytes>(p, end);
+}
+
+int CharScanner::countLines(const char* p, const char* end, const char*& lastLineFeed)
+{
+    int ret = 0;
+#ifdef SCANNER_AVX2
+    for(; end - p >= 32; p += 32)
+    {
+        unsigned mask = toMaskBytes(equalsBytes(_mm256_loadu_si256((const __m256i*)p), '\n'));
+        if(mask)
+        {
+            ret += __builtin_popcount(mask);
+            lastLineFeed = p + (31 - __builtin_clz(mask));
+        }
+    }
+#endif
+#ifdef SCANNER_SSE2
+    for(; end - p >= 16; p += 16)
+    {
+        unsigned mask = toMaskBytes(equalsBytes(_mm_loadu_si128((const __m128i*)p), '\n'));
+        if(mask)
+        {
+            ret += __builtin_popcount(mask);
+            lastLineFeed = p + (31 - __builtin_clz(mask));
+        }
+    }
+#endif
+    for(; p < end; p++)
+    {
+        if(*p == '\n')
+        {
+            ret++;
+            lastLineFeed = p;
+        }
+    }
+    return ret;
+}
+
+const char* CharScanner::getInstructionSet()
+{
+#if defined(SCANNER_AVX2)
+    return "avx2";
+#elif defined(SCANNER_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,184 @@
+/* StreamTokenizer.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "tokenizer/StreamTokenizer.h"
+#include "tokenizer/CharScanner.h"
+#include "common/Utf8.h"
+#include <cstring>
+
+USE_SWALLOW_NS
+
+namespace
+{
+    /*!
+     * A token is decided by at most two characters after it(e.g. the '.' and digit after
+     * an integer), a token followed by this many bytes can not be changed by more input.
+     */
+    const size_t LOOKAHEAD_BYTES = 8;
+    /*!
+     * Bytes kept before current position, operator rules need the character before it
+     */
+    const size_t HISTORY_BYTES = 4;
+    /*!
+     * Tokenized code is dropped only after it exceeds this size
+     */
+    const size_t COMPACT_THRESHOLD = 4096;
+}
+
+StreamTokenizer::StreamTokenizer()
+    :tokenizer(NULL)
+{
+    reset();
+}
+
+void StreamTokenizer::reset()
+{
+    buffer.clear();
+    base = 0;
+    finished = false;
+    droppedLines = 0;
+    droppedColumns = 0;
+    int fileId = state.fileId;
+    tokenizer.setUtf8View(NULL, 0);
+    state = tokenizer.save();
+    state.fileId = fileId;
+}
+
+void StreamTokenizer::feed(const char* data, size_t size)
+{
+    buffer.append(data, size);
+}
+
+void StreamTokenizer::feed(const std::wstring& data)
+{
+    for(size_t i = 0; i < data.size(); i++)
+        Utf8::append(buffer, (unsigned)data[i]);
+}
+
+void StreamTokenizer::finish()
+{
+    finished = true;
+}
+
+bool StreamTokenizer::isFinished() const
+{
+    return finished && CharScanner::skipWhitespace(buffer.data() + state.offset, buffer.data() + buffer.size()) == buffer.data() + buffer.size();
+}
+
+bool StreamTokenizer::hasPendingToken() const
+{
+    const char* end = buffer.data() + buffer.size();
+    return CharScanner::skipWhitespace(buffer.data() + state.offset, end) != end;
+}
+
+void StreamTokenizer::setContext(TokenizerContext context)
+{
+    state.context = context;
+}
+
+void StreamTokenizer::setSourceFile(const SourceFilePtr& file)
+{
+    tokenizer.setSourceFile(file);
+    state.fileId = file ? file->id : 0;
+}
+
+bool StreamTokenizer::next(Token& token)
+{
+    compact();
+    tokenizer.setUtf8View(buffer.data(), buffer.size());
+    tokenizer.restore(state);
+    try
+    {
+        if(!tokenizer.next(token))
+        {
+            //only white spaces left
+            if(finished)
+            {
+                state = tokenizer.save();
+                token.state.offset += base;
+            }
+            return false;
+        }
+    }
+    catch(TokenizerError& e)
+    {
+        //errors near the end may be resolved by following input, e.g. unterminated string
+        if(!finished && (size_t)e.offset + LOOKAHEAD_BYTES > buffer.size())
+            return false;
+        e.offset += base;
+        getPosition(e.offset, e.line, e.column);
+        throw;
+    }
+    size_t end = (size_t)tokenizer.save().offset;
+    if(!finished && end + LOOKAHEAD_BYTES > buffer.size())
+    {
+        //following input may still extend or change this token, unless a line feed
+        //ends the lookahead
+        if(!memchr(buffer.data() + end, '\n', buffer.size() - end))
+            return false;
+    }
+    state = tokenizer.save();
+    token.state.offset += base;
+    return true;
+}
+
+void StreamTokenizer::compact()
+{
+    size_t offset = (size_t)state.offset;
+    if(offset < COMPACT_THRESHOLD || offset < buffer.size() / 2)
+        return;
+    size_t cut = offset - HISTORY_BYTES;
+    //never split a character
+    while(cut > 0 && Utf8::isContinuation((unsigned char)buffer[cut]))
+        cut--;
+    const char* begin = buffer.data();
+    const char* lastLineFeed = NULL;
+    int lines = CharScanner::countLines(begin, begin + cut, lastLineFeed);
+    droppedLines += lines;
+    if(lines)
+        droppedColumns = (int)Utf8::length(lastLineFeed + 1, begin + cut);
+    else
+        droppedColumns += (int)Utf8::length(begin, begin + cut);
+    buffer.erase(0, cut);
+    base += (int)cut;
+    state.offset -= (int)cut;
+}
+
+void StreamTokenizer::getPosition(int offset, int& line, int& column) const
+{
+    const char* begin = buffer.data();
+    const char* p = begin + (offset - base);
+    const char* lastLineFeed = NULL;
+    int lines = CharScanner::countLines(begin, p, lastLineFeed);
+    line = 1 + droppedLines + lines;
+    if(lines)
+        column = 1 + (int)Utf8::length(lastLineFeed + 1, p);
+    else
+        column = 1 + droppedColumns + (int)Utf8::length(begin, p);
+}
@@ -29,175 +29,335 @@
  */
 #include "tokenizer/Tokenizer.h"
 #include "tokenizer/token_char_types.h"
+#include "tokenizer/CharScanner.h"
 #include <cmath>
 #include <cstring>
 #include <wchar.h>
 #include <ctype.h>
 #include "common/Errors.h"
+#include "common/Utf8.h"
+#include "common/StringPool.h"
 using namespace Swallow;
 
-Tokenizer::Tokenizer(const wchar_t* data)
+namespace
 {
-    this->data = NULL;
-    set(data);
-    
-    //initialize keyword information
-    KeywordType::T D = KeywordType::Declaration;
-    KeywordType::T S = KeywordType::Statement;
-    KeywordType::T E = KeywordType::Expression;
-    KeywordType::T R = KeywordType::Reserved;
-    KeywordType::T I = KeywordType::SIL;
-
-    struct {
+    const KeywordType::T D = KeywordType::Declaration;
+    const KeywordType::T S = KeywordType::Statement;
+    const KeywordType::T E = KeywordType::Expression;
+    const KeywordType::T R = KeywordType::Reserved;
+    const KeywordType::T I = KeywordType::SIL;
+
+    struct KeywordEntry
+    {
         const wchar_t* name;
-        KeywordType::T type;
-        Keyword::T keyword;
-        TokenizerContext context;
-    } keywords[] = {
+        size_t length;
+        KeywordInfo info;
+    };
+#define KEYWORD(name, type, keyword, context) {name, sizeof(name) / sizeof(wchar_t) - 1, {keyword, type, context}}
+    /*!
+     * All keywords, the table is constant initialized and shared by all tokenizers
+     */
+    const KeywordEntry keywordEntries[] = {
         //Declaration keywords
-        {L"class",          D, Keyword::Class},
-        {L"deinit",         D, Keyword::Deinit},
-        {L"enum",           D, Keyword::Enum},
-        {L"extension",      D, Keyword::Extension},
-        {L"func",           D, Keyword::Func},
-        {L"import",         D, Keyword::Import},
-        {L"init",           D, Keyword::Init},
-        {L"internal",       D, Keyword::Internal},
-        {L"let",            D, Keyword::Let},
-        {L"operator",       D, Keyword::Operator},
-        {L"private",        D, Keyword::Private},
-        {L"protocol",       D, Keyword::Protocol},
-        {L"public",         D, Keyword::Public},
-        {L"static",         D, Keyword::Static},
-        {L"struct",         D, Keyword::Struct},
-        {L"subscript",      D, Keyword::Subscript},
-        {L"typealias",      D, Keyword::Typealias},
-        {L"var",            D, Keyword::Var},
+        KEYWORD(L"class",          D, Keyword::Class, TokenizerContextUnknown),
+        KEYWORD(L"deinit",         D, Keyword::Deinit, TokenizerContextUnknown),
+        KEYWORD(L"enum",           D, Keyword::Enum, TokenizerContextUnknown),
+        KEYWORD(L"extension",      D, Keyword::Extension, TokenizerContextUnknown),
+        KEYWORD(L"func",           D, Keyword::Func, TokenizerContextUnknown),
+        KEYWORD(L"import",         D, Keyword::Import, TokenizerContextUnknown),
+        KEYWORD(L"init",           D, Keyword::Init, TokenizerContextUnknown),
+        KEYWORD(L"internal",       D, Keyword::Internal, TokenizerContextUnknown),
+        KEYWORD(L"let",            D, Keyword::Let, TokenizerContextUnknown),
+        KEYWORD(L"operator",       D, Keyword::Operator, TokenizerContextUnknown),
+        KEYWORD(L"private",        D, Keyword::Private, TokenizerContextUnknown),
+        KEYWORD(L"protocol",       D, Keyword::Protocol, TokenizerContextUnknown),
+        KEYWORD(L"public",         D, Keyword::Public, TokenizerContextUnknown),
+        KEYWORD(L"static",         D, Keyword::Static, TokenizerContextUnknown),
+        KEYWORD(L"struct",         D, Keyword::Struct, TokenizerContextUnknown),
+        KEYWORD(L"subscript",      D, Keyword::Subscript, TokenizerContextUnknown),
+        KEYWORD(L"typealias",      D, Keyword::Typealias, TokenizerContextUnknown),
+        KEYWORD(L"var",            D, Keyword::Var, TokenizerContextUnknown),
         //Statement keywords
-        {L"break",          S, Keyword::Break},
-        {L"case",           S, Keyword::Case},
-        {L"continue",       S, Keyword::Continue},
-        {L"default",        S, Keyword::Default},
-        {L"do",             S, Keyword::Do},
-        {L"else",           S, Keyword::Else},
-        {L"fallthrough",    S, Keyword::Fallthrough},
-        {L"for",            S, Keyword::For},
-        {L"if",             S, Keyword::If},
-        {L"in",             S, Keyword::In},
-        {L"return",         S, Keyword::Return},
-        {L"switch",         S, Keyword::Switch},
-        {L"where",          S, Keyword::Where},
-        {L"while",          S, Keyword::While},
+        KEYWORD(L"break",          S, Keyword::Break, TokenizerContextUnknown),
+        KEYWORD(L"case",           S, Keyword::Case, TokenizerContextUnknown),
+        KEYWORD(L"continue",       S, Keyword::Continue, TokenizerContextUnknown),
+        KEYWORD(L"default",        S, Keyword::Default, TokenizerContextUnknown),
+        KEYWORD(L"do",             S, Keyword::Do, TokenizerContextUnknown),
+        KEYWORD(L"else",           S, Keyword::Else, TokenizerContextUnknown),
+        KEYWORD(L"fallthrough",    S, Keyword::Fallthrough, TokenizerContextUnknown),
+        KEYWORD(L"for",            S, Keyword::For, TokenizerContextUnknown),
+        KEYWORD(L"if",             S, Keyword::If, TokenizerContextUnknown),
+        KEYWORD(L"in",             S, Keyword::In, TokenizerContextUnknown),
+        KEYWORD(L"return",         S, Keyword::Return, TokenizerContextUnknown),
+        KEYWORD(L"switch",         S, Keyword::Switch, TokenizerContextUnknown),
+        KEYWORD(L"where",          S, Keyword::Where, TokenizerContextUnknown),
+        KEYWORD(L"while",          S, Keyword::While, TokenizerContextUnknown),
         //Expression and type keywords
-        {L"as",             E, Keyword::As},
-        {L"dynamicType",    E, Keyword::DynamicType},
-        {L"false",          E, Keyword::False},
-
-        {L"is",             E, Keyword::Is},
-
-        {L"nil",            E, Keyword::Nil},
-        {L"new",            E, Keyword::New},
-        {L"self",           E, Keyword::Self},
-        {L"Self",           E, Keyword::SelfType},
-        {L"super",          E, Keyword::Super},
-        {L"true",           E, Keyword::True},
-
-        {L"__COLUMN__",     E, Keyword::Column},
-        {L"__FILE__",       E, Keyword::File},
-        {L"__FUNCTION__",   E, Keyword::Function},
-        {L"__LINE__",       E, Keyword::Line},
+        KEYWORD(L"as",             E, Keyword::As, TokenizerContextUnknown),
+        KEYWORD(L"dynamicType",    E, Keyword::DynamicType, TokenizerContextUnknown),
+        KEYWORD(L"false",          E, Keyword::False, TokenizerContextUnknown),
+
+        KEYWORD(L"is",             E, Keyword::Is, TokenizerContextUnknown),
+
+        KEYWORD(L"nil",            E, Keyword::Nil, TokenizerContextUnknown),
+        KEYWORD(L"new",            E, Keyword::New, TokenizerContextUnknown),
+        KEYWORD(L"self",           E, Keyword::Self, TokenizerContextUnknown),
+        KEYWORD(L"Self",           E, Keyword::SelfType, TokenizerContextUnknown),
+        KEYWORD(L"super",          E, Keyword::Super, TokenizerContextUnknown),
+        KEYWORD(L"true",           E, Keyword::True, TokenizerContextUnknown),
+
+        KEYWORD(L"__COLUMN__",     E, Keyword::Column, TokenizerContextUnknown),
+        KEYWORD(L"__FILE__",       E, Keyword::File, TokenizerContextUnknown),
+        KEYWORD(L"__FUNCTION__",   E, Keyword::Function, TokenizerContextUnknown),
+        KEYWORD(L"__LINE__",       E, Keyword::Line, TokenizerContextUnknown),
         //Reserved keywords
-        {L"associativity",  R, Keyword::Associativity, TokenizerContextOperator},
-        {L"assignment",     R, Keyword::Assignment, TokenizerContextOperator},
-        {L"convenience",    R, Keyword::Convenience, TokenizerContextClass},
-        {L"dynamic",        R, Keyword::Dynamic, TokenizerContextClass},
-        {L"didSet",         R, Keyword::DidSet, TokenizerContextComputedProperty},
-        {L"final",          R, Keyword::Final, TokenizerContextDeclaration},
-        {L"get",            R, Keyword::Get, TokenizerContextComputedProperty},
-        {L"infix",          R, Keyword::Infix, TokenizerContextAll},
-        {L"inout",          R, Keyword::Inout, TokenizerContextFunctionSignature},
-        {L"lazy",           R, Keyword::Lazy, TokenizerContextDeclaration},
-        {L"left",           R, Keyword::Left, TokenizerContextOperator},
-        {L"mutating",       R, Keyword::Mutating, (TokenizerContext)(TokenizerContextDeclaration | TokenizerContextComputedProperty)},
-        {L"none",           R, Keyword::None, TokenizerContextOperator},
-        {L"nonmutating",    R, Keyword::Nonmutating, (TokenizerContext)(TokenizerContextDeclaration | TokenizerContextComputedProperty)},
-        {L"optional",       R, Keyword::Optional, TokenizerContextClass},
-        {L"override",       R, Keyword::Override, (TokenizerContext)(TokenizerContextClass | TokenizerContextFile)},
-        {L"postfix",        R, Keyword::Postfix, TokenizerContextAll},
-        {L"precedence",     R, Keyword::Precedence, TokenizerContextOperator},
-        {L"prefix",         R, Keyword::Prefix, TokenizerContextAll},
-        {L"Protocol",       R, Keyword::Protocol_Reserved, TokenizerContextUnknown}, //TODO: update the context here
-        {L"required",       R, Keyword::Required, TokenizerContextClass},
-        {L"right",          R, Keyword::Right, TokenizerContextOperator},
-        {L"set",            R, Keyword::Set, TokenizerContextComputedProperty},
-        {L"Type",           R, Keyword::Type, TokenizerContextUnknown}, //TODO: update the context according to its usage.
-        {L"unowned",        R, Keyword::Unowned, (TokenizerContext)(TokenizerContextCaptureList | TokenizerContextClass)},
-        {L"weak",           R, Keyword::Weak, (TokenizerContext)(TokenizerContextCaptureList | TokenizerContextClass)},
-        {L"willSet",        R, Keyword::WillSet, TokenizerContextComputedProperty},
+        KEYWORD(L"associativity",  R, Keyword::Associativity, TokenizerContextOperator),
+        KEYWORD(L"assignment",     R, Keyword::Assignment, TokenizerContextOperator),
+        KEYWORD(L"convenience",    R, Keyword::Convenience, TokenizerContextClass),
+        KEYWORD(L"dynamic",        R, Keyword::Dynamic, TokenizerContextClass),
+        KEYWORD(L"didSet",         R, Keyword::DidSet, TokenizerContextComputedProperty),
+        KEYWORD(L"final",          R, Keyword::Final, TokenizerContextDeclaration),
+        KEYWORD(L"get",            R, Keyword::Get, TokenizerContextComputedProperty),
+        KEYWORD(L"infix",          R, Keyword::Infix, TokenizerContextAll),
+        KEYWORD(L"inout",          R, Keyword::Inout, TokenizerContextFunctionSignature),
+        KEYWORD(L"lazy",           R, Keyword::Lazy, TokenizerContextDeclaration),
+        KEYWORD(L"left",           R, Keyword::Left, TokenizerContextOperator),
+        KEYWORD(L"mutating",       R, Keyword::Mutating, (TokenizerContext)(TokenizerContextDeclaration | TokenizerContextComputedProperty)),
+        KEYWORD(L"none",           R, Keyword::None, TokenizerContextOperator),
+        KEYWORD(L"nonmutating",    R, Keyword::Nonmutating, (TokenizerContext)(TokenizerContextDeclaration | TokenizerContextComputedProperty)),
+        KEYWORD(L"optional",       R, Keyword::Optional, TokenizerContextClass),
+        KEYWORD(L"override",       R, Keyword::Override, (TokenizerContext)(TokenizerContextClass | TokenizerContextFile)),
+        KEYWORD(L"postfix",        R, Keyword::Postfix, TokenizerContextAll),
+        KEYWORD(L"precedence",     R, Keyword::Precedence, TokenizerContextOperator),
+        KEYWORD(L"prefix",         R, Keyword::Prefix, TokenizerContextAll),
+        KEYWORD(L"Protocol",       R, Keyword::Protocol_Reserved, TokenizerContextUnknown), //TODO: update the context here
+        KEYWORD(L"required",       R, Keyword::Required, TokenizerContextClass),
+        KEYWORD(L"right",          R, Keyword::Right, TokenizerContextOperator),
+        KEYWORD(L"set",            R, Keyword::Set, TokenizerContextComputedProperty),
+        KEYWORD(L"Type",           R, Keyword::Type, TokenizerContextUnknown), //TODO: update the context according to its usage.
+        KEYWORD(L"unowned",        R, Keyword::Unowned, (TokenizerContext)(TokenizerContextCaptureList | TokenizerContextClass)),
+        KEYWORD(L"weak",           R, Keyword::Weak, (TokenizerContext)(TokenizerContextCaptureList | TokenizerContextClass)),
+        KEYWORD(L"willSet",        R, Keyword::WillSet, TokenizerContextComputedProperty),
         //SIL keywords
-        {L"sil",               I, Keyword::SIL, TokenizerContextSIL},
-        {L"sil_stage",         I, Keyword::SIL_Stage, TokenizerContextSIL},
-        {L"sil_vtable",        I, Keyword::SIL_VTable, TokenizerContextSIL},
-        {L"sil_witness_table", I, Keyword::SIL_Witness_Table, TokenizerContextSIL},
-        {L"module",            I, Keyword::Module, TokenizerContextSIL},
-        {L"method",            I, Keyword::Method, TokenizerContextSIL},
-        {L"base_protocol",     I, Keyword::Base_Protocol, TokenizerContextSIL},
-        {L"sil_global",        I, Keyword::SIL_Global, TokenizerContextSIL}
+        KEYWORD(L"sil",               I, Keyword::SIL, TokenizerContextSIL),
+        KEYWORD(L"sil_stage",         I, Keyword::SIL_Stage, TokenizerContextSIL),
+        KEYWORD(L"sil_vtable",        I, Keyword::SIL_VTable, TokenizerContextSIL),
+        KEYWORD(L"sil_witness_table", I, Keyword::SIL_Witness_Table, TokenizerContextSIL),
+        KEYWORD(L"module",            I, Keyword::Module, TokenizerContextSIL),
+        KEYWORD(L"method",            I, Keyword::Method, TokenizerContextSIL),
+        KEYWORD(L"base_protocol",     I, Keyword::Base_Protocol, TokenizerContextSIL),
+        KEYWORD(L"sil_global",        I, Keyword::SIL_Global, TokenizerContextSIL)
     };
-    
-    for(unsigned i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++)
+#undef KEYWORD
+    const size_t KEYWORD_COUNT = sizeof(keywordEntries) / sizeof(keywordEntries[0]);
+
+    /*!
+     * Open addressing hash table of keywordEntries, hashed by length, first and last character.
+     * The slots are built once on first use and never changes.
+     */
+    class KeywordTable
+    {
+    public:
+        enum
+        {
+            SLOTS = 256
+        };
+        KeywordTable()
+        {
+            memset(slots, 0xff, sizeof(slots));
+            for(size_t i = 0; i < KEYWORD_COUNT; i++)
+            {
+                const KeywordEntry& entry = keywordEntries[i];
+                unsigned h = hash(entry.name, entry.length);
+                while(slots[h] != EMPTY)
+                    h = (h + 1) & (SLOTS - 1);
+                slots[h] = (unsigned char)i;
+                names[entry.info.keyword] = entry.name;
+            }
+        }
+        const KeywordInfo* find(const wchar_t* name, size_t length) const
+        {
+            if(length < 2 || length > MAX_LENGTH)
+                return nullptr;
+            for(unsigned h = hash(name, length); slots[h] != EMPTY; h = (h + 1) & (SLOTS - 1))
+            {
+                const KeywordEntry& entry = keywordEntries[slots[h]];
+                if(entry.length == length && !wmemcmp(entry.name, name, length))
+                    return &entry.info;
+            }
+            return nullptr;
+        }
+        const std::wstring& getName(Keyword::T keyword) const
+        {
+            return names[keyword];
+        }
+    private:
+        static unsigned hash(const wchar_t* name, size_t length)
+        {
+            return (unsigned)(length * 37 + name[0] * 11 + name[length - 1] * 3 + name[length >> 1]) & (SLOTS - 1);
+        }
+    private:
+        enum
+        {
+            EMPTY = 0xff,
+            MAX_LENGTH = 17
+        };
+        unsigned char slots[SLOTS];
+        std::wstring names[Keyword::Module + 1];
+    };
+    const KeywordTable& keywordTable()
     {
-        std::wstring name = keywords[i].name;
-        KeywordInfo info = {keywords[i].keyword, keywords[i].type, keywords[i].context};
-        this->keywords.insert(std::make_pair(name, info));
-        this->keywordNames.insert(std::make_pair(info.keyword, name));
+        static const KeywordTable table;
+        return table;
     }
-    
+}
+
+namespace
+{
+    /*!
+     * Copy the text of a token, UTF-8 text is decoded
+     */
+    inline void assign(std::wstring& out, const wchar_t* begin, const wchar_t* end)
+    {
+        out.assign(begin, end);
+    }
+    inline void assign(std::wstring& out, const char* begin, const char* end)
+    {
+        out.clear();
+        Utf8::append(out, begin, end);
+    }
+    /*!
+     * Scan the multi-line comment starting from begin, which is right after the opening mark.
+     * Returns the end of the comment, contentEnd is set to the closing mark.
+     */
+    template<class T>
+    const T* scanMultilineComment(const T* begin, const T* end, const T*& contentEnd, int& nestedLevels)
+    {
+        const T* p = begin;
+        int level = 1;
+        contentEnd = end;
+        while((p = CharScanner::findCommentMark(p, end)) + 1 < end)
+        {
+            if(p[0] == '/' && p[1] == '*')
+            {
+                nestedLevels++;
+                level++;
+                p += 2;
+                continue;
+            }
+            if(p[0] == '*' && p[1] == '/')
+            {
+                p += 2;
+                level--;
+                if(level == 0)
+                {
+                    contentEnd = p - 2;
+                    return p;
+                }
+                continue;
+            }
+            p++;
+        }
+        return end;
+    }
+}
+
+Tokenizer::Tokenizer(const wchar_t* data)
+{
+    this->buffer = NULL;
+    this->data = NULL;
+    this->utf8 = NULL;
+    this->skipComments = false;
+    this->recordComments = true;
+    this->stringPool = NULL;
+    set(data);
 }
 
 const std::wstring& Tokenizer::getKeyword(Keyword::T k)
 {
-    return keywordNames[k];
+    return keywordTable().getName(k);
+}
+
+/*!
+ * Find the keyword information of given identifier regardless of the context
+ */
+const KeywordInfo* Tokenizer::findKeyword(const wchar_t* identifier, size_t length)
+{
+    return keywordTable().find(identifier, length);
 }
 
 void Tokenizer::set(const wchar_t* data)
 {
-    if(this->data)
+    wchar_t* copy = NULL;
+    size_t size = 0;
+    //copy string
+    if(data)
+    {
+        size = wcslen(data);
+        copy = new wchar_t[size + 1];
+        memcpy(copy, data, (size + 1) * sizeof(wchar_t));
+    }
+    setView(copy, size);
+    buffer = copy;
+}
+
+void Tokenizer::setView(const wchar_t* data, size_t size)
+{
+    if(buffer)
     {
-        delete[] this->data;
+        delete[] buffer;
+        buffer = NULL;
     }
     //reset state
-    this->data = NULL;
-    size = 0;
-    end = 0;
-    state.cursor = 0;
+    this->data = data;
+    this->size = data ? size : 0;
+    end = data ? data + size : NULL;
+    utf8 = NULL;
+    utf8End = NULL;
+    state.offset = 0;
     state.hasSpace = false;
     state.inStringExpression = 0;
-    state.line = 1;
-    state.column = 1;
     state.context = TokenizerContextFile;
-    //copy string
-    if(data)
-    {
-        size = wcslen(data);
-        this->data = new wchar_t[size + 1];
-        memcpy(this->data, data, (size + 1) * sizeof(wchar_t));
-        state.cursor = 0;
-        end = this->data + size;
-    }
-    memset(positions, 0, sizeof(positions));
+}
+void Tokenizer::setUtf8View(const char* data, size_t size)
+{
+    setView(NULL, 0);
+    if(!data)
+        return;
+    utf8 = data;
+    utf8End = data + size;
+    this->size = size;
 }
 Tokenizer::~Tokenizer()
 {
     set(NULL);
 }
 
+/*!
+ * Skip comments as trivia instead of returning them as tokens
+ */
+void Tokenizer::setSkipComments(bool skip)
+{
+    skipComments = skip;
+}
+void Tokenizer::setRecordComments(bool record)
+{
+    recordComments = record;
+}
 /*!
  * Tells the tokenizer the current file
  */
 void Tokenizer::setSourceFile(const SourceFilePtr& file)
 {
-    state.sourceFile = file;
+    sourceFile = file;
+    state.fileId = file ? file->id : 0;
+}
+/*!
+ * Tells the tokenizer where to intern identifiers and operators
+ */
+void Tokenizer::setStringPool(StringPool* pool)
+{
+    stringPool = pool;
 }
 /*!
  * Save current state for restoring later
@@ -229,11 +389,41 @@ void Tokenizer::setContext(TokenizerContext context)
     state.context = context;
 }
 
+/*!
+ * Check if the token would be lexed differently when tokenizer is in another context
+ */
+bool Tokenizer::isContextSensitive(const Token& token) const
+{
+    switch(token.type)
+    {
+        case TokenType::Identifier:
+        {
+            if(token.identifier.backtick || token.identifier.implicitParameterName)
+                return false;
+            //reserved keywords are only recognized in specified context
+            const KeywordInfo* keyword = findKeyword(token.token.c_str(), token.token.size());
+            if(!keyword)
+                return false;
+            return keyword->type == KeywordType::Reserved && keyword->context != TokenizerContextAll;
+        }
+        case TokenType::Operator:
+        case TokenType::Optional:
+            //'<' and '>' are split in type context and function signature context
+            return token.token.find_first_of(L"<>") != std::wstring::npos;
+        default:
+            return false;
+    }
+}
+
 void Tokenizer::resetToken(Token& token)
 {
     token.type = TokenType::_;
     token.token.clear();
     token.size = 0;
+    token.text = NULL;
+    token.utf8 = NULL;
+    token.length = 0;
+    token.symbol = 0;
 }
 bool Tokenizer::peek(wchar_t &ch)
 {
@@ -244,66 +434,113 @@ bool Tokenizer::peek(wchar_t &ch)
 }
 bool Tokenizer::get(wchar_t &ch)
 {
-    if(state.cursor >= (int)size)
+    if(state.offset >= (int)size)
         return false;
-    //save line and column
-    int p = (state.cursor << 1) & 0xf;
-    positions[p] = state.line;
-    positions[p | 1] = state.column;
-    
-    
-    ch = data[state.cursor++];
-    if(ch == '\n')
+    if(utf8)
+    {
+        const char* p = utf8 + state.offset;
+        if((unsigned char)*p < 0x80)
+        {
+            ch = *p;
+            state.offset++;
+            return true;
+        }
+        ch = (wchar_t)Utf8::decode(p, utf8End);
+        advance(p);
+    }
+    else
+        ch = data[state.offset++];
+    return true;
+}
+void Tokenizer::unget()
+{
+    if(utf8 && (unsigned char)utf8[state.offset - 1] >= 0x80)
     {
-        //move to next line
-        state.line++;
-        state.column = 1;
+        const char* p = utf8 + state.offset;
+        Utf8::decodeBackward(p, utf8);
+        advance(p);
     }
     else
+        state.offset--;
+}
+/*!
+ * Returns the character at given offset without moving the cursor
+ */
+wchar_t Tokenizer::charAt(int offset) const
+{
+    if(utf8)
     {
-        //move to next column
-        state.column++;
+        const char* p = utf8 + offset;
+        return (wchar_t)Utf8::decode(p, utf8End);
     }
-    return true;
+    return data[offset];
 }
-void Tokenizer::unget()
+/*!
+ * Returns the character right before given offset
+ */
+wchar_t Tokenizer::charBefore(int offset) const
+{
+    if(utf8)
+    {
+        const char* p = utf8 + offset;
+        return (wchar_t)Utf8::decodeBackward(p, utf8);
+    }
+    return data[offset - 1];
+}
+/*!
+ * Move cursor forward to given position
+ */
+void Tokenizer::advance(const wchar_t* to)
 {
-    state.cursor--;
-    int p = (state.cursor << 1) & 0xf;
-    state.line = positions[p];
-    state.column = positions[p | 1];
+    state.offset = (int)(to - data);
 }
-bool Tokenizer::skipSpaces()
+void Tokenizer::advance(const char* to)
 {
-    bool hasSpace = false;
-    wchar_t ch;
-    while(get(ch))
+    state.offset = (int)(to - utf8);
+}
+/*!
+ * Resolve line and column of given offset by counting line feeds before it,
+ * used when no source file is available.
+ */
+void Tokenizer::getPosition(int offset, int& line, int& column) const
+{
+    if(utf8)
     {
-        if(!iswhite(ch))
-        {
-            unget();
-            return hasSpace;
-        }
-        hasSpace = true;
+        //column counts characters, not bytes
+        const char* lastLineFeed = utf8 - 1;
+        line = 1 + CharScanner::countLines(utf8, utf8 + offset, lastLineFeed);
+        column = 1 + (int)Utf8::length(lastLineFeed + 1, utf8 + offset);
+        return;
     }
-    return hasSpace;
+    const wchar_t* lastLineFeed = data - 1;
+    line = 1 + CharScanner::countLines(data, data + offset, lastLineFeed);
+    column = (int)(data + offset - lastLineFeed);
+}
+bool Tokenizer::skipSpaces()
+{
+    int offset = state.offset;
+    if(utf8)
+        advance(CharScanner::skipWhitespace(utf8 + offset, utf8End));
+    else
+        advance(CharScanner::skipWhitespace(data + offset, end));
+    return state.offset != offset;
 }
-bool Tokenizer::hasWhiteLeft(const wchar_t* cursor)
+bool Tokenizer::hasWhiteLeft(int offset)
 {
-    if(cursor > data)
+    if(offset > 0)
     {
-        wchar_t ch = cursor[-1];
+        wchar_t ch = charBefore(offset);
         return iswhite(ch) || ch == '{' || ch == '(' || ch == '[' || ch == ',' || ch == ';' || ch == ':';
     }
     else
         return true;//BOF means has white before
 }
 
-bool Tokenizer::hasWhiteRight(const wchar_t* cursor)
+bool Tokenizer::hasWhiteRight(int offset)
 {
-    if(cursor < data + size)
+    if(offset < (int)size)
     {
-        wchar_t ch = *cursor;
+        wchar_t ch = charAt(offset);
         return iswhite(ch) || ch == '}' || ch == ')' || ch == ']' || ch == ',' || ch == ';' || ch == ':';
     }
     return true;//EOF means has white after
@@ -314,11 +551,12 @@ bool Tokenizer::readOperator(Token& token, bool dotOperator, int max)
     wchar_t ch;
     token.type = TokenType::Operator;
     token.operators.type = OperatorType::_;
-    const wchar_t* cursor = data + state.cursor;
-    bool whiteLeft = hasWhiteLeft(cursor);
-    const wchar_t* begin = cursor;
-    
-    while(get(ch) && (!max || token.token.size() < (size_t)max))
+    int begin = state.offset;
+    bool whiteLeft = hasWhiteLeft(begin);
+    //the operator is scanned first and its text is copied at once
+    int length = 0;
+    wchar_t last = 0;
+    while((!max || length < max) && get(ch))
     {
         bool ret = dotOperator ? isDotOperatorCharacter(ch) : isOperatorCharacter(ch);
         if(!ret)
@@ -326,14 +564,15 @@ bool Tokenizer::readOperator(Token& token, bool dotOperator, int max)
             unget();
             break;
         }
-        if(!token.token.empty() && token.token.back() != '.' && ch == '.')
+        if(length && last != '.' && ch == '.')
         {
             //This is a undocumented rule of operator
             //An operator contains dot(.) can not contain other characters.
             unget();
             break;
         }
-        token.append(ch);
+        length++;
+        last = ch;
         if(!whiteLeft && (ch == '?' || ch == '!'))
         {
             //no white before, ?! will be used as syntax sugar operator, only one character
@@ -344,21 +583,23 @@ bool Tokenizer::readOperator(Token& token, bool dotOperator, int max)
         if((ch == '<' || ch == '>') && state.context == TokenizerContextType)
             break;
     }
-    if(state.context == TokenizerContextFunctionSignature && token.token.size() > 1 && token.token.back() == '<')
+    if(state.context == TokenizerContextFunctionSignature && length > 1 && last == '<')
     {
         wchar_t c;
         if(!peek(c) || c != '(')
-        {
             unget();
-            token.token.erase(token.token.end() - 1);
-        }
     }
-    token.operators.type = calculateOperatorType(begin, begin + token.token.size());
+    if(utf8)
+        assign(token.token, utf8 + begin, utf8 + state.offset);
+    else
+        assign(token.token, data + begin, data + state.offset);
+    token.size = token.token.size();
+    token.operators.type = calculateOperatorType(begin, state.offset);
     if(token.token == L"?")
         token.type = TokenType::Optional;
     return true;
 }
-OperatorType::T Tokenizer::calculateOperatorType(const wchar_t* begin, const wchar_t* end)
+OperatorType::T Tokenizer::calculateOperatorType(int begin, int end)
 {
     OperatorType::T ret = OperatorType::_;
     bool whiteLeft = hasWhiteLeft(begin);
@@ -379,14 +620,13 @@ OperatorType::T Tokenizer::calculateOperatorType(const wchar_t* begin, const wch
         ret = OperatorType::PostfixUnary;
     }
     
-    if(!whiteLeft && (end < (data + size)) && *end == '.')
+    if(!whiteLeft && end < (int)size && charAt(end) == '.')
     {
         //If an operator has no whitespace on the left but is followed immediately by a dot (.), it is treated as a postfix unary operator. As an example, the ++ operator in a++.b is treated as a postfix unary operator (a++ . b rather than a ++ .b).
         ret = OperatorType::PostfixUnary;
     }
-    wchar_t front = *begin;
-    size_t size = end - begin;
-    if(!whiteLeft && size == 1 && (front == '?' || front == '!'))
+    wchar_t front = charAt(begin);
+    if(!whiteLeft && end - begin == 1 && (front == '?' || front == '!'))
     {
         //“If the ! or ? operator has no whitespace on the left, it is treated as a postfix operator”
         ret = OperatorType::PostfixUnary;
@@ -396,51 +636,52 @@ OperatorType::T Tokenizer::calculateOperatorType(const wchar_t* begin, const wch
 
 bool Tokenizer::readMultilineComment(Token& token)
 {
-    wchar_t ch, last;
     token.type = TokenType::Comment;
     token.comment.multiline = true;
     token.comment.nestedLevels = 0;
-    get(ch);
-    get(ch);
-    int level = 1;
-    for(;get(ch); last = ch)
+    if(utf8)
     {
-        if(last == '/' && ch == '*')
-        {
-            token.comment.nestedLevels++;
-            level++;
-        }
-        if(last == '*' && ch == '/')
-        {
-            level--;
-            if(level == 0)
-            {
-                token.token.pop_back();
-                break;
-            }
-        }
-        token.append(ch);
+        const char* contentEnd;
+        const char* begin = utf8 + state.offset + 2;
+        const char* p = scanMultilineComment(begin, utf8End, contentEnd, token.comment.nestedLevels);
+        assign(token.token, begin, contentEnd);
+        advance(p);
     }
-    
+    else
+    {
+        const wchar_t* contentEnd;
+        const wchar_t* begin = data + state.offset + 2;
+        const wchar_t* p = scanMultilineComment(begin, end, contentEnd, token.comment.nestedLevels);
+        assign(token.token, begin, contentEnd);
+        advance(p);
+    }
+    token.size = token.token.size();
     return true;
 }
 bool Tokenizer::readComment(Token& token)
 {
-    wchar_t ch;
     //read until end of line
     token.type = TokenType::Comment;
     token.comment.multiline = false;
     token.comment.nestedLevels = 0;
-    get(ch);
-    get(ch);
-    while (get(ch))
-    {
-        if(ch == '\n')
-            break;
-        token.append(ch);
-    }
+    //skip the //
+    if(utf8)
+        advance(readComment(token, utf8 + state.offset + 2, utf8End));
+    else
+        advance(readComment(token, data + state.offset + 2, end));
     return true;
 }
+template<class T>
+const T* Tokenizer::readComment(Token& token, const T* begin, const T* end)
+{
+    const T* p = CharScanner::findLineFeed(begin, end);
+    assign(token.token, begin, p);
+    token.size = token.token.size();
+    //the line feed belongs to the comment
+    if(p < end)
+        p++;
+    return p;
+}
 bool Tokenizer::readString(Token& token)
 {
     wchar_t ch;
@@ -677,9 +918,8 @@ bool Tokenizer::readIdentifier(Token& token)
     if(ch == '$')
     {
         //implicit-parameter-name -> $ decimal-digits
-        token.append(ch);
+        int begin = state.offset - 1;
         ch = must_get();
-        token.append(ch);
         if(isdigit(ch))
         {
             while (get(ch))
@@ -689,25 +929,39 @@ bool Tokenizer::readIdentifier(Token& token)
                     unget();
                     break;
                 }
-                token.append(ch);
             }
+            if(utf8)
+                assign(token.token, utf8 + begin, utf8 + state.offset);
+            else
+                assign(token.token, data + begin, data + state.offset);
+            token.size = token.token.size();
             token.identifier.implicitParameterName = true;
             return true;
         }
+        token.append('$');
+        token.append(ch);
     }
     else if(ch == '`')
         token.identifier.backtick = true;
     else
-        token.append(ch);
-    while(get(ch))
+        unget();
+    //identifier never contains new line, so the text can be copied at once without
+    //going through get()
+    if(utf8)
     {
-        if(!isIdentifierCharacter(ch))
-        {
-            unget();
-            break;
-        }
-        token.append(ch);
+        const char* begin = utf8 + state.offset;
+        const char* p = CharScanner::skipIdentifier(begin, utf8End);
+        Utf8::append(token.token, begin, p);
+        advance(p);
+    }
+    else
+    {
+        const wchar_t* begin = data + state.offset;
+        const wchar_t* p = CharScanner::skipIdentifier(begin, end);
+        token.token.append(begin, p);
+        advance(p);
     }
+    token.size = token.token.size();
     if(token.identifier.backtick)
     {
         match('`');
@@ -715,7 +969,7 @@ bool Tokenizer::readIdentifier(Token& token)
     if(!token.identifier.backtick && !token.identifier.implicitParameterName)
     {
         //resolve keyword
-        KeywordInfo* keyword = getKeyword(token.token);
+        const KeywordInfo* keyword = getKeyword(token.token);
         if(keyword)
         {
             token.identifier.keyword = keyword->keyword;
@@ -725,17 +979,17 @@ bool Tokenizer::readIdentifier(Token& token)
     return true;
 }
 
-KeywordInfo* Tokenizer::getKeyword(const std::wstring& identifier)
+const KeywordInfo* Tokenizer::getKeyword(const std::wstring& identifier)
 {
-    std::map<std::wstring, KeywordInfo>::iterator iter = keywords.find(identifier);
-    if(iter == keywords.end())
+    const KeywordInfo* keyword = findKeyword(identifier.c_str(), identifier.size());
+    if(!keyword)
         return nullptr;
     //if not a reserved keyword or can exists in any context
-    if(iter->second.type != KeywordType::Reserved || iter->second.context == TokenizerContextAll)
-        return &iter->second;
+    if(keyword->type != KeywordType::Reserved || keyword->context == TokenizerContextAll)
+        return keyword;
     //check if it's in right context
-    if(state.context != TokenizerContextUnknown && (state.context & iter->second.context) == state.context)
-        return &iter->second;
+    if(state.context != TokenizerContextUnknown && (state.context & keyword->context) == state.context)
+        return keyword;
     return nullptr;
 }
 
@@ -751,8 +1005,8 @@ wchar_t Tokenizer::must_get()
 void Tokenizer::error(int errorCode, const std::wstring& str)
 {
     TokenizerError error;
-    error.column = state.column;
-    error.line = state.line;
+    error.offset = state.offset;
+    getPosition(state.offset, error.line, error.column);
     error.errorCode = errorCode;
     error.item = str;
     throw error;
@@ -779,11 +1033,71 @@ bool Tokenizer::peek(Token& token)
     this->state = state;
     return ret;
 }
+/*!
+ * Skip the comment at cursor without building its text, it's recorded in the source file's
+ * comment table. Returns false if there's no comment at cursor.
+ */
+bool Tokenizer::skipComment()
+{
+    int begin = state.offset;
+    if(begin + 1 >= (int)size || charAt(begin) != '/')
+        return false;
+    wchar_t mark = charAt(begin + 1);
+    if(mark != '/' && mark != '*')
+        return false;
+    bool doc = begin + 2 < (int)size && charAt(begin + 2) == mark;
+    int length;
+    CommentTrivia::Kind kind;
+    if(mark == '/')
+    {
+        kind = doc ? CommentTrivia::DocLine : CommentTrivia::Line;
+        if(utf8)
+            advance(CharScanner::findLineFeed(utf8 + begin + 2, utf8End));
+        else
+            advance(CharScanner::findLineFeed(data + begin + 2, end));
+        length = state.offset - begin;
+        //the line feed belongs to the comment
+        if(state.offset < (int)size)
+            state.offset++;
+    }
+    else
+    {
+        //“/**/” is an empty block comment rather than a documentation comment
+        kind = doc && !(begin + 3 < (int)size && charAt(begin + 3) == '/') ? CommentTrivia::DocBlock : CommentTrivia::Block;
+        int nestedLevels = 0;
+        if(utf8)
+        {
+            const char* contentEnd;
+            advance(scanMultilineComment(utf8 + begin + 2, utf8End, contentEnd, nestedLevels));
+        }
+        else
+        {
+            const wchar_t* contentEnd;
+            advance(scanMultilineComment(data + begin + 2, end, contentEnd, nestedLevels));
+        }
+        length = state.offset - begin;
+    }
+    if(recordComments && sourceFile)
+        sourceFile->addComment(begin, length, kind);
+    return true;
+}
 bool Tokenizer::next(Token& token)
 {
     resetToken(token);
     state.hasSpace = skipSpaces();
+    while(skipComments && skipComment())
+        state.hasSpace = skipSpaces();
     bool ret = nextImpl(token);
+    if(ret)
+    {
+        if(utf8)
+            token.utf8 = utf8 + token.state.offset;
+        else
+            token.text = data + token.state.offset;
+        token.length = state.offset - token.state.offset;
+        if(stringPool && (token.type == TokenType::Identifier || token.type == TokenType::Operator))
+            token.symbol = stringPool->intern(token.token);
+    }
     return ret;
 }
 bool Tokenizer::nextImpl(Token& token)
@@ -853,7 +1167,7 @@ bool Tokenizer::nextImpl(Token& token)
         /*
         case '?':
         {
-            bool whiteLeft = hasWhiteLeft(data + state.cursor);
+            bool whiteLeft = hasWhiteLeft(state.offset);
             token.operators.type = whiteLeft ? OperatorType::InfixBinary : OperatorType::PostfixUnary;
             return readSymbol(token, TokenType::Optional);
         }
@@ -867,7 +1181,7 @@ bool Tokenizer::nextImpl(Token& token)
         return readNumber(token);
     if(ch == '+' || ch == '-')
     {
-        bool whiteLeft = hasWhiteLeft(data +state.cursor);
+        bool whiteLeft = hasWhiteLeft(state.offset);
         must_get();
         if(whiteLeft && peek(ch) && isdigit(ch))
         {
@@ -875,7 +1189,7 @@ bool Tokenizer::nextImpl(Token& token)
             return readNumber(token);
         }
         unget();
-        ch = data[state.cursor];
+        ch = charAt(state.offset);
     }
 
     if(isOperatorHead(ch))
@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "../utils.h"
+#include "parser/DeclarationSplitter.h"
 
 using namespace Swallow;
 
@@ -318,5 +319,54 @@ TEST(TestDeclaration, TypeAlias_NoType)
     PARSE_STATEMENT(L"typealias NewType");
     ASSERT_EQ(1, compilerResults.numResults());
 }
-
-
+TEST(TestDeclaration, testSplitDeclarations)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const wchar_t* code = L"class A { func foo() { } }\n"
+                          L"//comment\n"
+                          L"func bar() -> Int { return 1 }\n"
+                          L"let a = bar()\n"
+                          L"@objc\n"
+                          L"class B { }\n"
+                          L"public\n"
+                          L"struct C { let b = [1,\n"
+                          L"   2] }\n"
+                          L"enum D { case E }";
+    SourceFilePtr sourceFile(new SourceFile(L"split", code));
+    DeclarationSplitter splitter;
+    splitter.setSourceFile(sourceFile);
+    std::vector<int> chunks;
+    ASSERT_TRUE(splitter.split(code, wcslen(code), 1, chunks));
+    //attributes and modifiers on their own lines stay with the declaration
+    ASSERT_EQ(5, (int)chunks.size());
+    ASSERT_EQ(0, chunks[0]);
+    ASSERT_EQ(std::wstring(code).find(L"func bar"), (size_t)chunks[1]);
+    ASSERT_EQ(std::wstring(code).find(L"let a"), (size_t)chunks[2]);
+    ASSERT_EQ(std::wstring(code).find(L"public"), (size_t)chunks[3]);
+    ASSERT_EQ(std::wstring(code).find(L"enum D"), (size_t)chunks[4]);
+    ASSERT_EQ(1, (int)sourceFile->comments.size());
+
+    //chunks parsed separately produce the same statements as a whole parse
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    ProgramPtr program = nodeFactory.createProgram();
+    chunks.push_back(wcslen(code));
+    for(size_t i = 0; i + 1 < chunks.size(); i++)
+    {
+        Parser parser(&nodeFactory, &compilerResults);
+        parser.setSourceFile(sourceFile);
+        ASSERT_TRUE(parser.parseChunk(code, chunks[i], chunks[i + 1], program));
+    }
+    ASSERT_EQ(0, compilerResults.numResults());
+    ASSERT_EQ(1, (int)sourceFile->comments.size());
+    ASSERT_EQ(6, program->numStatements());
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<ClassDef>(program->getStatement(0)));
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<FunctionDef>(program->getStatement(1)));
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<StructDef>(program->getStatement(4)));
+    //positions are still offsets of the whole code
+    ASSERT_EQ(std::wstring(code).find(L"D {"), (size_t)program->getStatement(5)->getSourceInfo()->offset);
+
+    //a small chunk size won't split
+    ASSERT_TRUE(splitter.split(code, wcslen(code), 1000, chunks));
+    ASSERT_EQ(1, (int)chunks.size());
+}
@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "../utils.h"
+#include "parser/Parser_Details.h"
 
 using namespace Swallow;
 
@@ -533,3 +534,78 @@ TEST(TestFunc, testFunc_CurriedFunc)
 }
 
 
+
+TEST(TestFunc, testFunc_SkipBodies)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const wchar_t* code = L"func foo(a : Int) -> Int {\n"
+                          L"    if a > 0 { return a }\n"
+                          L"    func bar() { let s = \"{\\(a)\" }\n"
+                          L"    return -a\n"
+                          L"}\n"
+                          L"class Foo {\n"
+                          L"    var b : Int { return 1 }\n"
+                          L"    init() { }\n"
+                          L"}\n";
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    Parser parser(&nodeFactory, &compilerResults);
+    parser.setFlags(SKIP_BODIES);
+    ProgramPtr program = parser.parse(code);
+    ASSERT_NOT_NULL(program);
+    ASSERT_EQ(2, program->numStatements());
+    FunctionDefPtr func;
+    ClassDefPtr class_;
+    ComputedPropertyPtr prop;
+    InitializerDefPtr init;
+    CodeBlockPtr body;
+
+    ASSERT_NOT_NULL(func = std::dynamic_pointer_cast<FunctionDef>(program->getStatement(0)));
+    body = func->getBody();
+    ASSERT_FALSE(body->isLoaded());
+    ASSERT_EQ(L'{', code[body->getLazyBody().begin - 1]);
+    ASSERT_EQ(L'}', code[body->getLazyBody().end]);
+    ASSERT_EQ(L'\n', code[body->getLazyBody().end + 1]);
+
+    //accessing the statements parses the body, nested functions are skipped again
+    ASSERT_EQ(3, body->numStatements());
+    ASSERT_TRUE(body->isLoaded());
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<IfStatement>(body->getStatement(0)));
+    ASSERT_NOT_NULL(func = std::dynamic_pointer_cast<FunctionDef>(body->getStatement(1)));
+    ASSERT_FALSE(func->getBody()->isLoaded());
+    ASSERT_EQ(1, func->getBody()->numStatements());
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<ReturnStatement>(body->getStatement(2)));
+
+    ASSERT_NOT_NULL(class_ = std::dynamic_pointer_cast<ClassDef>(program->getStatement(1)));
+    ASSERT_EQ(2, class_->numDeclarations());
+    ASSERT_NOT_NULL(prop = std::dynamic_pointer_cast<ComputedProperty>(class_->getDeclaration(1)));
+    ASSERT_FALSE(prop->getGetter()->isLoaded());
+    ASSERT_EQ(1, prop->getGetter()->numStatements());
+    ASSERT_NOT_NULL(init = std::dynamic_pointer_cast<InitializerDef>(class_->getDeclaration(0)));
+    ASSERT_FALSE(init->getBody()->isLoaded());
+    ASSERT_EQ(0, init->getBody()->numStatements());
+    ASSERT_EQ(0, compilerResults.numResults());
+}
+
+TEST(TestFunc, testFunc_SkipBodiesTemporaryCode)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    std::wstring* code = new std::wstring(L"func foo(a : Int) -> Int {\n"
+                                          L"    let b = a * 2\n"
+                                          L"    return b\n"
+                                          L"}\n");
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    Parser parser(&nodeFactory, &compilerResults);
+    parser.setFlags(SKIP_BODIES);
+    ProgramPtr program = parser.parse(code->c_str());
+    ASSERT_NOT_NULL(program);
+    //the skipped body doesn't refer to caller's buffer
+    delete code;
+    FunctionDefPtr func;
+    ASSERT_NOT_NULL(func = std::dynamic_pointer_cast<FunctionDef>(program->getStatement(0)));
+    ASSERT_FALSE(func->getBody()->isLoaded());
+    ASSERT_EQ(2, func->getBody()->numStatements());
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<ReturnStatement>(func->getBody()->getStatement(1)));
+    ASSERT_EQ(0, compilerResults.numResults());
+}
@@ -105,6 +105,22 @@ TEST(TestGeneric, testVar)
     ASSERT_NOT_NULL(arg = id->getGenericArgumentDef());
 }
 
+TEST(TestGeneric, testVarFunctionTypeArgument)
+{
+    PARSE_STATEMENT(L"var handlers = Dictionary<String, (Int, [Int]) -> Int?>()");
+    ValueBindingsPtr vars;
+    ValueBindingPtr var;
+    FunctionCallPtr call;
+    IdentifierPtr id;
+    GenericArgumentDefPtr arg;
+    ASSERT_NOT_NULL(vars = std::dynamic_pointer_cast<ValueBindings>(root));
+    ASSERT_NOT_NULL(var = std::dynamic_pointer_cast<ValueBinding>(vars->get(0)));
+    ASSERT_NOT_NULL(call = std::dynamic_pointer_cast<FunctionCall>(var->getInitializer()));
+    ASSERT_NOT_NULL(id = std::dynamic_pointer_cast<Identifier>(call->getFunction()));
+    ASSERT_NOT_NULL(arg = id->getGenericArgumentDef());
+    ASSERT_EQ(2, arg->numArguments());
+}
+
 TEST(TestGeneric, testTypeConstraint)
 {
     PARSE_STATEMENT(L"func someFunction<T: SomeClass, U: SomeProtocol>(someT: T, someU: U) {\n"
@@ -138,6 +138,98 @@ TEST(TestLiteralExpression, testDictionaryLiteral2)
     ASSERT_EQ(1, d->numElements());
 
 }
+TEST(TestLiteralExpression, testCompactArrayLiteral)
+{
+    PARSE_STATEMENT(L"[1, 2.5, \"a\", 4]");
+    ASSERT_NOT_NULL(root);
+    ArrayLiteralPtr a = std::dynamic_pointer_cast<ArrayLiteral>(root);
+    ASSERT_NOT_NULL(a);
+    ASSERT_TRUE(a->isCompact());
+    ASSERT_EQ(4, a->getLiterals().size());
+    ASSERT_EQ(NodeType::FloatLiteral, a->getLiterals().getType(1));
+    ASSERT_EQ(L"a", a->getLiterals().getText(2));
+    ASSERT_EQ(4, a->getLiterals().getInteger(3));
+    ASSERT_EQ(4, a->numElements());
+
+    //nodes are created on demand
+    IntegerLiteralPtr i = std::dynamic_pointer_cast<IntegerLiteral>(a->getElement(0));
+    ASSERT_NOT_NULL(i);
+    ASSERT_EQ(L"1", i->valueAsString);
+    ASSERT_EQ(1, i->getSourceInfo()->offset);
+    FloatLiteralPtr f = std::dynamic_pointer_cast<FloatLiteral>(a->getElement(1));
+    ASSERT_NOT_NULL(f);
+    ASSERT_EQ(L"2.5", f->valueAsString);
+    ASSERT_EQ(2.5, f->value);
+    StringLiteralPtr s = std::dynamic_pointer_cast<StringLiteral>(a->getElement(2));
+    ASSERT_NOT_NULL(s);
+    ASSERT_EQ(L"a", s->value);
+    ASSERT_FALSE(a->isCompact());
+    ASSERT_EQ(4, a->numElements());
+}
+TEST(TestLiteralExpression, testMixedArrayLiteral)
+{
+    PARSE_STATEMENT(L"[1, 2, a, 3 + 4, -5]");
+    ASSERT_NOT_NULL(root);
+    ArrayLiteralPtr a = std::dynamic_pointer_cast<ArrayLiteral>(root);
+    ASSERT_NOT_NULL(a);
+    ASSERT_FALSE(a->isCompact());
+    ASSERT_EQ(5, a->numElements());
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<IntegerLiteral>(a->getElement(1)));
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<Identifier>(a->getElement(2)));
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<BinaryOperator>(a->getElement(3)));
+}
+TEST(TestLiteralExpression, testCompactDictionaryLiteral)
+{
+    PARSE_STATEMENT(L"[\"a\" : 1, \"b\" : 2, \"c\" : 3 * 4]");
+    ASSERT_NOT_NULL(root);
+    DictionaryLiteralPtr d = std::dynamic_pointer_cast<DictionaryLiteral>(root);
+    ASSERT_NOT_NULL(d);
+    ASSERT_FALSE(d->isCompact());
+    ASSERT_EQ(3, d->numElements());
+    auto iter = d->begin();
+    StringLiteralPtr key = std::dynamic_pointer_cast<StringLiteral>(iter->first);
+    ASSERT_NOT_NULL(key);
+    ASSERT_EQ(L"a", key->value);
+    iter++;
+    IntegerLiteralPtr value = std::dynamic_pointer_cast<IntegerLiteral>(iter->second);
+    ASSERT_NOT_NULL(value);
+    ASSERT_EQ(2, value->value);
+    iter++;
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<BinaryOperator>(iter->second));
+}
+TEST(TestLiteralExpression, testCompactDictionaryLiteral2)
+{
+    PARSE_STATEMENT(L"[1 : 2.0, 3 : 4.0]");
+    DictionaryLiteralPtr d = std::dynamic_pointer_cast<DictionaryLiteral>(root);
+    ASSERT_NOT_NULL(d);
+    ASSERT_TRUE(d->isCompact());
+    ASSERT_EQ(2, d->numElements());
+    ASSERT_EQ(3, d->getLiteralKeys().getInteger(1));
+    ASSERT_EQ(4.0, d->getLiteralValues().getFloat(1));
+}
+TEST(TestLiteralExpression, testCompactLiteralFactory)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const wchar_t* code = L"[1, 2]";
+    ArrayLiteralPtr a;
+    {
+        NodeFactory nodeFactory;
+        CompilerResults compilerResults;
+        Parser parser(&nodeFactory, &compilerResults);
+        ASSERT_NOT_NULL(a = std::dynamic_pointer_cast<ArrayLiteral>(parser.parseStatement(code)));
+        ASSERT_TRUE(a->isCompact());
+        //materialized by the live factory like other nodes
+        ASSERT_EQ(&nodeFactory, a->getElement(0)->getNodeFactory());
+
+        ASSERT_NOT_NULL(a = std::dynamic_pointer_cast<ArrayLiteral>(parser.parseStatement(code)));
+        ASSERT_TRUE(a->isCompact());
+    }
+    //the factory is gone, nodes are created without it instead of keeping a dangling pointer
+    IntegerLiteralPtr i = std::dynamic_pointer_cast<IntegerLiteral>(a->getElement(1));
+    ASSERT_NOT_NULL(i);
+    ASSERT_EQ(2, i->value);
+    ASSERT_NULL(i->getNodeFactory());
+}
 TEST(TestLiteralExpression, testCompileConstants)
 {
     PARSE_STATEMENT(L"__FILE__");
@@ -0,0 +1,211 @@
+/* TestLookahead.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "../utils.h"
+#include "tokenizer/Tokenizer.h"
+#include "parser/ParserProfile.h"
+#include <cstring>
+
+using namespace Swallow;
+
+static int countTokens(const wchar_t* code)
+{
+    Tokenizer tokenizer(code);
+    Token token;
+    int ret = 0;
+    while(tokenizer.next(token))
+        ret++;
+    return ret;
+}
+
+static ParserStatistics parseWithStatistics(const wchar_t* code)
+{
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    Parser parser(&nodeFactory, &compilerResults);
+    parser.parse(code);
+    return parser.getStatistics();
+}
+
+TEST(TestLookahead, testNoRelex)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const wchar_t* code = L"let a = b ? foo(d, e) : bar[1] as Int\n"
+                          L"func f(x : Int, y : Int) { return x + y * 2 }\n"
+                          L"var t = (1, 2, 3)\n"
+                          L"var p : Int { get { return 1 } set { } }\n";
+    int tokens = countTokens(code);
+    ParserStatistics stats = parseWithStatistics(code);
+    //every token is lexed exactly once, peeks and backtracks are served by the lookahead buffer
+    ASSERT_EQ(tokens, stats.tokensLexed);
+    ASSERT_GT(stats.tokensRequested, stats.tokensLexed);
+    ASSERT_GE(stats.tokensRequested - stats.tokensLexed, stats.lookaheadHits);
+}
+
+TEST(TestLookahead, testContextSensitive)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const wchar_t* code = L"let a = b < c ? foo<Int>(d, e) : bar[1] as Int\n";
+    int tokens = countTokens(code);
+    ParserStatistics stats = parseWithStatistics(code);
+    //only '<' and '>' need to be lexed again in generic context
+    ASSERT_LT(tokens, stats.tokensLexed);
+    ASSERT_GE(tokens + 4, stats.tokensLexed);
+}
+
+TEST(TestLookahead, testGenericArgumentBounded)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    std::wstring code;
+    for(int i = 0; i < 200; i++)
+        code += L"let c = a < b && c < d || e < f\n";
+    ParserStatistics stats = parseWithStatistics(code.c_str());
+    //'&&' and '||' cannot appear in generic argument, scan stops right after the next identifier
+    ASSERT_EQ(200 * 3, stats.genericLookaheadTokens);
+
+    code = L"let t = [";
+    for(int i = 0; i < 200; i++)
+        code += L"a < b, ";
+    code += L"c]";
+    stats = parseWithStatistics(code.c_str());
+    ASSERT_GE(200 * 64, stats.genericLookaheadTokens);
+}
+
+TEST(TestLookahead, testComments)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const wchar_t* code = L"/* a */ let /** b */ a = 3 // c\n/// d";
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    Parser parser(&nodeFactory, &compilerResults);
+    SourceFilePtr sourceFile(new SourceFile(L"code", std::wstring(code)));
+    parser.setSourceFile(sourceFile);
+    parser.parse(code);
+    //comments are skipped by tokenizer and never lexed as tokens
+    ASSERT_EQ(4, parser.getStatistics().tokensLexed);
+    ASSERT_EQ(4, (int)sourceFile->comments.size());
+    ASSERT_EQ(0, sourceFile->comments[0].offset);
+    ASSERT_EQ(7, sourceFile->comments[0].length);
+    ASSERT_EQ(CommentTrivia::Block, sourceFile->comments[0].kind);
+    ASSERT_EQ(12, sourceFile->comments[1].offset);
+    ASSERT_EQ(8, sourceFile->comments[1].length);
+    ASSERT_EQ(CommentTrivia::DocBlock, sourceFile->comments[1].kind);
+    ASSERT_EQ(27, sourceFile->comments[2].offset);
+    ASSERT_EQ(4, sourceFile->comments[2].length);
+    ASSERT_EQ(CommentTrivia::Line, sourceFile->comments[2].kind);
+    ASSERT_EQ(32, sourceFile->comments[3].offset);
+    ASSERT_EQ(5, sourceFile->comments[3].length);
+    ASSERT_EQ(CommentTrivia::DocLine, sourceFile->comments[3].kind);
+
+    size_t count;
+    const CommentTrivia* comments = sourceFile->findComments(1, 28, count);
+    ASSERT_EQ(2, (int)count);
+    ASSERT_EQ(12, comments[0].offset);
+    ASSERT_NULL(sourceFile->findComments(40, 50, count));
+    ASSERT_EQ(0, (int)count);
+}
+
+static const ProductionCounters* findProduction(const ParserProfile& profile, const char* name)
+{
+    for(int i = 0; i < profile.numProductions(); i++)
+    {
+        if(!strcmp(ParserProfile::getProductionName(i), name))
+            return &profile.getCounters(i);
+    }
+    return NULL;
+}
+
+TEST(TestLookahead, testProfile)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const wchar_t* code = L"func f(x : Int, y : Int) -> Int { return x + y * 2 }\n"
+                          L"let a = f(1, 2) + f(3, 4)\n";
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    ParserProfile profile;
+    Parser parser(&nodeFactory, &compilerResults);
+    parser.setProfile(&profile);
+    ASSERT_NOT_NULL(parser.parse(code));
+    if(!ParserProfile::isEnabled())
+    {
+        //instrumentation is compiled out
+        ASSERT_EQ(0, profile.numProductions());
+        ASSERT_EQ(0, profile.tokens);
+        return;
+    }
+    const ProductionCounters* type = findProduction(profile, "parseType");
+    const ProductionCounters* expr = findProduction(profile, "parseExpression");
+    const ProductionCounters* func = findProduction(profile, "parseFunc");
+    ASSERT_NOT_NULL(type);
+    ASSERT_NOT_NULL(expr);
+    ASSERT_NOT_NULL(func);
+    //Int of x, y and return type
+    ASSERT_EQ(3, type->calls);
+    ASSERT_EQ(1, func->calls);
+    ASSERT_GT(func->tokens, 15);
+    ASSERT_GT(func->allocations, 5);
+    ASSERT_GE(expr->calls, 5);
+    //nested calls of the same production are not counted twice
+    ASSERT_LE(expr->tokens, profile.tokens);
+    ASSERT_EQ(0, type->depth);
+}
+
+TEST(TestLookahead, testReset)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    NodeFactory nodeFactory;
+    CompilerResults results1, results2, results3;
+    Parser parser(&nodeFactory, &results1);
+    //'<' of both inputs are at the same offset, the verdict of first input must not be reused
+    const wchar_t* code1 = L"let x = foo<Int>(1)";
+    const wchar_t* code2 = L"let x = foo < a && b";
+    const wchar_t* code3 = L"let y = (1, 2";
+
+    ProgramPtr program = nodeFactory.createProgram();
+    parser.reset(SourceFilePtr(new SourceFile(L"<1>", code1)), &results1);
+    ASSERT_TRUE(parser.parse(code1, program));
+    ASSERT_EQ(1, program->numStatements());
+    ValueBindingsPtr c;
+    ASSERT_NOT_NULL(c = std::dynamic_pointer_cast<ValueBindings>(program->getStatement(0)));
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<FunctionCall>(c->get(0)->getInitializer()));
+
+    program = nodeFactory.createProgram();
+    parser.reset(SourceFilePtr(new SourceFile(L"<2>", code2)), &results2);
+    ASSERT_TRUE(parser.parse(code2, program));
+    ASSERT_NOT_NULL(c = std::dynamic_pointer_cast<ValueBindings>(program->getStatement(0)));
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<BinaryOperator>(c->get(0)->getInitializer()));
+    ASSERT_EQ(0, results2.numResults());
+
+    program = nodeFactory.createProgram();
+    parser.reset(SourceFilePtr(new SourceFile(L"<3>", code3)), &results3);
+    ASSERT_FALSE(parser.parse(code3, program));
+    ASSERT_EQ(1, results3.numResults());
+    ASSERT_EQ(0, results1.numResults());
+    ASSERT_EQ(0, results2.numResults());
+}
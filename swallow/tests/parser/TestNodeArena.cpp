@@ -0,0 +1,123 @@
+/* TestNodeArena.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "../utils.h"
+#include "ast/NodeArena.h"
+#include <thread>
+
+using namespace Swallow;
+
+static const wchar_t* code = L"func f(x : Int, y : Int) -> Int { return x + y * 2 }\n"
+                             L"let a = [f(1, 2), f(3, 4)]\n";
+
+TEST(TestNodeArena, testOutliveFactory)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    std::weak_ptr<NodeArena> arena;
+    ProgramPtr program;
+    {
+        NodeFactory nodeFactory;
+        CompilerResults compilerResults;
+        arena = nodeFactory.getArena();
+        Parser parser(&nodeFactory, &compilerResults);
+        program = parser.parse(code);
+        ASSERT_NOT_NULL(program);
+        ASSERT_LE(1, (int)nodeFactory.getArena()->numSlabs());
+    }
+    //nodes keep the arena alive after the factory is gone
+    ASSERT_FALSE(arena.expired());
+    ASSERT_EQ(2, program->numStatements());
+    FunctionDefPtr func;
+    ASSERT_NOT_NULL(func = std::dynamic_pointer_cast<FunctionDef>(program->getStatement(0)));
+    ASSERT_EQ(L"f", func->getName());
+    func = nullptr;
+    program = nullptr;
+    ASSERT_TRUE(arena.expired());
+}
+
+TEST(TestNodeArena, testResetArena)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    Parser parser(&nodeFactory, &compilerResults);
+    ProgramPtr first = parser.parse(code);
+    ASSERT_NOT_NULL(first);
+    std::weak_ptr<NodeArena> arena = nodeFactory.getArena();
+
+    nodeFactory.resetArena();
+    ASSERT_TRUE(nodeFactory.getArena() != arena.lock());
+    ProgramPtr second = parser.parse(code);
+    ASSERT_NOT_NULL(second);
+    //slabs of the first parse are freed once its nodes are released
+    ASSERT_FALSE(arena.expired());
+    first = nullptr;
+    ASSERT_TRUE(arena.expired());
+    ASSERT_EQ(2, second->numStatements());
+}
+
+TEST(TestNodeArena, testHeap)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    nodeFactory.setArena(nullptr);
+    Parser parser(&nodeFactory, &compilerResults);
+    ProgramPtr program = parser.parse(code);
+    ASSERT_NOT_NULL(program);
+    ASSERT_EQ(2, program->numStatements());
+}
+
+TEST(TestNodeArena, testThreads)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    NodeFactory nodeFactory;
+    const int threads = 4;
+    std::vector<ProgramPtr> programs(threads);
+    std::vector<std::thread> workers;
+    //worker threads allocate from their own slabs of the shared arena
+    for(int i = 0; i < threads; i++)
+    {
+        workers.push_back(std::thread([&, i]()
+        {
+            CompilerResults compilerResults;
+            Parser parser(&nodeFactory, &compilerResults);
+            for(int n = 0; n < 100; n++)
+                programs[i] = parser.parse(code);
+        }));
+    }
+    for(std::thread& worker : workers)
+        worker.join();
+    for(const ProgramPtr& program : programs)
+    {
+        ASSERT_NOT_NULL(program);
+        ASSERT_EQ(2, program->numStatements());
+    }
+    ASSERT_LE(threads, (int)nodeFactory.getArena()->numSlabs());
+}
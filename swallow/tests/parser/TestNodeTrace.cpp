@@ -0,0 +1,85 @@
+/* TestNodeTrace.cpp --
+ *
+ * Copyright (c) 2014, Lex Chou <lex at chou dot it>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of Swallow nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "../utils.h"
+#include <chrono>
+#include <algorithm>
+
+using namespace Swallow;
+
+/*!
+ * Create given number of nodes and release them in reverse order, return the time of releasing in ms
+ */
+static double releaseNodes(NodeFactory& nodeFactory, int count)
+{
+    std::vector<NodePtr> nodes;
+    for(int i = 0; i < count; i++)
+        nodes.push_back(nodeFactory.createInteger(SourceInfo()));
+    std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+    while(!nodes.empty())
+        nodes.pop_back();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - begin;
+    return elapsed.count();
+}
+
+TEST(TestNodeTrace, testUnreleasedNodes)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    NodeFactory nodeFactory;
+    NodePtr a = nodeFactory.createInteger(SourceInfo());
+    NodePtr b = nodeFactory.createString(SourceInfo());
+    NodePtr c = nodeFactory.createIdentifier(SourceInfo());
+#ifdef TRACE_NODE
+    ASSERT_EQ(3, Node::getNodeCount());
+    b = nullptr;
+    std::vector<Node*> nodes = Node::getUnreleasedNodes();
+    ASSERT_EQ(2, (int)nodes.size());
+    ASSERT_EQ(a.get(), nodes[0]);
+    ASSERT_EQ(c.get(), nodes[1]);
+    //nodes created before reset are released silently
+    Node::resetTrace();
+    NodePtr d = nodeFactory.createInteger(SourceInfo());
+    a = c = nullptr;
+    ASSERT_EQ(1, Node::getNodeCount());
+    ASSERT_EQ(d.get(), Node::getUnreleasedNodes()[0]);
+#endif
+}
+
+TEST(TestNodeTrace, testLinearTeardown)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    NodeFactory nodeFactory;
+    const int count = 20000;
+    //warm up the allocator
+    releaseNodes(nodeFactory, count * 4);
+    double small = releaseNodes(nodeFactory, count);
+    double large = releaseNodes(nodeFactory, count * 4);
+    //quadratic teardown would take 16 times longer, leave some room for timer noise
+    ASSERT_LT(large, std::max(small, 1.0) * 8);
+}
@@ -138,6 +138,85 @@ TEST(TestOperatorExpression, testExpr1)
     */
 
 }
+TEST(TestOperatorExpression, testSortedExpression)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    SymbolRegistry registry;
+    Parser parser(&nodeFactory, &compilerResults);
+    parser.setSymbolRegistry(&registry);
+    ProgramPtr program = parser.parse(L"a=4+1*(3+1*4)\n"
+                                      L"a - b - c\n"
+                                      L"a = b += c\n"
+                                      L"infix operator ** { associativity right precedence 160 }\n"
+                                      L"a * b ** c ** d\n"
+                                      L"a + b <~> c * d\n"
+                                      L"a = b as Int");
+    dumpCompilerResults(compilerResults);
+    ASSERT_NOT_NULL(program);
+    ASSERT_EQ(7, program->numStatements());
+
+    //a = (4 + (1 * (3 + (1 * 4))))
+    AssignmentPtr eq;
+    BinaryOperatorPtr add, mul;
+    IdentifierPtr id;
+    ParenthesizedExpressionPtr p;
+    ASSERT_NOT_NULL(eq = std::dynamic_pointer_cast<Assignment>(program->getStatement(0)));
+    ASSERT_TRUE(eq->isSorted());
+    ASSERT_NOT_NULL(id = std::dynamic_pointer_cast<Identifier>(eq->getLHS()));
+    ASSERT_EQ(L"a", id->getIdentifier());
+    ASSERT_NOT_NULL(add = std::dynamic_pointer_cast<BinaryOperator>(eq->getRHS()));
+    ASSERT_EQ(L"+", add->getOperator());
+    ASSERT_NOT_NULL(mul = std::dynamic_pointer_cast<BinaryOperator>(add->getRHS()));
+    ASSERT_EQ(L"*", mul->getOperator());
+    ASSERT_NOT_NULL(p = std::dynamic_pointer_cast<ParenthesizedExpression>(mul->getRHS()));
+    ASSERT_EQ(1, p->numExpressions());
+    ASSERT_NOT_NULL(add = std::dynamic_pointer_cast<BinaryOperator>(p->get(0)));
+    ASSERT_EQ(L"+", add->getOperator());
+    ASSERT_NOT_NULL(mul = std::dynamic_pointer_cast<BinaryOperator>(add->getRHS()));
+    ASSERT_EQ(L"*", mul->getOperator());
+
+    //(a - b) - c
+    BinaryOperatorPtr sub;
+    ASSERT_NOT_NULL(sub = std::dynamic_pointer_cast<BinaryOperator>(program->getStatement(1)));
+    ASSERT_EQ(L"-", sub->getOperator());
+    ASSERT_NOT_NULL(id = std::dynamic_pointer_cast<Identifier>(sub->getRHS()));
+    ASSERT_EQ(L"c", id->getIdentifier());
+    ASSERT_NOT_NULL(sub = std::dynamic_pointer_cast<BinaryOperator>(sub->getLHS()));
+    ASSERT_EQ(L"-", sub->getOperator());
+
+    //a = (b += c)
+    ASSERT_NOT_NULL(eq = std::dynamic_pointer_cast<Assignment>(program->getStatement(2)));
+    ASSERT_NOT_NULL(add = std::dynamic_pointer_cast<BinaryOperator>(eq->getRHS()));
+    ASSERT_EQ(L"+=", add->getOperator());
+
+    //a * (b ** (c ** d)), the operator is declared in the same file
+    BinaryOperatorPtr pow;
+    ASSERT_NOT_NULL(mul = std::dynamic_pointer_cast<BinaryOperator>(program->getStatement(4)));
+    ASSERT_EQ(L"*", mul->getOperator());
+    ASSERT_NOT_NULL(pow = std::dynamic_pointer_cast<BinaryOperator>(mul->getRHS()));
+    ASSERT_EQ(L"**", pow->getOperator());
+    ASSERT_NOT_NULL(pow = std::dynamic_pointer_cast<BinaryOperator>(pow->getRHS()));
+    ASSERT_EQ(L"**", pow->getOperator());
+
+    //((a + b) <~> c) * d, unknown operator leaves the rest unsorted
+    BinaryOperatorPtr op;
+    ASSERT_NOT_NULL(mul = std::dynamic_pointer_cast<BinaryOperator>(program->getStatement(5)));
+    ASSERT_EQ(L"*", mul->getOperator());
+    ASSERT_FALSE(mul->isSorted());
+    ASSERT_NOT_NULL(op = std::dynamic_pointer_cast<BinaryOperator>(mul->getLHS()));
+    ASSERT_EQ(L"<~>", op->getOperator());
+    ASSERT_NOT_NULL(add = std::dynamic_pointer_cast<BinaryOperator>(op->getLHS()));
+    ASSERT_EQ(L"+", add->getOperator());
+
+    //a = (b as Int)
+    TypeCastPtr as;
+    ASSERT_NOT_NULL(eq = std::dynamic_pointer_cast<Assignment>(program->getStatement(6)));
+    ASSERT_NOT_NULL(as = std::dynamic_pointer_cast<TypeCast>(eq->getRHS()));
+    ASSERT_NOT_NULL(id = std::dynamic_pointer_cast<Identifier>(as->getLHS()));
+    ASSERT_EQ(L"b", id->getIdentifier());
+}
 TEST(TestOperatorExpression, testMinus)
 {
     PARSE_STATEMENT(L"-y");
@@ -28,6 +28,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "../utils.h"
+#include "parser/Parser_Details.h"
 
 using namespace Swallow;
     
@@ -661,3 +662,55 @@ TEST(TestStatement, testLabeledFor)
 
 
 }
+TEST(TestStatement, testRecoverErrors)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const wchar_t* code = L"let a = (1 + \n"
+                          L"func foo() {\n"
+                          L"    let b = 1 +\n"
+                          L"    return 1\n"
+                          L"}\n"
+                          L"class Bar {\n"
+                          L"    var c : = 3\n"
+                          L"    var d = 4\n"
+                          L"}\n"
+                          L"var e = 5\n";
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    Parser parser(&nodeFactory, &compilerResults);
+    parser.setFlags(RECOVER_ERRORS);
+    ProgramPtr program = nodeFactory.createProgram();
+    ASSERT_FALSE(parser.parse(code, program));
+    ASSERT_EQ(3, compilerResults.numResults());
+    ASSERT_EQ(3, parser.getStatistics().errorsRecovered);
+
+    ErrorStatementPtr err;
+    FunctionDefPtr func;
+    ClassDefPtr class_;
+    ASSERT_EQ(4, program->numStatements());
+    //the unbalanced parenthesis swallows the rest of the line only
+    ASSERT_NOT_NULL(err = std::dynamic_pointer_cast<ErrorStatement>(program->getStatement(0)));
+    ASSERT_EQ(0, err->getSourceInfo()->offset);
+    ASSERT_EQ(12, err->getEndOffset());
+
+    ASSERT_NOT_NULL(func = std::dynamic_pointer_cast<FunctionDef>(program->getStatement(1)));
+    ASSERT_EQ(2, func->getBody()->numStatements());
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<ErrorStatement>(func->getBody()->getStatement(0)));
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<ReturnStatement>(func->getBody()->getStatement(1)));
+
+    //broken declaration is dropped from the type body
+    ASSERT_NOT_NULL(class_ = std::dynamic_pointer_cast<ClassDef>(program->getStatement(2)));
+    ASSERT_EQ(1, class_->numDeclarations());
+    ASSERT_NOT_NULL(std::dynamic_pointer_cast<ValueBindings>(program->getStatement(3)));
+}
+TEST(TestStatement, testRecoverErrorsDisabled)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    NodeFactory nodeFactory;
+    CompilerResults compilerResults;
+    Parser parser(&nodeFactory, &compilerResults);
+    ProgramPtr program = nodeFactory.createProgram();
+    ASSERT_FALSE(parser.parse(L"let a = (1 + \nvar e = 5\nlet f = ]\n", program));
+    ASSERT_EQ(1, compilerResults.numResults());
+    ASSERT_EQ(0, parser.getStatistics().errorsRecovered);
+}
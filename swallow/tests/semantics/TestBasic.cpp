@@ -50,6 +50,100 @@ TEST(TestBasic, UseModule)
     Swallow::CompilerResults& compilerResults = *compiler.getCompilerResults();
     ASSERT_ERROR(Errors::E_EXPECT_MODULE_MEMBER_NAME_AFTER_MODULE_NAME);
 }
+TEST(TestBasic, SourcePath)
+{
+    SwallowCompiler compiler(L"test");
+    initTestMethods(compiler);
+    compiler.addSourcePath("semantics/TestOptional_OptionalChaining_Property.swift");
+    std::vector<ProgramPtr> programs;
+    ASSERT_TRUE(compiler.compile(programs));
+    ASSERT_EQ(1, (int)programs.size());
+    ASSERT_LT(0, programs[0]->numStatements());
+    ASSERT_NO_COMPILER_ERRORS(*compiler.getCompilerResults());
+}
+TEST(TestBasic, SourcePathNotFound)
+{
+    SwallowCompiler compiler(L"test");
+    compiler.addSourcePath("semantics/NotExists.swift");
+    ASSERT_FALSE(compiler.compile());
+    const CompilerResult* error = nullptr;
+    Swallow::CompilerResults& compilerResults = *compiler.getCompilerResults();
+    ASSERT_ERROR(Errors::E_CANNOT_OPEN_SOURCE_FILE_1);
+    ASSERT_EQ(L"semantics/NotExists.swift", error->items[0]);
+}
+TEST(TestBasic, MultipleFiles)
+{
+    SwallowCompiler compiler(L"test");
+    initTestMethods(compiler);
+    compiler.setParsingThreads(4);
+    compiler.addSource(L"a", L"func foo() -> Int { return 1 }");
+    compiler.addSource(L"b", L"struct Bar { var a = foo() }");
+    compiler.addSource(L"c", L"println(Bar().a + foo())");
+    std::vector<ProgramPtr> programs;
+    ASSERT_TRUE(compiler.compile(programs));
+    ASSERT_EQ(3, (int)programs.size());
+    for(const ProgramPtr& program : programs)
+        ASSERT_EQ(1, program->numStatements());
+    ASSERT_NO_COMPILER_ERRORS(*compiler.getCompilerResults());
+}
+TEST(TestBasic, ParallelParsingErrors)
+{
+    //results of files parsed in parallel are in the same order as sequential parsing
+    std::vector<CompilerResult> results[2];
+    for(int i = 0; i < 2; i++)
+    {
+        SwallowCompiler compiler(L"test");
+        compiler.setParsingThreads(i == 0 ? 1 : 3);
+        for(int f = 0; f < 8; f++)
+        {
+            std::wstring name = L"file" + std::to_wstring(f);
+            compiler.addSource(name, f % 3 ? L"let a = (\nlet b = 1\n" : L"let a = 1\n");
+        }
+        ASSERT_FALSE(compiler.compile());
+        CompilerResults& compilerResults = *compiler.getCompilerResults();
+        results[i].assign(compilerResults.begin(), compilerResults.end());
+        ASSERT_EQ(1, compiler.getRecoveredStatements(compilerResults.getResult(0).sourceFile));
+    }
+    ASSERT_EQ(5, (int)results[0].size());
+    ASSERT_EQ(results[0].size(), results[1].size());
+    for(size_t i = 0; i < results[0].size(); i++)
+    {
+        ASSERT_EQ(results[0][i].sourceFile->fileName, results[1][i].sourceFile->fileName);
+        ASSERT_EQ(results[0][i].offset, results[1][i].offset);
+        ASSERT_EQ(results[0][i].code, results[1][i].code);
+    }
+    ASSERT_EQ(L"file1", results[1][0].sourceFile->fileName);
+    ASSERT_EQ(L"file7", results[1][4].sourceFile->fileName);
+}
+TEST(TestBasic, SplitLargeFile)
+{
+    SwallowCompiler compiler(L"test");
+    initTestMethods(compiler);
+    compiler.setParsingThreads(3);
+    compiler.setSplitSize(16);
+    std::wstring code;
+    for(int i = 0; i < 8; i++)
+    {
+        std::wstring n = std::to_wstring(i);
+        code += L"//type " + n + L"\n";
+        code += L"struct S" + n + L" { var a = " + n + L" }\n";
+        code += L"func foo" + n + L"() -> Int { return S" + n + L"().a }\n";
+    }
+    code += L"println(foo7())\n";
+    SourceFilePtr source(new SourceFile(L"code", code));
+    compiler.addSourceFile(source);
+    std::vector<ProgramPtr> programs;
+    ASSERT_TRUE(compiler.compile(programs));
+    ASSERT_EQ(1, (int)programs.size());
+    ASSERT_EQ(17, programs[0]->numStatements());
+    for(int i = 0; i < 8; i++)
+    {
+        ASSERT_NOT_NULL(std::dynamic_pointer_cast<StructDef>(programs[0]->getStatement(i * 2)));
+        ASSERT_NOT_NULL(std::dynamic_pointer_cast<FunctionDef>(programs[0]->getStatement(i * 2 + 1)));
+    }
+    ASSERT_EQ(8, (int)source->comments.size());
+    ASSERT_NO_COMPILER_ERRORS(*compiler.getCompilerResults());
+}
 TEST(TestBasic, VariableUseBeforeInitialized)
 {
     SEMANTIC_ANALYZE(L"var a : String\n"
@@ -134,6 +134,23 @@ TEST(TestCollection, ValidArray4)
 }
 
 
+TEST(TestCollection, CompactArray)
+{
+    SEMANTIC_ANALYZE(L"var a = [1, 2.5, 3]");
+    ASSERT_EQ(0, compilerResults.numResults());
+    SymbolPtr a;
+    ASSERT_NOT_NULL(a = scope->lookup(L"a"));
+    ASSERT_EQ(L"Array<Double>", a->getType()->toString());
+    ValueBindingsPtr bindings = dynamic_pointer_cast<ValueBindings>(root->getStatement(0));
+    ASSERT_NOT_NULL(bindings);
+    ArrayLiteralPtr array = dynamic_pointer_cast<ArrayLiteral>(bindings->get(0)->getInitializer());
+    ASSERT_NOT_NULL(array);
+    //typed without creating element nodes, they get the element type when created
+    ASSERT_TRUE(array->isCompact());
+    ASSERT_EQ(L"Double", array->getElement(0)->getType()->toString());
+    ASSERT_FALSE(array->isCompact());
+}
+
 TEST(TestCollection, InitArray)
 {
     SEMANTIC_ANALYZE(L"var someInts = [Int]()\n"
@@ -193,6 +210,27 @@ TEST(TestCollection, DictionaryLiteral4)
 }
 
 
+TEST(TestCollection, CompactDictionary)
+{
+    SEMANTIC_ANALYZE(L"var a = [1 : \"a\", 2 : \"b\"]\n"
+                     L"var b : [Int : String?] = [1 : \"a\"]");
+    ASSERT_EQ(0, compilerResults.numResults());
+    SymbolPtr a, b;
+    ASSERT_NOT_NULL(a = scope->lookup(L"a"));
+    ASSERT_EQ(L"Dictionary<Int, String>", a->getType()->toString());
+    ValueBindingsPtr bindings = dynamic_pointer_cast<ValueBindings>(root->getStatement(0));
+    ASSERT_NOT_NULL(bindings);
+    DictionaryLiteralPtr dict = dynamic_pointer_cast<DictionaryLiteral>(bindings->get(0)->getInitializer());
+    ASSERT_NOT_NULL(dict);
+    ASSERT_TRUE(dict->isCompact());
+
+    //optional values are wrapped, so the nodes are created
+    ASSERT_NOT_NULL(b = scope->lookup(L"b"));
+    ASSERT_NOT_NULL(bindings = dynamic_pointer_cast<ValueBindings>(root->getStatement(1)));
+    ASSERT_NOT_NULL(dict = dynamic_pointer_cast<DictionaryLiteral>(bindings->get(0)->getInitializer()));
+    ASSERT_FALSE(dict->isCompact());
+}
+
 TEST(TestCollection, InvalidDictionary)
 {
     SEMANTIC_ANALYZE(L"var a = [:]");
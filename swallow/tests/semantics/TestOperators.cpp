@@ -35,6 +35,9 @@
 #include "common/Errors.h"
 #include "semantics/GlobalScope.h"
 #include "semantics/GenericArgument.h"
+#include "semantics/OperatorResolver.h"
+#include <pthread.h>
+#include <cstring>
 
 using namespace Swallow;
 using namespace std;
@@ -353,3 +356,115 @@ TEST(TestOperators, Precedence2)
     ASSERT_NOT_NULL(op);
     ASSERT_EQ(L"+", op->getOperator());
 }
+
+/*!
+ * Release an expression tree without recursion, the operands are released in source order
+ */
+static void releaseExpression(PatternPtr node)
+{
+    vector<PatternPtr> nodes;
+    vector<BinaryOperatorPtr> stack;
+    while(true)
+    {
+        for(BinaryOperatorPtr op; (op = dynamic_pointer_cast<BinaryOperator>(node)) != nullptr; node = op->getLHS())
+            stack.push_back(op);
+        nodes.push_back(node);
+        if(stack.empty())
+            break;
+        BinaryOperatorPtr op = stack.back();
+        stack.pop_back();
+        nodes.push_back(op);
+        node = op->getRHS();
+        op->setLHS(nullptr);
+        op->setRHS(nullptr);
+    }
+}
+
+/*!
+ * Release the expression without recursion when the test exits, failed assertions included
+ */
+struct ScopedExpressionRelease
+{
+    OperatorPtr& expression;
+    ~ScopedExpressionRelease()
+    {
+        releaseExpression(expression);
+        expression = nullptr;
+    }
+};
+
+struct SortJob
+{
+    OperatorResolver* resolver;
+    OperatorPtr expression;
+};
+static void* sortExpression(void* p)
+{
+    SortJob* job = static_cast<SortJob*>(p);
+    job->expression = job->resolver->sortExpression(job->expression);
+    return NULL;
+}
+
+TEST(TestOperators, SortLongExpression)
+{
+    Tracer tracer(__FILE__, __LINE__, __FUNCTION__);
+    const int terms = 100000;
+    wstring code = L"a";
+    for(int i = 1; i < terms; i++)
+    {
+        code += (i % 2) ? L" + a" : L" * a";
+    }
+    CompilerResults compilerResults;
+    //parsed without symbol registry, it's a left-leaning chain
+    OperatorPtr expression = dynamic_pointer_cast<Operator>(parseStatement(compilerResults, __FUNCTION__, code.c_str()));
+    ASSERT_NOT_NULL(expression);
+    SymbolRegistry registry;
+    OperatorResolver resolver(&registry, &compilerResults);
+    SortJob job = {&resolver, expression};
+    expression = nullptr;
+    ScopedExpressionRelease release = {job.expression};
+    (void)release;
+
+    //sort it in a thread with a painted stack to measure the peak stack usage
+    const size_t stackSize = 1024 * 1024;
+    void* stack = NULL;
+    ASSERT_EQ(0, posix_memalign(&stack, 4096, stackSize));
+    memset(stack, 0xcd, stackSize);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, stackSize);
+    pthread_t thread;
+    int created = pthread_create(&thread, &attr, sortExpression, &job);
+    if(created == 0)
+        pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+    size_t unused = 0;
+    for(; unused < stackSize && static_cast<unsigned char*>(stack)[unused] == 0xcd; unused++);
+    free(stack);
+    ASSERT_EQ(0, created);
+    size_t peakStack = stackSize - unused;
+    ASSERT_LT(peakStack, 64 * 1024u);
+
+    //(((a + (a * a)) + (a * a)) + ... ) + a
+    int additions = 0;
+    PatternPtr node = job.expression;
+    BinaryOperatorPtr op, mul;
+    while((op = dynamic_pointer_cast<BinaryOperator>(node)) != nullptr)
+    {
+        ASSERT_EQ(L"+", op->getOperator());
+        if(additions++ > 0)
+        {
+            ASSERT_NOT_NULL(mul = dynamic_pointer_cast<BinaryOperator>(op->getRHS()));
+            ASSERT_EQ(L"*", mul->getOperator());
+            ASSERT_NOT_NULL(dynamic_pointer_cast<Identifier>(mul->getLHS()));
+            ASSERT_NOT_NULL(dynamic_pointer_cast<Identifier>(mul->getRHS()));
+        }
+        else
+        {
+            ASSERT_NOT_NULL(dynamic_pointer_cast<Identifier>(op->getRHS()));
+        }
+        node = op->getLHS();
+    }
+    ASSERT_NOT_NULL(dynamic_pointer_cast<Identifier>(node));
+    ASSERT_EQ(terms / 2, additions);
+}
@@ -29,6 +29,10 @@
  */
 #include "tokenizer/Token.h"
 #include "tokenizer/Tokenizer.h"
+#include "tokenizer/StreamTokenizer.h"
+#include "common/SourceManager.h"
+#include "common/StringPool.h"
+#include "tokenizer/token_char_types.h"
 #include "../utils.h"
 using namespace Swallow;
 
@@ -65,6 +69,425 @@ TEST(TestTokenizer, testExpression)
     ASSERT_TRUE(!tokenizer.next(token));
 }
 
+TEST(TestTokenizer, testView)
+{
+    //only the first 7 characters are visible to tokenizer
+    const wchar_t code[] = L"foo(a)bar";
+    Tokenizer tokenizer(NULL);
+    tokenizer.setView(code, 7);
+    Token token;
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"foo", token.token);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::OpenParen, token.type);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"a", token.token);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::CloseParen, token.type);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"b", token.token);
+
+    ASSERT_TRUE(!tokenizer.next(token));
+}
+
+TEST(TestTokenizer, testKeywordTable)
+{
+    Tokenizer tokenizer(NULL);
+    for(int k = Keyword::_ + 1; k <= Keyword::Module; k++)
+    {
+        const std::wstring& name = tokenizer.getKeyword((Keyword::T)k);
+        if(name.empty())
+            continue;
+        const KeywordInfo* info = Tokenizer::findKeyword(name.c_str(), name.size());
+        ASSERT_NOT_NULL(info);
+        ASSERT_EQ(k, info->keyword);
+    }
+    ASSERT_NULL(Tokenizer::findKeyword(L"classes", 7));
+    ASSERT_NULL(Tokenizer::findKeyword(L"clas", 4));
+    ASSERT_NULL(Tokenizer::findKeyword(L"x", 1));
+    ASSERT_NOT_NULL(Tokenizer::findKeyword(L"sil_witness_table", 17));
+}
+
+TEST(TestTokenizer, testTokenText)
+{
+    Tokenizer tokenizer(L"foo + bar\n+ `foo`");
+    Token foo, plus, bar, plus2, foo2, eof;
+    ASSERT_TRUE(tokenizer.next(foo));
+    ASSERT_TRUE(tokenizer.next(plus));
+    ASSERT_TRUE(tokenizer.next(bar));
+    ASSERT_TRUE(tokenizer.next(plus2));
+    ASSERT_TRUE(tokenizer.next(foo2));
+    ASSERT_TRUE(!tokenizer.next(eof));
+
+    ASSERT_EQ(L"`foo`", std::wstring(foo2.text, foo2.length));
+    ASSERT_EQ(L"bar", std::wstring(bar.text, bar.length));
+    ASSERT_EQ(12, foo2.state.offset);
+}
+
+TEST(TestTokenizer, testCommentPosition)
+{
+    Tokenizer tokenizer(L"a /* b\n /* c */\n*/  \t d // e\n    f");
+    Token token;
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"a", token.token);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::Comment, token.type);
+    ASSERT_EQ(L" b\n /* c */\n", token.token);
+    ASSERT_EQ(1, token.comment.nestedLevels);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"d", token.token);
+    int line, column;
+    tokenizer.getPosition(token.state.offset, line, column);
+    ASSERT_EQ(3, line);
+    ASSERT_EQ(7, column);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::Comment, token.type);
+    ASSERT_EQ(L" e", token.token);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"f", token.token);
+    tokenizer.getPosition(token.state.offset, line, column);
+    ASSERT_EQ(4, line);
+    ASSERT_EQ(5, column);
+
+    ASSERT_TRUE(!tokenizer.next(token));
+}
+
+TEST(TestTokenizer, testSourcePosition)
+{
+    SourceFilePtr file(new SourceFile(L"test", L"ab\n\ncd\ne"));
+    SourceManager manager;
+    SourceInfo info;
+    info.fileId = manager.addFile(file);
+    int line, column;
+    info.offset = 0;
+    ASSERT_TRUE(manager.getPosition(info, line, column));
+    ASSERT_EQ(1, line);
+    ASSERT_EQ(1, column);
+    info.offset = 2;
+    ASSERT_TRUE(manager.getPosition(info, line, column));
+    ASSERT_EQ(1, line);
+    ASSERT_EQ(3, column);
+    info.offset = 3;
+    ASSERT_TRUE(manager.getPosition(info, line, column));
+    ASSERT_EQ(2, line);
+    ASSERT_EQ(1, column);
+    info.offset = 5;
+    ASSERT_TRUE(manager.getPosition(info, line, column));
+    ASSERT_EQ(3, line);
+    ASSERT_EQ(2, column);
+    info.offset = 7;
+    ASSERT_TRUE(manager.getPosition(info, line, column));
+    ASSERT_EQ(4, line);
+    ASSERT_EQ(1, column);
+}
+
+TEST(TestTokenizer, testUtf8)
+{
+    //let café = π ≠ 1 // 注释
+    const char code[] = "let caf\xC3\xA9 = \xCF\x80 \xE2\x89\xA0 1 // \xE6\xB3\xA8\xE9\x87\x8A\n\"\xF0\x9F\x98\x80\"";
+    Tokenizer tokenizer(NULL);
+    tokenizer.setUtf8View(code, sizeof(code) - 1);
+    Token token;
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(Keyword::Let, token.identifier.keyword);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::Identifier, token.type);
+    ASSERT_EQ(L"caf\u00e9", token.token);
+    ASSERT_EQ(4, token.state.offset);
+    ASSERT_TRUE(token.text == NULL);
+    ASSERT_EQ(std::string("caf\xC3\xA9"), std::string(token.utf8, token.length));
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"=", token.token);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::Identifier, token.type);
+    ASSERT_EQ(L"\u03c0", token.token);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::Operator, token.type);
+    ASSERT_EQ(OperatorType::InfixBinary, token.operators.type);
+    ASSERT_EQ(L"\u2260", token.token);
+    ASSERT_EQ(3u, token.length);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::Integer, token.type);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::Comment, token.type);
+    ASSERT_EQ(L" \u6ce8\u91ca", token.token);
+
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::String, token.type);
+    ASSERT_EQ(std::wstring(1, (wchar_t)0x1F600), token.token);
+    int line, column;
+    tokenizer.getPosition(token.state.offset, line, column);
+    ASSERT_EQ(2, line);
+    ASSERT_EQ(1, column);
+
+    ASSERT_TRUE(!tokenizer.next(token));
+
+    //columns count characters instead of bytes
+    SourceFilePtr file(new SourceFile(L"test", std::string(code, sizeof(code) - 1)));
+    SourceManager manager;
+    SourceInfo info;
+    info.fileId = manager.addFile(file);
+    info.offset = 15;//the ≠
+    ASSERT_TRUE(manager.getPosition(info, line, column));
+    ASSERT_EQ(1, line);
+    ASSERT_EQ(14, column);
+    ASSERT_EQ(L'\u2260', file->getCode()[13]);
+}
+
+TEST(TestTokenizer, testSourceManager)
+{
+    SourceManager manager;
+    SourceInfo info;
+    int line, column;
+    {
+        SourceFilePtr file(new SourceFile(L"test", L"a\nb"));
+        int id = manager.addFile(file);
+        ASSERT_NE(0, id);
+        ASSERT_EQ(id, file->id);
+        ASSERT_EQ(id, manager.addFile(file));
+        ASSERT_EQ(1, manager.numFiles());
+        Tokenizer tokenizer(file->code.c_str());
+        tokenizer.setSourceFile(file);
+        Token token;
+        ASSERT_TRUE(tokenizer.next(token));
+        ASSERT_TRUE(tokenizer.next(token));
+        ASSERT_EQ(id, token.state.fileId);
+        info = token.state;
+    }
+    //the manager owns its files, positions are still resolved after the file is released outside
+    SourceFilePtr file = manager.getFile(info.fileId);
+    ASSERT_NOT_NULL(file);
+    ASSERT_EQ(L"test", file->fileName);
+    ASSERT_TRUE(manager.getPosition(info, line, column));
+    ASSERT_EQ(2, line);
+    ASSERT_EQ(1, column);
+    ASSERT_NULL(manager.getFile(0));
+
+    //ids are unique in the process, another manager doesn't resolve this file
+    SourceManager other;
+    SourceFilePtr file2(new SourceFile(L"test2", L"c"));
+    int id2 = other.addFile(file2);
+    ASSERT_NE(info.fileId, id2);
+    ASSERT_NULL(other.getFile(info.fileId));
+    ASSERT_FALSE(other.getPosition(info, line, column));
+    ASSERT_NULL(manager.getFile(id2));
+}
+
+TEST(TestTokenizer, testUnicodeIdentifier)
+{
+    ASSERT_TRUE(isIdentifierHead(0x00E9));
+    ASSERT_TRUE(isIdentifierHead(0x6C49));
+    ASSERT_TRUE(isIdentifierHead(0x1F600));
+    ASSERT_TRUE(isIdentifierHead(0xE0001));
+    ASSERT_FALSE(isIdentifierHead(0x0301));
+    ASSERT_TRUE(isIdentifierCharacter(0x0301));
+    ASSERT_FALSE(isIdentifierHead(0x2260));
+    ASSERT_TRUE(isOperatorHead(0x2260));
+    ASSERT_TRUE(isOperatorCharacter(0xE0100));
+    ASSERT_FALSE(isIdentifierCharacter(0xF0000));
+
+    //identifiers with combining marks and characters beyond BMP
+    const char code[] = "e\xCC\x81 \xF0\x9D\x91\xA5+1";
+    Tokenizer tokenizer(NULL);
+    tokenizer.setUtf8View(code, sizeof(code) - 1);
+    Token token;
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"e\u0301", token.token);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(std::wstring(1, (wchar_t)0x1D465), token.token);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(OperatorType::InfixBinary, token.operators.type);
+    ASSERT_EQ(L"+", token.token);
+}
+
+TEST(TestTokenizer, testStringPool)
+{
+    StringPoolPtr pool(new StringPool());
+    ASSERT_EQ(0, pool->find(L""));
+    int a = pool->intern(L"a");
+    int b = pool->intern(L"b");
+    ASSERT_NE(a, b);
+    ASSERT_EQ(a, pool->intern(L"a"));
+    ASSERT_EQ(b, pool->find(L"b"));
+    ASSERT_EQ(-1, pool->find(L"c"));
+    ASSERT_EQ(L"a", pool->get(a));
+    //ids and strings stay the same while the table grows
+    const std::wstring* text = &pool->get(b);
+    for(int i = 0; i < 1000; i++)
+        pool->intern(std::to_wstring(i));
+    ASSERT_EQ(1003, pool->size());
+    ASSERT_EQ(b, pool->find(L"b"));
+    ASSERT_EQ(text, &pool->get(b));
+
+    //fronts merge their strings into the shared pool and get the same ids
+    StringPool front1(pool);
+    StringPool front2(pool);
+    ASSERT_EQ(a, front1.intern(L"a"));
+    int d = front1.intern(L"d");
+    ASSERT_EQ(d, pool->find(L"d"));
+    ASSERT_EQ(d, front2.find(L"d"));
+    ASSERT_EQ(d, front2.intern(L"d"));
+    ASSERT_EQ(L"d", front2.get(d));
+}
+
+TEST(TestTokenizer, testInternedTokens)
+{
+    StringPoolPtr pool(new StringPool());
+    Token token;
+    Tokenizer tokenizer(L"a + b + a $0 $0");
+    tokenizer.setStringPool(pool.get());
+    ASSERT_TRUE(tokenizer.next(token));
+    int a = token.symbol;
+    ASSERT_EQ(a, pool->find(L"a"));
+    ASSERT_TRUE(tokenizer.next(token));
+    int plus = token.symbol;
+    ASSERT_EQ(plus, pool->find(L"+"));
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(pool->find(L"b"), token.symbol);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(plus, token.symbol);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(a, token.symbol);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"$0", token.token);
+    int arg = token.symbol;
+    ASSERT_NE(0, arg);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(arg, token.symbol);
+
+    //tokens of UTF-8 code share the ids, other tokens are not interned
+    const char code[] = "a+++$0 1";
+    tokenizer.setUtf8View(code, sizeof(code) - 1);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(a, token.symbol);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"+++", token.token);
+    ASSERT_EQ(pool->find(L"+++"), token.symbol);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(L"$0", token.token);
+    ASSERT_EQ(arg, token.symbol);
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_EQ(TokenType::Integer, token.type);
+    ASSERT_EQ(0, token.symbol);
+}
+
+TEST(TestTokenizer, testStream)
+{
+    const char code[] = "let caf\xC3\xA9 = \"a\\(b + (c * d))e\" // x\n"
+            "/* long /* nested */ comment */ a++.b 1.5e3 a ..< b\n"
+            "\xCF\x80 \xE2\x89\xA0 c ? d : e\n";
+    size_t size = sizeof(code) - 1;
+    std::vector<Token> expected;
+    Tokenizer tokenizer(NULL);
+    tokenizer.setUtf8View(code, size);
+    Token token;
+    while(tokenizer.next(token))
+        expected.push_back(token);
+    //feed the code in chunks of different sizes, tokens should not be affected by chunk boundaries
+    for(size_t chunk = 1; chunk <= size; chunk++)
+    {
+        StreamTokenizer stream;
+        size_t i = 0;
+        for(size_t p = 0; p < size || !stream.isFinished(); p += chunk)
+        {
+            if(p < size)
+                stream.feed(code + p, std::min(chunk, size - p));
+            else
+                stream.finish();
+            while(stream.next(token))
+            {
+                ASSERT_LT(i, expected.size());
+                ASSERT_EQ(expected[i].type, token.type);
+                ASSERT_EQ(expected[i].token, token.token);
+                ASSERT_EQ(expected[i].state.offset, token.state.offset);
+                if(token.type == TokenType::Operator)
+                {
+                    ASSERT_EQ(expected[i].operators.type, token.operators.type);
+                }
+                i++;
+            }
+        }
+        ASSERT_EQ(expected.size(), i);
+    }
+
+    //tokenized code is dropped while reading long input, positions are still counted from the beginning
+    std::string longCode;
+    for(int n = 0; n < 100; n++)
+        longCode.append(code, size);
+    tokenizer.setUtf8View(longCode.c_str(), longCode.size());
+    expected.clear();
+    while(tokenizer.next(token))
+        expected.push_back(token);
+    StreamTokenizer stream;
+    size_t i = 0;
+    for(size_t p = 0; p < longCode.size(); p += 100)
+    {
+        stream.feed(longCode.c_str() + p, std::min((size_t)100, longCode.size() - p));
+        while(stream.next(token))
+        {
+            ASSERT_EQ(expected[i].token, token.token);
+            ASSERT_EQ(expected[i].state.offset, token.state.offset);
+            int line1, column1, line2, column2;
+            tokenizer.getPosition(token.state.offset, line1, column1);
+            stream.getPosition(token.state.offset, line2, column2);
+            ASSERT_EQ(line1, line2);
+            ASSERT_EQ(column1, column2);
+            i++;
+        }
+    }
+    stream.finish();
+    while(stream.next(token))
+        i++;
+    ASSERT_EQ(expected.size(), i);
+}
+
+TEST(TestTokenizer, testStreamPending)
+{
+    StreamTokenizer stream;
+    Token token;
+    stream.feed(L"var a = {\n");
+    ASSERT_TRUE(stream.next(token));
+    ASSERT_EQ(L"var", token.token);
+    ASSERT_TRUE(stream.next(token));
+    ASSERT_TRUE(stream.next(token));
+    ASSERT_TRUE(stream.next(token));
+    ASSERT_EQ(TokenType::OpenBrace, token.type);
+    ASSERT_FALSE(stream.next(token));
+    ASSERT_FALSE(stream.hasPendingToken());
+    //unterminated comment waits for more input
+    stream.feed(L"/* a\n");
+    ASSERT_FALSE(stream.next(token));
+    ASSERT_TRUE(stream.hasPendingToken());
+    stream.feed(L"*/ }\n");
+    ASSERT_TRUE(stream.next(token));
+    ASSERT_EQ(TokenType::Comment, token.type);
+    ASSERT_TRUE(stream.next(token));
+    ASSERT_EQ(TokenType::CloseBrace, token.type);
+    int line, column;
+    stream.getPosition(token.state.offset, line, column);
+    ASSERT_EQ(3, line);
+    ASSERT_EQ(4, column);
+    //unterminated string waits for more input
+    stream.feed(L"\"abc");
+    ASSERT_FALSE(stream.next(token));
+    stream.feed(L"\\");
+    ASSERT_FALSE(stream.next(token));
+    //errors are reported when the input is finished
+    stream.finish();
+    ASSERT_THROW(stream.next(token), TokenizerError);
+}
+
 TEST(TestTokenizer, testString)
 {
     Tokenizer tokenizer(L"");
@@ -130,8 +130,11 @@ Swallow::ScopedProgramPtr analyzeStatement(Swallow::SymbolRegistry& registry, Sw
 
 
     ScopedNodeFactory nodeFactory;
+    nodeFactory.setStringPool(registry.getStringPool());
     Parser parser(&nodeFactory, &compilerResults);
     parser.setSourceFile(SourceFilePtr(new SourceFile(L"<code>", str)));
+    //build sorted expressions like SwallowCompiler does
+    parser.setSymbolRegistry(&registry);
     ScopedProgramPtr ret = std::dynamic_pointer_cast<ScopedProgram>(parser.parse(str));
     ModulePtr module(new Module(L"test", registry.getGlobalScope()->getModuleType()));
     if(!ret)
@@ -162,8 +165,7 @@ Tracer::Tracer(const char* file, int line, const char* func)
     this->line = line;
 #ifdef TRACE_NODE
     using namespace Swallow;
-    Node::UnreleasedNodes.clear();
-    Node::NodeCount = 0;
+    Node::resetTrace();
 #endif
 }
 Tracer::~Tracer()
@@ -171,16 +173,14 @@ Tracer::~Tracer()
 #ifdef TRACE_NODE
     using namespace Swallow;
     using namespace std;
-    list<Node*>& nodes = Node::UnreleasedNodes;
+    vector<Node*> nodes = Node::getUnreleasedNodes();
     int unreleasedNodes = nodes.size();
-    if(Node::NodeCount != 0)
+    if(unreleasedNodes != 0)
     {
         stringstream ss;
-        list<Node*>::iterator iter = nodes.begin();
         ss<<unreleasedNodes<<" unreleased AST nodes detected in [" << file << ":" << func << "]:";
-        for(; iter != nodes.end(); iter++)
+        for(Node* node : nodes)
         {
-            Node* node = *iter;
             const char* nodeName = Node::nodeTypeToName(node->getNodeType());
             NodeSerializerA serializer(ss);
             ss << nodeName << " : " << static_cast<const void*>(node) << "(";
@@ -109,10 +109,14 @@ struct Tracer
 
 
 #define SEMANTIC_ANALYZE_F(fileName) SEMANTIC_ANALYZE(readFile(fileName).c_str());
-#define ASSERT_NO_ERRORS() if(0 != compilerResults.numResults()) { \
-        dumpCompilerResults(compilerResults); \
+/*!
+ * Check given compiler results, for tests that drive SwallowCompiler without SEMANTIC_ANALYZE
+ */
+#define ASSERT_NO_COMPILER_ERRORS(results) if(0 != (results).numResults()) { \
+        dumpCompilerResults(results); \
         GTEST_FATAL_FAILURE_("Unexpected compilation errors."); \
     }
+#define ASSERT_NO_ERRORS() ASSERT_NO_COMPILER_ERRORS(compilerResults)
 
 #define ASSERT_ERROR(e) error = getCompilerResultByError(compilerResults, e); \
     if(!error) { \
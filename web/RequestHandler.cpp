@@ -87,6 +87,7 @@ static ScopedProgramPtr compile(const wstring& code, CompilerResults* compilerRe
 {
     ScopedNodeFactory nodeFactory;
     SymbolRegistry registry;
+    nodeFactory.setStringPool(registry.getStringPool());
     Parser parser(&nodeFactory, compilerResults);
     parser.setFileName(L"<file>");
     ScopedProgramPtr ret = std::dynamic_pointer_cast<ScopedProgram>(parser.parse(code.c_str()));